@@ -0,0 +1,101 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/benchmark/cc/allocation_tracking.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+
+#ifdef ANY_SKETCH_TRACK_ALLOCATIONS
+
+namespace {
+// Trivially constructible, so it is usable from operator new at any time.
+thread_local int64_t thread_allocation_count = 0;
+}  // namespace
+
+// The array and nothrow forms of operator new, and every form of operator
+// delete, forward to these by default.
+void* operator new(size_t size) {
+  ++thread_allocation_count;
+  if (size == 0) size = 1;
+  while (true) {
+    if (void* pointer = std::malloc(size)) return pointer;
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) throw std::bad_alloc();
+    handler();
+  }
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+
+#endif  // ANY_SKETCH_TRACK_ALLOCATIONS
+
+namespace wfa {
+namespace {
+std::atomic<int> allocation_budget_violation_count = 0;
+}  // namespace
+
+bool AllocationTrackingEnabled() {
+#ifdef ANY_SKETCH_TRACK_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+int64_t ThreadAllocationCount() {
+#ifdef ANY_SKETCH_TRACK_ALLOCATIONS
+  return thread_allocation_count;
+#else
+  return 0;
+#endif
+}
+
+void ReportAllocationsPerItem(benchmark::State& state,
+                              absl::string_view item_name, int64_t allocations,
+                              int64_t items) {
+  if (!AllocationTrackingEnabled() || items == 0) return;
+  state.counters[absl::StrCat("allocs_per_", item_name)] =
+      static_cast<double>(allocations) / items;
+}
+
+void CheckAllocationsPerItem(benchmark::State& state,
+                             absl::string_view item_name, int64_t allocations,
+                             int64_t items, double max_allocations_per_item) {
+  if (!AllocationTrackingEnabled() || items == 0) return;
+  ReportAllocationsPerItem(state, item_name, allocations, items);
+  double allocations_per_item = static_cast<double>(allocations) / items;
+  if (allocations_per_item > max_allocations_per_item) {
+    ++allocation_budget_violation_count;
+    state.SkipWithError(absl::StrFormat(
+        "%g allocations per %s exceed the budget of %g",
+        allocations_per_item, item_name, max_allocations_per_item)
+                            .c_str());
+  }
+}
+
+int AllocationBudgetViolationCount() {
+  return allocation_budget_violation_count;
+}
+
+}  // namespace wfa
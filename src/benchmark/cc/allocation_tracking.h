@@ -0,0 +1,73 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BENCHMARK_CC_ALLOCATION_TRACKING_H_
+#define SRC_BENCHMARK_CC_ALLOCATION_TRACKING_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+
+// Counting of heap allocations for benchmarks.
+//
+// Building with --config=track_allocations replaces the global operator new
+// with one that counts the allocations of each thread. Allocations made
+// directly with malloc, such as OpenSSL's, are not counted, and neither are
+// those of the aligned (std::align_val_t) forms of operator new, which are not
+// replaced. Without the config nothing is replaced and the functions below
+// report tracking as disabled.
+//
+// Benchmarks that check allocation budgets link :allocation_tracking_main
+// instead of benchmark_main, so that exceeding a budget fails the binary.
+namespace wfa {
+
+// Returns whether allocations are counted.
+bool AllocationTrackingEnabled();
+
+// Returns the number of operator new calls made by this thread so far, or 0
+// if tracking is disabled.
+int64_t ThreadAllocationCount();
+
+// Counts the allocations made by this thread during its lifetime.
+class ScopedAllocationCounter {
+ public:
+  ScopedAllocationCounter() : start_(ThreadAllocationCount()) {}
+
+  int64_t count() const { return ThreadAllocationCount() - start_; }
+
+ private:
+  int64_t start_;
+};
+
+// Reports `allocations` over `items` items as the "allocs_per_<item_name>"
+// counter of `state`, without checking it against a budget. Does nothing if
+// tracking is disabled.
+void ReportAllocationsPerItem(benchmark::State& state,
+                              absl::string_view item_name, int64_t allocations,
+                              int64_t items);
+
+// Reports allocations like ReportAllocationsPerItem. If they exceed
+// `max_allocations_per_item` per item, fails the benchmark and records the
+// violation. Does nothing if tracking is disabled.
+void CheckAllocationsPerItem(benchmark::State& state,
+                             absl::string_view item_name, int64_t allocations,
+                             int64_t items, double max_allocations_per_item);
+
+// Returns the number of allocation budgets exceeded so far in this process.
+int AllocationBudgetViolationCount();
+
+}  // namespace wfa
+
+#endif  // SRC_BENCHMARK_CC_ALLOCATION_TRACKING_H_
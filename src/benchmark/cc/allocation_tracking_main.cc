@@ -0,0 +1,37 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The main function of benchmarks with allocation budgets. It runs the
+// benchmarks like benchmark_main, but exits with a failure if any of them
+// exceeded its budget, so that allocation regressions fail the perf suite.
+
+#include <iostream>
+
+#include "benchmark/benchmark.h"
+#include "src/benchmark/cc/allocation_tracking.h"
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  const int violation_count = wfa::AllocationBudgetViolationCount();
+  if (violation_count > 0) {
+    std::cerr << violation_count
+              << " benchmark(s) exceeded their allocation budget.\n";
+    return 1;
+  }
+  return 0;
+}
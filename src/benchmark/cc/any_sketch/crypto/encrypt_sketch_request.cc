@@ -0,0 +1,118 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/benchmark/cc/any_sketch/crypto/encrypt_sketch_request.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "common_cpp/macros/macros.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "private_join_and_compute/crypto/commutative_elgamal.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch::crypto {
+
+using ::google::protobuf::io::CodedOutputStream;
+using ::google::protobuf::io::StringOutputStream;
+using ::google::protobuf::internal::WireFormatLite;
+using ::private_join_and_compute::CommutativeElGamal;
+
+std::string SerializedLiquidLegionsConfig(
+    const LiquidLegionsParameters& parameters) {
+  SketchConfig config;
+  SketchConfig::IndexSpec* index = config.add_indexes();
+  index->set_name("Index");
+  index->mutable_distribution()->mutable_exponential()->set_rate(
+      parameters.decay_rate);
+  index->mutable_distribution()->mutable_exponential()->set_num_values(
+      parameters.size);
+
+  SketchConfig::ValueSpec* sampling_indicator = config.add_values();
+  sampling_indicator->set_name("SamplingIndicator");
+  sampling_indicator->set_aggregator(SketchConfig::ValueSpec::UNIQUE);
+  sampling_indicator->mutable_distribution()->mutable_uniform()->set_num_values(
+      parameters.sampling_indicator_size);
+
+  SketchConfig::ValueSpec* frequency = config.add_values();
+  frequency->set_name("Frequency");
+  frequency->set_aggregator(SketchConfig::ValueSpec::SUM);
+  frequency->mutable_distribution()->mutable_oracle()->set_key(
+      parameters.frequency_key);
+  return config.SerializeAsString();
+}
+
+absl::StatusOr<std::string> SerializedEncryptSketchRequestWithoutSketch(
+    const EncryptionParameters& parameters) {
+  ASSIGN_OR_RETURN(std::unique_ptr<CommutativeElGamal> cipher,
+                   CommutativeElGamal::CreateWithNewKeyPair(
+                       parameters.curve_id));
+  ASSIGN_OR_RETURN(auto public_key, cipher->GetPublicKeyBytes());
+
+  EncryptSketchRequest request;
+  request.mutable_el_gamal_keys()->set_generator(public_key.first);
+  request.mutable_el_gamal_keys()->set_element(public_key.second);
+  request.set_curve_id(parameters.curve_id);
+  request.set_maximum_value(parameters.maximum_value);
+  request.set_destroyed_register_strategy(
+      EncryptSketchRequest::CONFLICTING_KEYS);
+  if (parameters.publisher_count > 0) {
+    EncryptSketchRequest::PublisherNoiseParameter* noise =
+        request.mutable_noise_parameter();
+    noise->set_epsilon(parameters.epsilon);
+    noise->set_delta(parameters.delta);
+    noise->set_publisher_count(parameters.publisher_count);
+  }
+  return request.SerializeAsString();
+}
+
+std::string SerializedEncryptSketchRequest(
+    absl::string_view serialized_sketch,
+    absl::string_view serialized_request_without_sketch) {
+  // Parsing concatenated messages merges them, so the request is its sketch
+  // field followed by its other fields. This avoids parsing the sketch.
+  std::string result;
+  {
+    StringOutputStream stream(&result);
+    CodedOutputStream output(&stream);
+    output.WriteTag(WireFormatLite::MakeTag(
+        EncryptSketchRequest::kSketchFieldNumber,
+        WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+    output.WriteVarint64(serialized_sketch.size());
+    output.WriteRaw(serialized_sketch.data(), serialized_sketch.size());
+    output.WriteRaw(serialized_request_without_sketch.data(),
+                    serialized_request_without_sketch.size());
+  }
+  return result;
+}
+
+absl::StatusOr<int64_t> EncryptedSketchSize(
+    absl::string_view serialized_response) {
+  EncryptSketchResponse response;
+  if (!response.ParseFromArray(serialized_response.data(),
+                               serialized_response.size())) {
+    return absl::InvalidArgumentError(
+        "failed to parse the EncryptSketchResponse proto.");
+  }
+  return response.encrypted_sketch().size();
+}
+
+}  // namespace wfa::any_sketch::crypto
@@ -0,0 +1,71 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BENCHMARK_CC_ANY_SKETCH_CRYPTO_ENCRYPT_SKETCH_REQUEST_H_
+#define SRC_BENCHMARK_CC_ANY_SKETCH_CRYPTO_ENCRYPT_SKETCH_REQUEST_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+// Proto helpers of the publisher pipeline benchmark. They live in their own
+// translation unit because sketch.pb.h cannot be included together with
+// any_sketch.h, see any_sketch/sketch_proto_conversion.h.
+namespace wfa::any_sketch::crypto {
+
+// Shape of a Liquid Legions sketch.
+struct LiquidLegionsParameters {
+  double decay_rate;
+  int64_t size;
+  int64_t sampling_indicator_size;
+  int64_t max_frequency;
+  // Metadata key of the frequency of an event.
+  std::string frequency_key;
+};
+
+// Parameters of an EncryptSketchRequest other than its sketch.
+struct EncryptionParameters {
+  int curve_id;
+  int maximum_value;
+  // Publisher noise is added iff publisher_count is positive.
+  double epsilon;
+  double delta;
+  int publisher_count;
+};
+
+// Returns the serialized SketchConfig of a Liquid Legions sketch.
+std::string SerializedLiquidLegionsConfig(
+    const LiquidLegionsParameters& parameters);
+
+// Returns a serialized EncryptSketchRequest with everything but the sketch,
+// using a new random ElGamal key pair.
+absl::StatusOr<std::string> SerializedEncryptSketchRequestWithoutSketch(
+    const EncryptionParameters& parameters);
+
+// Returns a serialized EncryptSketchRequest holding `serialized_sketch` and the
+// fields of `serialized_request_without_sketch`.
+std::string SerializedEncryptSketchRequest(
+    absl::string_view serialized_sketch,
+    absl::string_view serialized_request_without_sketch);
+
+// Returns the size of the encrypted sketch in a serialized
+// EncryptSketchResponse.
+absl::StatusOr<int64_t> EncryptedSketchSize(
+    absl::string_view serialized_response);
+
+}  // namespace wfa::any_sketch::crypto
+
+#endif  // SRC_BENCHMARK_CC_ANY_SKETCH_CRYPTO_ENCRYPT_SKETCH_REQUEST_H_
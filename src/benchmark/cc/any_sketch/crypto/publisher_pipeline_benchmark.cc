@@ -0,0 +1,261 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// End-to-end benchmark of the publisher path, from raw events to encrypted
+// bytes:
+//   1. generate: N synthetic events, each an ID and a frequency.
+//   2. insert: insert the events into a Liquid Legions AnySketch.
+//   3. serialize_sketch: convert the sketch to a serialized Sketch proto.
+//   4. build_request: wrap it into a serialized EncryptSketchRequest.
+//   5. encrypt: run sketch_encrypter_adapter::EncryptSketch, which also adds
+//      the publisher noise registers.
+//
+// For each repetition it prints the wall time, throughput and peak resident
+// set size after each stage, followed by the end-to-end numbers. The same
+// flags always produce the same events.
+//
+// Example:
+//   bazel run -c opt
+//       //src/benchmark/cc/any_sketch/crypto:publisher_pipeline_benchmark --
+//       --events=10000000 --audience=2000000
+
+#include <sys/resource.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/crypto/sketch_encrypter_adapter.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/sketch_proto_conversion.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/fingerprinters/fingerprinters.h"
+#include "common_cpp/macros/macros.h"
+#include "openssl/obj_mac.h"
+#include "src/benchmark/cc/any_sketch/crypto/encrypt_sketch_request.h"
+
+ABSL_FLAG(int64_t, events, 1'000'000, "Number of synthetic events.");
+ABSL_FLAG(int64_t, audience, 250'000,
+          "Number of distinct event IDs the events are drawn from.");
+ABSL_FLAG(uint64_t, seed, 1, "Seed of the synthetic events.");
+ABSL_FLAG(int, repetitions, 1, "Number of times to run the pipeline.");
+
+ABSL_FLAG(int64_t, sketch_size, 100'000,
+          "Number of registers of the Liquid Legions sketch.");
+ABSL_FLAG(double, decay_rate, 12, "Decay rate of the Liquid Legions sketch.");
+ABSL_FLAG(int64_t, max_frequency, 10, "Maximum frequency of an event.");
+
+ABSL_FLAG(int, curve_id, NID_X9_62_prime256v1, "The Elliptic curve id.");
+ABSL_FLAG(int, maximum_value, 10, "Maximum frequency value to encrypt.");
+ABSL_FLAG(int, publisher_count, 3,
+          "Number of publishers for the noise. No noise is added if 0.");
+ABSL_FLAG(double, epsilon, 1, "Epsilon of the publisher noise.");
+ABSL_FLAG(double, delta, 0.1, "Delta of the publisher noise.");
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+constexpr char kFrequencyKey[] = "frequency";
+constexpr int64_t kSamplingIndicatorSize = 10'000'000;
+
+struct Events {
+  std::vector<uint64_t> ids;
+  std::vector<int64_t> frequencies;
+};
+
+Events GenerateEvents(int64_t count, int64_t audience, int64_t max_frequency,
+                      uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<uint64_t> id_distribution(0, audience - 1);
+  std::uniform_int_distribution<int64_t> frequency_distribution(1,
+                                                                max_frequency);
+  Events events;
+  events.ids.reserve(count);
+  events.frequencies.reserve(count);
+  for (int64_t i = 0; i < count; ++i) {
+    events.ids.push_back(id_distribution(rng));
+    events.frequencies.push_back(frequency_distribution(rng));
+  }
+  return events;
+}
+
+std::unique_ptr<AnySketch> MakeLiquidLegionsSketch(
+    const LiquidLegionsParameters& parameters) {
+  const Fingerprinter* fingerprinter = &GetFarmFingerprinter();
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetExponentialDistribution(
+      fingerprinter, parameters.decay_rate, parameters.size));
+  std::vector<ValueFunction> values;
+  values.push_back(
+      {.name = "SamplingIndicator",
+       .aggregator_type = AggregatorType::kUnique,
+       .distribution = GetUniformDistribution(
+           fingerprinter, 0, parameters.sampling_indicator_size - 1)});
+  values.push_back({.name = "Frequency",
+                    .aggregator_type = AggregatorType::kSum,
+                    .distribution = GetOracleDistribution(
+                        parameters.frequency_key, 1,
+                        parameters.max_frequency)});
+  return std::make_unique<AnySketch>(std::move(indexes), std::move(values));
+}
+
+// Returns the peak resident set size of this process in bytes.
+int64_t PeakRssBytes() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+  // ru_maxrss is in kilobytes on Linux.
+  return int64_t{usage.ru_maxrss} * 1024;
+}
+
+// Times the stages of one pipeline run and prints them as they finish.
+class StageReporter {
+ public:
+  explicit StageReporter(int64_t events) : events_(events) {
+    std::cout << absl::StrFormat("%-18s %12s %8s %16s %14s\n", "stage",
+                                 "seconds", "share", "events/sec",
+                                 "peak_rss_mib");
+  }
+
+  // Records the end of the stage started by the previous call.
+  void EndStage(absl::string_view name) {
+    absl::Time now = absl::Now();
+    stages_.push_back({std::string(name), now - stage_start_, PeakRssBytes()});
+    stage_start_ = now;
+  }
+
+  // Prints the recorded stages and the end-to-end numbers.
+  void Print() const {
+    absl::Duration total = stage_start_ - start_;
+    for (const Stage& stage : stages_) {
+      PrintRow(stage.name, stage.duration, total, stage.peak_rss_bytes);
+    }
+    PrintRow("total", total, total, PeakRssBytes());
+  }
+
+ private:
+  struct Stage {
+    std::string name;
+    absl::Duration duration;
+    int64_t peak_rss_bytes;
+  };
+
+  void PrintRow(absl::string_view name, absl::Duration duration,
+                absl::Duration total, int64_t peak_rss_bytes) const {
+    double seconds = absl::ToDoubleSeconds(duration);
+    std::cout << absl::StrFormat(
+        "%-18s %12.4f %7.1f%% %16.0f %14.1f\n", name, seconds,
+        100 * seconds / absl::ToDoubleSeconds(total), events_ / seconds,
+        peak_rss_bytes / (1024.0 * 1024.0));
+  }
+
+  int64_t events_;
+  absl::Time start_ = absl::Now();
+  absl::Time stage_start_ = start_;
+  std::vector<Stage> stages_;
+};
+
+absl::Status RunPipeline(const LiquidLegionsParameters& sketch_parameters,
+                         const std::string& serialized_request_without_sketch) {
+  const int64_t event_count = absl::GetFlag(FLAGS_events);
+  StageReporter reporter(event_count);
+
+  Events events = GenerateEvents(event_count, absl::GetFlag(FLAGS_audience),
+                                 sketch_parameters.max_frequency,
+                                 absl::GetFlag(FLAGS_seed));
+  reporter.EndStage("generate");
+
+  std::unique_ptr<AnySketch> sketch =
+      MakeLiquidLegionsSketch(sketch_parameters);
+  ItemMetadata item_metadata = {{sketch_parameters.frequency_key, 0}};
+  int64_t& frequency = item_metadata[sketch_parameters.frequency_key];
+  for (int64_t i = 0; i < event_count; ++i) {
+    frequency = events.frequencies[i];
+    RETURN_IF_ERROR(sketch->Insert(events.ids[i], item_metadata));
+  }
+  reporter.EndStage("insert");
+
+  ASSIGN_OR_RETURN(
+      std::string serialized_sketch,
+      SerializeSketchProto(*sketch,
+                           SerializedLiquidLegionsConfig(sketch_parameters)));
+  reporter.EndStage("serialize_sketch");
+
+  std::string serialized_request = SerializedEncryptSketchRequest(
+      serialized_sketch, serialized_request_without_sketch);
+  reporter.EndStage("build_request");
+
+  ASSIGN_OR_RETURN(std::string serialized_response,
+                   EncryptSketch(serialized_request));
+  reporter.EndStage("encrypt");
+
+  ASSIGN_OR_RETURN(int64_t encrypted_bytes,
+                   EncryptedSketchSize(serialized_response));
+  reporter.Print();
+  std::cout << absl::StrFormat(
+      "registers: %d  sketch_bytes: %d  encrypted_bytes: %d\n\n",
+      sketch->register_count(), serialized_sketch.size(),
+      encrypted_bytes);
+  return absl::OkStatus();
+}
+
+absl::Status Run() {
+  LiquidLegionsParameters sketch_parameters = {
+      .decay_rate = absl::GetFlag(FLAGS_decay_rate),
+      .size = absl::GetFlag(FLAGS_sketch_size),
+      .sampling_indicator_size = kSamplingIndicatorSize,
+      .max_frequency = absl::GetFlag(FLAGS_max_frequency),
+      .frequency_key = kFrequencyKey,
+  };
+  ASSIGN_OR_RETURN(std::string serialized_request_without_sketch,
+                   SerializedEncryptSketchRequestWithoutSketch({
+                       .curve_id = absl::GetFlag(FLAGS_curve_id),
+                       .maximum_value = absl::GetFlag(FLAGS_maximum_value),
+                       .epsilon = absl::GetFlag(FLAGS_epsilon),
+                       .delta = absl::GetFlag(FLAGS_delta),
+                       .publisher_count = absl::GetFlag(FLAGS_publisher_count),
+                   }));
+
+  for (int i = 0; i < absl::GetFlag(FLAGS_repetitions); ++i) {
+    std::cout << "repetition " << i << "\n";
+    RETURN_IF_ERROR(
+        RunPipeline(sketch_parameters, serialized_request_without_sketch));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  absl::Status status = wfa::any_sketch::crypto::Run();
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+    return 1;
+  }
+  return 0;
+}
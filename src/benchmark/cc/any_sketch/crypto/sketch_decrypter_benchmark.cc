@@ -0,0 +1,179 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for SketchDecrypter, i.e. the decryption work of an MPC worker.
+//
+//   * BM_Decrypt: decrypting an encrypted Liquid Legions sketch with a number
+//     of threads, reported as ciphertexts/sec.
+//   * BM_CreateDecrypter: building the lookup tables, reported as table
+//     entries/sec.
+//
+// Example:
+//   bazel run -c opt
+//       //src/benchmark/cc/any_sketch/crypto:sketch_decrypter_benchmark
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "any_sketch/crypto/sketch_decrypter.h"
+#include "any_sketch/crypto/sketch_encrypter.h"
+#include "benchmark/benchmark.h"
+#include "openssl/obj_mac.h"
+#include "wfa/any_sketch/crypto/el_gamal_key.pb.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using DestroyedRegisterStrategy =
+    EncryptSketchRequest::DestroyedRegisterStrategy;
+
+constexpr int kCurveId = NID_X9_62_prime256v1;
+constexpr int kMaxCounterValue = 10;
+constexpr int64_t kIndexCount = 100'000;
+constexpr int64_t kMaxUniqueValue = 1'000;
+constexpr int kRegisterCount = 1'000;
+constexpr uint64_t kSketchSeed = 0x5eed;
+
+// A Liquid Legions sketch of kRegisterCount registers, one in ten of them
+// destroyed.
+Sketch MakeLiquidLegionsSketch() {
+  Sketch sketch;
+  sketch.mutable_config()->add_values()->set_aggregator(
+      SketchConfig::ValueSpec::UNIQUE);
+  sketch.mutable_config()->add_values()->set_aggregator(
+      SketchConfig::ValueSpec::SUM);
+  std::mt19937_64 rng(kSketchSeed);
+  std::uniform_int_distribution<int64_t> index_distribution(0,
+                                                            kIndexCount - 1);
+  std::uniform_int_distribution<int64_t> unique_distribution(1,
+                                                             kMaxUniqueValue);
+  std::uniform_int_distribution<int64_t> count_distribution(
+      1, 2 * kMaxCounterValue);
+  for (int i = 0; i < kRegisterCount; ++i) {
+    Sketch::Register* reg = sketch.add_registers();
+    reg->set_index(index_distribution(rng));
+    reg->add_values(i % 10 == 0 ? 0 : unique_distribution(rng));
+    reg->add_values(count_distribution(rng));
+  }
+  return sketch;
+}
+
+// Encrypts `sketch` under the public key of `key_pair`.
+absl::StatusOr<std::string> EncryptSketch(const ElGamalKeyPair& key_pair,
+                                          const Sketch& sketch,
+                                          DestroyedRegisterStrategy strategy) {
+  absl::StatusOr<std::unique_ptr<SketchEncrypter>> encrypter =
+      CreateWithPublicKey(kCurveId, kMaxCounterValue,
+                          {.u = key_pair.public_key().generator(),
+                           .e = key_pair.public_key().element()});
+  if (!encrypter.ok()) return encrypter.status();
+  return (*encrypter)->Encrypt(sketch, strategy);
+}
+
+SketchDecrypterOptions MakeOptions(int64_t index_count, int thread_count) {
+  SketchDecrypterOptions options;
+  options.curve_id = kCurveId;
+  options.max_counter_value = kMaxCounterValue;
+  options.index_count = index_count;
+  options.max_unique_value = kMaxUniqueValue;
+  options.thread_count = thread_count;
+  return options;
+}
+
+// Args: {destroyed register strategy, threads}.
+void BM_Decrypt(benchmark::State& state) {
+  const auto strategy = static_cast<DestroyedRegisterStrategy>(state.range(0));
+  const int thread_count = state.range(1);
+  absl::StatusOr<ElGamalKeyPair> key_pair = GenerateElGamalKeyPair(kCurveId);
+  if (!key_pair.ok()) {
+    state.SkipWithError(key_pair.status().ToString().c_str());
+    return;
+  }
+  const Sketch sketch = MakeLiquidLegionsSketch();
+  absl::StatusOr<std::string> encrypted =
+      EncryptSketch(*key_pair, sketch, strategy);
+  if (!encrypted.ok()) {
+    state.SkipWithError(encrypted.status().ToString().c_str());
+    return;
+  }
+  // The tables are built once per worker, so they are not timed.
+  absl::StatusOr<std::unique_ptr<SketchDecrypter>> decrypter =
+      SketchDecrypter::Create(*key_pair,
+                              MakeOptions(kIndexCount, thread_count));
+  if (!decrypter.ok()) {
+    state.SkipWithError(decrypter.status().ToString().c_str());
+    return;
+  }
+
+  for (auto _ : state) {
+    absl::StatusOr<DecryptedSketch> decrypted =
+        (*decrypter)->Decrypt(*encrypted, sketch.config());
+    if (!decrypted.ok()) {
+      state.SkipWithError(decrypted.status().ToString().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(decrypted);
+  }
+  const int64_t ciphertexts =
+      encrypted->size() / (2 * key_pair->public_key().generator().size());
+  state.counters["ciphertexts"] = benchmark::Counter(
+      static_cast<double>(ciphertexts * state.iterations()),
+      benchmark::Counter::kIsRate);
+  state.SetItemsProcessed(state.iterations() * kRegisterCount);
+  state.SetBytesProcessed(state.iterations() * encrypted->size());
+}
+
+BENCHMARK(BM_Decrypt)
+    ->ArgsProduct({{EncryptSketchRequest::CONFLICTING_KEYS,
+                    EncryptSketchRequest::FLAGGED_KEY},
+                   {1, 2, 4, 8}})
+    ->ArgNames({"strategy", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// Args: {index count, threads}.
+void BM_CreateDecrypter(benchmark::State& state) {
+  absl::StatusOr<ElGamalKeyPair> key_pair = GenerateElGamalKeyPair(kCurveId);
+  if (!key_pair.ok()) {
+    state.SkipWithError(key_pair.status().ToString().c_str());
+    return;
+  }
+  const SketchDecrypterOptions options =
+      MakeOptions(state.range(0), state.range(1));
+  size_t table_size = 0;
+  for (auto _ : state) {
+    absl::StatusOr<std::unique_ptr<SketchDecrypter>> decrypter =
+        SketchDecrypter::Create(*key_pair, options);
+    if (!decrypter.ok()) {
+      state.SkipWithError(decrypter.status().ToString().c_str());
+      return;
+    }
+    table_size = (*decrypter)->lookup_table_size();
+  }
+  state.SetItemsProcessed(state.iterations() * table_size);
+}
+
+BENCHMARK(BM_CreateDecrypter)
+    ->ArgsProduct({{10'000}, {1, 8}})
+    ->ArgNames({"indexes", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
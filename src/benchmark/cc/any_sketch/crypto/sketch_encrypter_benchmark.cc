@@ -0,0 +1,654 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for SketchEncrypter.
+//
+// BM_Encrypt and BM_AppendNoiseRegisters measure the end-to-end cost of the
+// SketchEncrypter API on synthetic sketches and report ciphertexts/sec, and
+// BM_EncryptDeduplicated that of encrypting repeated values with and without
+// deduplicated encryption. The remaining benchmarks measure the individual
+// stages that make up the cost of a single ciphertext, so that the end-to-end
+// numbers can be broken down:
+//   * BM_HashToCurve: mapping a plaintext to an ECPoint.
+//   * BM_HashToCurveBatch: the same with each HashToCurveMethod on P-256, in
+//     batches of a number of plaintexts.
+//   * BM_PointCompression: converting an ECPoint to its compressed bytes.
+//   * BM_ElGamalEncrypt: encrypting a compressed ECPoint.
+//   * BM_AppendCiphertext and BM_SerializeResponse: producing the output bytes.
+//   * BM_FrameCiphertexts and BM_UnframeCiphertexts: converting the output to
+//     and from the FRAMED_V1 format.
+// BM_CombineElGamalPublicKeySets measures combining many sets of public keys.
+//
+// Example:
+//   bazel run -c opt
+//       //src/benchmark/cc/any_sketch/crypto:sketch_encrypter_benchmark --
+//       --benchmark_filter=BM_Encrypt/curve:0
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "any_sketch/crypto/ciphertext_framing.h"
+#include "any_sketch/crypto/hash_to_curve.h"
+#include "any_sketch/crypto/sketch_encrypter.h"
+#include "benchmark/benchmark.h"
+#include "openssl/obj_mac.h"
+#include "private_join_and_compute/crypto/commutative_elgamal.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "src/benchmark/cc/allocation_tracking.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using ::private_join_and_compute::CommutativeElGamal;
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+using DestroyedRegisterStrategy =
+    EncryptSketchRequest::DestroyedRegisterStrategy;
+
+constexpr int kCurveIds[] = {NID_X9_62_prime256v1, NID_secp384r1,
+                             NID_secp521r1};
+constexpr int kCurveCount = sizeof(kCurveIds) / sizeof(kCurveIds[0]);
+constexpr int kMaxCounterValue = 10;
+constexpr int64_t kMaxIndex = 10'000'000;
+constexpr int64_t kMaxUniqueValue = (int64_t{1} << 32) - 1;
+constexpr uint64_t kSyntheticSketchSeed = 0x5eed;
+
+// Shape of a synthetic sketch.
+struct SyntheticSketchOptions {
+  int register_count;
+  int unique_value_count;
+  int sum_value_count;
+  // Percentage of registers whose UNIQUE values are destroyed. Ignored if
+  // there are no UNIQUE values.
+  int destroyed_percentage;
+};
+
+struct SyntheticSketch {
+  Sketch sketch;
+  int destroyed_register_count = 0;
+};
+
+// Generates a sketch with random registers. The same options always produce
+// the same sketch.
+SyntheticSketch MakeSyntheticSketch(const SyntheticSketchOptions& options) {
+  SyntheticSketch result;
+  SketchConfig& config = *result.sketch.mutable_config();
+  config.add_indexes()->set_name("Index");
+  for (int i = 0; i < options.unique_value_count; ++i) {
+    config.add_values()->set_aggregator(SketchConfig::ValueSpec::UNIQUE);
+  }
+  for (int i = 0; i < options.sum_value_count; ++i) {
+    config.add_values()->set_aggregator(SketchConfig::ValueSpec::SUM);
+  }
+
+  std::mt19937_64 rng(kSyntheticSketchSeed);
+  std::uniform_int_distribution<int64_t> index_distribution(0, kMaxIndex - 1);
+  std::uniform_int_distribution<int64_t> unique_distribution(1,
+                                                             kMaxUniqueValue);
+  // Some, but not too many, counts exceed the max counter value.
+  std::uniform_int_distribution<int64_t> count_distribution(
+      1, 2 * kMaxCounterValue);
+  std::uniform_int_distribution<int> percentage_distribution(0, 99);
+
+  for (int i = 0; i < options.register_count; ++i) {
+    Sketch::Register* reg = result.sketch.add_registers();
+    reg->set_index(index_distribution(rng));
+    bool destroyed = options.unique_value_count > 0 &&
+                     percentage_distribution(rng) <
+                         options.destroyed_percentage;
+    for (int j = 0; j < options.unique_value_count; ++j) {
+      // Destroyed UNIQUE values are stored as 0 in the proto.
+      reg->add_values(destroyed ? 0 : unique_distribution(rng));
+    }
+    for (int j = 0; j < options.sum_value_count; ++j) {
+      reg->add_values(count_distribution(rng));
+    }
+    if (destroyed) ++result.destroyed_register_count;
+  }
+  return result;
+}
+
+// Returns the number of ciphertexts that encrypting the sketch produces.
+int64_t CountCiphertexts(const SyntheticSketch& synthetic_sketch,
+                         DestroyedRegisterStrategy strategy) {
+  const int64_t ciphertexts_per_register =
+      1 + synthetic_sketch.sketch.config().values_size();
+  int64_t register_count = synthetic_sketch.sketch.registers_size();
+  if (strategy == EncryptSketchRequest::CONFLICTING_KEYS) {
+    // Each destroyed register is encrypted as two registers.
+    register_count += synthetic_sketch.destroyed_register_count;
+  }
+  return register_count * ciphertexts_per_register;
+}
+
+absl::StatusOr<CiphertextString> GeneratePublicKey(int curve_id) {
+  absl::StatusOr<std::unique_ptr<CommutativeElGamal>> cipher =
+      CommutativeElGamal::CreateWithNewKeyPair(curve_id);
+  if (!cipher.ok()) return cipher.status();
+  absl::StatusOr<std::pair<std::string, std::string>> public_key =
+      (*cipher)->GetPublicKeyBytes();
+  if (!public_key.ok()) return public_key.status();
+  return CiphertextString{.u = std::move(public_key->first),
+                          .e = std::move(public_key->second)};
+}
+
+// Creates a SketchEncrypter with a fresh key, or reports the error to the
+// benchmark and returns nullptr.
+std::unique_ptr<SketchEncrypter> CreateEncrypterOrSkip(
+    benchmark::State& state, int curve_id) {
+  absl::StatusOr<CiphertextString> public_key = GeneratePublicKey(curve_id);
+  if (!public_key.ok()) {
+    state.SkipWithError(public_key.status().ToString().c_str());
+    return nullptr;
+  }
+  absl::StatusOr<std::unique_ptr<SketchEncrypter>> encrypter =
+      CreateWithPublicKey(curve_id, kMaxCounterValue, *public_key);
+  if (!encrypter.ok()) {
+    state.SkipWithError(encrypter.status().ToString().c_str());
+    return nullptr;
+  }
+  return *std::move(encrypter);
+}
+
+void SetCiphertextRate(benchmark::State& state,
+                       int64_t ciphertexts_per_iteration) {
+  state.counters["ciphertexts"] = benchmark::Counter(
+      static_cast<double>(ciphertexts_per_iteration * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+
+// Args: {curve, destroyed register strategy, register count, UNIQUE value
+// count, SUM value count, destroyed percentage, warm cache}.
+//
+// With a warm cache the same SketchEncrypter encrypts the sketch in every
+// iteration, so `integer_to_ec_point_map_` already holds every count. With a
+// cold cache a new SketchEncrypter is created (untimed) for every iteration.
+void BM_Encrypt(benchmark::State& state) {
+  const int curve_id = kCurveIds[state.range(0)];
+  const auto strategy = static_cast<DestroyedRegisterStrategy>(state.range(1));
+  const SyntheticSketch synthetic_sketch = MakeSyntheticSketch({
+      .register_count = static_cast<int>(state.range(2)),
+      .unique_value_count = static_cast<int>(state.range(3)),
+      .sum_value_count = static_cast<int>(state.range(4)),
+      .destroyed_percentage = static_cast<int>(state.range(5)),
+  });
+  const bool warm_cache = state.range(6) != 0;
+
+  std::unique_ptr<SketchEncrypter> encrypter =
+      CreateEncrypterOrSkip(state, curve_id);
+  if (encrypter == nullptr) return;
+  if (warm_cache &&
+      !encrypter->Encrypt(synthetic_sketch.sketch, strategy).ok()) {
+    state.SkipWithError("Failed to warm up the SketchEncrypter.");
+    return;
+  }
+
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    if (!warm_cache) {
+      state.PauseTiming();
+      encrypter = CreateEncrypterOrSkip(state, curve_id);
+      state.ResumeTiming();
+      if (encrypter == nullptr) return;
+    }
+    absl::StatusOr<std::string> encrypted =
+        encrypter->Encrypt(synthetic_sketch.sketch, strategy);
+    if (!encrypted.ok()) {
+      state.SkipWithError(encrypted.status().ToString().c_str());
+      return;
+    }
+    bytes += encrypted->size();
+  }
+  SetCiphertextRate(state, CountCiphertexts(synthetic_sketch, strategy));
+  state.SetItemsProcessed(state.iterations() *
+                          synthetic_sketch.sketch.registers_size());
+  state.SetBytesProcessed(bytes);
+}
+
+void EncryptArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t curve = 0; curve < kCurveCount; ++curve) {
+    for (int64_t strategy : {EncryptSketchRequest::CONFLICTING_KEYS,
+                             EncryptSketchRequest::FLAGGED_KEY}) {
+      for (int64_t warm_cache : {0, 1}) {
+        // Liquid Legions: one UNIQUE key and one SUM count.
+        benchmark->Args({curve, strategy, 1'000, 1, 1, 10, warm_cache});
+        // Index only.
+        benchmark->Args({curve, strategy, 1'000, 0, 0, 0, warm_cache});
+        // Mostly destroyed registers.
+        benchmark->Args({curve, strategy, 1'000, 1, 1, 50, warm_cache});
+        // Wide registers.
+        benchmark->Args({curve, strategy, 1'000, 2, 3, 10, warm_cache});
+      }
+    }
+  }
+  benchmark->ArgNames({"curve", "strategy", "registers", "unique", "sum",
+                       "destroyed_pct", "warm"});
+}
+
+BENCHMARK(BM_Encrypt)->Apply(EncryptArgs)->Unit(benchmark::kMillisecond);
+
+// Args: {destroyed register strategy}.
+//
+// Counts the allocations of encrypting a Liquid Legions sketch with a warm
+// cache. They are reported but not yet gated: budgets must first be measured
+// against private_join_and_compute under --config=track_allocations.
+void BM_EncryptAllocations(benchmark::State& state) {
+  const auto strategy = static_cast<DestroyedRegisterStrategy>(state.range(0));
+  const SyntheticSketch synthetic_sketch = MakeSyntheticSketch({
+      .register_count = 1'000,
+      .unique_value_count = 1,
+      .sum_value_count = 1,
+      .destroyed_percentage = 10,
+  });
+
+  std::unique_ptr<SketchEncrypter> encrypter =
+      CreateEncrypterOrSkip(state, kCurveIds[0]);
+  if (encrypter == nullptr) return;
+  if (!encrypter->Encrypt(synthetic_sketch.sketch, strategy).ok()) {
+    state.SkipWithError("Failed to warm up the SketchEncrypter.");
+    return;
+  }
+
+  int64_t allocations = 0;
+  for (auto _ : state) {
+    ScopedAllocationCounter counter;
+    absl::StatusOr<std::string> encrypted =
+        encrypter->Encrypt(synthetic_sketch.sketch, strategy);
+    allocations += counter.count();
+    if (!encrypted.ok()) {
+      state.SkipWithError(encrypted.status().ToString().c_str());
+      return;
+    }
+  }
+  const int64_t ciphertexts = CountCiphertexts(synthetic_sketch, strategy);
+  SetCiphertextRate(state, ciphertexts);
+  ReportAllocationsPerItem(state, "ciphertext", allocations,
+                           state.iterations() * ciphertexts);
+  ReportAllocationsPerItem(
+      state, "register", allocations,
+      state.iterations() * synthetic_sketch.sketch.registers_size());
+}
+
+BENCHMARK(BM_EncryptAllocations)
+    ->Arg(EncryptSketchRequest::CONFLICTING_KEYS)
+    ->Arg(EncryptSketchRequest::FLAGGED_KEY)
+    ->ArgName("strategy")
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {deduplicated encryption, precomputed identity encryptions}.
+//
+// Encrypts wide registers of which half are destroyed with FLAGGED_KEY, so
+// that most values are repeated. With precomputed identity encryptions, those
+// that the repeated values take are computed (untimed) before each iteration.
+void BM_EncryptDeduplicated(benchmark::State& state) {
+  const bool deduplicated = state.range(0) != 0;
+  const bool precomputed = state.range(1) != 0;
+  const SyntheticSketch synthetic_sketch = MakeSyntheticSketch({
+      .register_count = 1'000,
+      .unique_value_count = 2,
+      .sum_value_count = 3,
+      .destroyed_percentage = 50,
+  });
+  const int repeated_value_count =
+      synthetic_sketch.destroyed_register_count *
+      synthetic_sketch.sketch.config().values_size();
+
+  std::unique_ptr<SketchEncrypter> encrypter =
+      CreateEncrypterOrSkip(state, kCurveIds[0]);
+  if (encrypter == nullptr) return;
+  encrypter->EnableDeduplicatedEncryption(deduplicated);
+  if (!encrypter
+           ->Encrypt(synthetic_sketch.sketch, EncryptSketchRequest::FLAGGED_KEY)
+           .ok()) {
+    state.SkipWithError("Failed to warm up the SketchEncrypter.");
+    return;
+  }
+
+  for (auto _ : state) {
+    if (precomputed) {
+      state.PauseTiming();
+      absl::Status status =
+          encrypter->PrecomputeIdentityEncryptions(repeated_value_count);
+      state.ResumeTiming();
+      if (!status.ok()) {
+        state.SkipWithError(status.ToString().c_str());
+        return;
+      }
+    }
+    absl::StatusOr<std::string> encrypted = encrypter->Encrypt(
+        synthetic_sketch.sketch, EncryptSketchRequest::FLAGGED_KEY);
+    if (!encrypted.ok()) {
+      state.SkipWithError(encrypted.status().ToString().c_str());
+      return;
+    }
+  }
+  SetCiphertextRate(state, CountCiphertexts(synthetic_sketch,
+                                            EncryptSketchRequest::FLAGGED_KEY));
+  state.counters["repeated_values"] = repeated_value_count;
+}
+
+BENCHMARK(BM_EncryptDeduplicated)
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->ArgNames({"deduplicated", "precomputed"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {curve, value count, publisher count}.
+void BM_AppendNoiseRegisters(benchmark::State& state) {
+  const int curve_id = kCurveIds[state.range(0)];
+  const int value_count = state.range(1);
+  EncryptSketchRequest::PublisherNoiseParameter noise_parameter;
+  noise_parameter.set_epsilon(1.0);
+  noise_parameter.set_delta(1e-5);
+  noise_parameter.set_publisher_count(state.range(2));
+
+  std::unique_ptr<SketchEncrypter> encrypter =
+      CreateEncrypterOrSkip(state, curve_id);
+  if (encrypter == nullptr) return;
+
+  int64_t bytes = 0;
+  for (auto _ : state) {
+    std::string encrypted_sketch;
+    absl::Status status = encrypter->AppendNoiseRegisters(
+        noise_parameter, value_count, encrypted_sketch);
+    if (!status.ok()) {
+      state.SkipWithError(status.ToString().c_str());
+      return;
+    }
+    bytes += encrypted_sketch.size();
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+BENCHMARK(BM_AppendNoiseRegisters)
+    ->ArgsProduct({{0}, {1, 2}, {1, 3, 10}})
+    ->ArgNames({"curve", "values", "publishers"})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {curve}.
+void BM_HashToCurve(benchmark::State& state) {
+  Context ctx;
+  absl::StatusOr<ECGroup> ec_group =
+      ECGroup::Create(kCurveIds[state.range(0)], &ctx);
+  if (!ec_group.ok()) {
+    state.SkipWithError(ec_group.status().ToString().c_str());
+    return;
+  }
+  int64_t index = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        ec_group->GetPointByHashingToCurveSha256(std::to_string(index++)));
+  }
+  SetCiphertextRate(state, 1);
+}
+
+BENCHMARK(BM_HashToCurve)->DenseRange(0, kCurveCount - 1);
+
+// Args: {hash to curve method, batch size}.
+void BM_HashToCurveBatch(benchmark::State& state) {
+  Context ctx;
+  absl::StatusOr<ECGroup> ec_group =
+      ECGroup::Create(NID_X9_62_prime256v1, &ctx);
+  if (!ec_group.ok()) {
+    state.SkipWithError(ec_group.status().ToString().c_str());
+    return;
+  }
+  absl::StatusOr<HashToCurve> hash_to_curve = HashToCurve::Create(
+      static_cast<HashToCurveMethod>(state.range(0)), NID_X9_62_prime256v1,
+      &*ec_group, &ctx);
+  if (!hash_to_curve.ok()) {
+    state.SkipWithError(hash_to_curve.status().ToString().c_str());
+    return;
+  }
+  const int64_t batch_size = state.range(1);
+  std::vector<std::string> plaintexts(batch_size);
+  int64_t index = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    for (std::string& plaintext : plaintexts) {
+      plaintext = std::to_string(index++);
+    }
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(hash_to_curve->HashBatch(plaintexts));
+  }
+  SetCiphertextRate(state, batch_size);
+}
+
+BENCHMARK(BM_HashToCurveBatch)
+    ->ArgsProduct({{EncryptSketchRequest::TRY_AND_INCREMENT,
+                    EncryptSketchRequest::SSWU_V1},
+                   {1, 16, 256, 1024}})
+    ->ArgNames({"method", "batch"});
+
+// Args: {curve}.
+void BM_PointCompression(benchmark::State& state) {
+  Context ctx;
+  absl::StatusOr<ECGroup> ec_group =
+      ECGroup::Create(kCurveIds[state.range(0)], &ctx);
+  if (!ec_group.ok()) {
+    state.SkipWithError(ec_group.status().ToString().c_str());
+    return;
+  }
+  absl::StatusOr<ECPoint> point =
+      ec_group->GetPointByHashingToCurveSha256("point");
+  if (!point.ok()) {
+    state.SkipWithError(point.status().ToString().c_str());
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(point->ToBytesCompressed());
+  }
+}
+
+BENCHMARK(BM_PointCompression)->DenseRange(0, kCurveCount - 1);
+
+// Args: {curve}.
+void BM_ElGamalEncrypt(benchmark::State& state) {
+  const int curve_id = kCurveIds[state.range(0)];
+  absl::StatusOr<CiphertextString> public_key = GeneratePublicKey(curve_id);
+  if (!public_key.ok()) {
+    state.SkipWithError(public_key.status().ToString().c_str());
+    return;
+  }
+  absl::StatusOr<std::unique_ptr<CommutativeElGamal>> cipher =
+      CommutativeElGamal::CreateFromPublicKey(
+          curve_id, std::make_pair(public_key->u, public_key->e));
+  if (!cipher.ok()) {
+    state.SkipWithError(cipher.status().ToString().c_str());
+    return;
+  }
+
+  Context ctx;
+  absl::StatusOr<ECGroup> ec_group = ECGroup::Create(curve_id, &ctx);
+  if (!ec_group.ok()) {
+    state.SkipWithError(ec_group.status().ToString().c_str());
+    return;
+  }
+  absl::StatusOr<ECPoint> point =
+      ec_group->GetPointByHashingToCurveSha256("plaintext");
+  if (!point.ok()) {
+    state.SkipWithError(point.status().ToString().c_str());
+    return;
+  }
+  absl::StatusOr<std::string> plaintext = point->ToBytesCompressed();
+  if (!plaintext.ok()) {
+    state.SkipWithError(plaintext.status().ToString().c_str());
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize((*cipher)->Encrypt(*plaintext));
+  }
+  SetCiphertextRate(state, 1);
+}
+
+BENCHMARK(BM_ElGamalEncrypt)->DenseRange(0, kCurveCount - 1);
+
+// Args: {ciphertext count}.
+//
+// Appends ciphertexts the same way SketchEncrypter builds its output.
+void BM_AppendCiphertext(benchmark::State& state) {
+  // Two compressed P-256 points.
+  const std::pair<std::string, std::string> ciphertext(std::string(33, 'u'),
+                                                       std::string(33, 'e'));
+  const int64_t ciphertext_count = state.range(0);
+  for (auto _ : state) {
+    std::string encrypted_sketch;
+    encrypted_sketch.reserve(ciphertext_count * 66);
+    for (int64_t i = 0; i < ciphertext_count; ++i) {
+      encrypted_sketch.append(ciphertext.first);
+      encrypted_sketch.append(ciphertext.second);
+    }
+    benchmark::DoNotOptimize(encrypted_sketch);
+  }
+  SetCiphertextRate(state, ciphertext_count);
+  state.SetBytesProcessed(state.iterations() * ciphertext_count * 66);
+}
+
+BENCHMARK(BM_AppendCiphertext)->Range(1 << 10, 1 << 20);
+
+// Args: {ciphertext count}.
+//
+// Serializes an EncryptSketchResponse the same way EncryptSketch does.
+void BM_SerializeResponse(benchmark::State& state) {
+  const int64_t ciphertext_count = state.range(0);
+  EncryptSketchResponse response;
+  response.mutable_encrypted_sketch()->assign(ciphertext_count * 66, 'c');
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(response.SerializeAsString());
+  }
+  SetCiphertextRate(state, ciphertext_count);
+  state.SetBytesProcessed(state.iterations() * ciphertext_count * 66);
+}
+
+BENCHMARK(BM_SerializeResponse)->Range(1 << 10, 1 << 20);
+
+// Concatenated P-256 ciphertexts of `register_count` registers of three
+// ciphertexts, with random sign bytes.
+std::string MakeConcatenatedCiphertexts(int64_t register_count) {
+  std::mt19937_64 rng(register_count);
+  std::string encrypted_sketch(register_count * 3 * 66, 'x');
+  for (size_t i = 0; i < encrypted_sketch.size(); i += 33) {
+    encrypted_sketch[i] = 0x02 + rng() % 2;
+  }
+  return encrypted_sketch;
+}
+
+CiphertextFrameHeader MakeFrameHeader() {
+  CiphertextFrameHeader header;
+  header.ciphertexts_per_register = 3;
+  return header;
+}
+
+// Args: {register count}.
+//
+// Converts an encrypted sketch to the FRAMED_V1 format, as EncryptSketch does,
+// and reports the fraction of the bytes saved.
+void BM_FrameCiphertexts(benchmark::State& state) {
+  const std::string encrypted_sketch =
+      MakeConcatenatedCiphertexts(state.range(0));
+  size_t framed_bytes = 0;
+  for (auto _ : state) {
+    absl::StatusOr<std::string> framed =
+        FrameCiphertexts(encrypted_sketch, MakeFrameHeader());
+    if (!framed.ok()) {
+      state.SkipWithError(framed.status().ToString().c_str());
+      return;
+    }
+    framed_bytes = framed->size();
+    benchmark::DoNotOptimize(framed);
+  }
+  SetCiphertextRate(state, state.range(0) * 3);
+  state.SetBytesProcessed(state.iterations() * encrypted_sketch.size());
+  state.counters["saved"] =
+      1.0 - static_cast<double>(framed_bytes) / encrypted_sketch.size();
+}
+
+BENCHMARK(BM_FrameCiphertexts)->Range(1 << 10, 1 << 18);
+
+// Args: {register count, threads}.
+void BM_UnframeCiphertexts(benchmark::State& state) {
+  const std::string encrypted_sketch =
+      MakeConcatenatedCiphertexts(state.range(0));
+  absl::StatusOr<std::string> framed =
+      FrameCiphertexts(encrypted_sketch, MakeFrameHeader());
+  if (!framed.ok()) {
+    state.SkipWithError(framed.status().ToString().c_str());
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(UnframeCiphertexts(*framed, state.range(1)));
+  }
+  SetCiphertextRate(state, state.range(0) * 3);
+  state.SetBytesProcessed(state.iterations() * encrypted_sketch.size());
+}
+
+BENCHMARK(BM_UnframeCiphertexts)
+    ->ArgsProduct({{1 << 18}, {1, 4}})
+    ->ArgNames({"registers", "threads"})
+    ->UseRealTime();
+
+// Args: {threads}, where 0 combines the sets one by one with
+// CombineElGamalPublicKeys.
+//
+// Combines 1000 sets of three keys, like the duchy keys of a key rotation.
+void BM_CombineElGamalPublicKeySets(benchmark::State& state) {
+  const int thread_count = state.range(0);
+  std::vector<std::vector<ElGamalPublicKey>> key_sets(1'000);
+  for (std::vector<ElGamalPublicKey>& keys : key_sets) {
+    for (int i = 0; i < 3; ++i) {
+      absl::StatusOr<CiphertextString> public_key =
+          GeneratePublicKey(kCurveIds[0]);
+      if (!public_key.ok()) {
+        state.SkipWithError(public_key.status().ToString().c_str());
+        return;
+      }
+      ElGamalPublicKey& key = keys.emplace_back();
+      key.set_generator(public_key->u);
+      key.set_element(public_key->e);
+    }
+  }
+
+  for (auto _ : state) {
+    if (thread_count == 0) {
+      for (const std::vector<ElGamalPublicKey>& keys : key_sets) {
+        benchmark::DoNotOptimize(CombineElGamalPublicKeys(kCurveIds[0], keys));
+      }
+    } else {
+      benchmark::DoNotOptimize(
+          CombineElGamalPublicKeySets(kCurveIds[0], key_sets, thread_count));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * key_sets.size());
+}
+
+BENCHMARK(BM_CombineElGamalPublicKeySets)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(8)
+    ->ArgName("threads")
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
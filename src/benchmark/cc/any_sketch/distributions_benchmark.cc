@@ -0,0 +1,157 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for Distribution::Apply and the fingerprinters backing it.
+//
+// The Distribution benchmarks take the fingerprinter as an argument:
+//   0: a counter that returns a new fingerprint on every call. This isolates
+//      the cost of the distribution itself.
+//   1: the Farm fingerprinter.
+//   2: the SHA-256 fingerprinter.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "any_sketch/distributions.h"
+#include "benchmark/benchmark.h"
+#include "common_cpp/fingerprinters/fingerprinters.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+constexpr int kItemPoolSize = 1 << 12;
+
+// A fingerprinter that ignores its input and returns well-mixed values, so
+// that benchmarks measure only the code consuming the fingerprint.
+class CountingFingerprinter : public Fingerprinter {
+ public:
+  uint64_t Fingerprint(absl::Span<const unsigned char> item) const override {
+    // SplitMix64 increment.
+    state_ += 0x9e3779b97f4a7c15;
+    uint64_t z = state_;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+  }
+
+ private:
+  mutable uint64_t state_ = 0;
+};
+
+const Fingerprinter* GetFingerprinter(int64_t kind) {
+  static const Fingerprinter* const counting = new CountingFingerprinter();
+  switch (kind) {
+    case 1:
+      return &GetFarmFingerprinter();
+    case 2:
+      return &GetSha256Fingerprinter();
+    default:
+      return counting;
+  }
+}
+
+const std::vector<std::string>& Items() {
+  static const std::vector<std::string>* const items = [] {
+    auto* items = new std::vector<std::string>();
+    items->reserve(kItemPoolSize);
+    for (int i = 0; i < kItemPoolSize; ++i) {
+      items->push_back(absl::StrCat("benchmark-item-", i));
+    }
+    return items;
+  }();
+  return *items;
+}
+
+void RunApply(benchmark::State& state, const Distribution& distribution,
+              const ItemMetadata& item_metadata) {
+  const std::vector<std::string>& items = Items();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        distribution.Apply(items[i++ % items.size()], item_metadata));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Args: {fingerprinter, size}.
+void BM_UniformApply(benchmark::State& state) {
+  std::unique_ptr<Distribution> distribution = GetUniformDistribution(
+      GetFingerprinter(state.range(0)), 0, state.range(1) - 1);
+  RunApply(state, *distribution, {});
+}
+
+// Args: {fingerprinter, size}.
+void BM_ExponentialApply(benchmark::State& state) {
+  std::unique_ptr<Distribution> distribution = GetExponentialDistribution(
+      GetFingerprinter(state.range(0)), /*rate=*/12, state.range(1));
+  RunApply(state, *distribution, {});
+}
+
+// Args: {fingerprinter, size}.
+void BM_GeometricApply(benchmark::State& state) {
+  std::unique_ptr<Distribution> distribution = GetGeometricDistribution(
+      GetFingerprinter(state.range(0)), 0, state.range(1) - 1);
+  RunApply(state, *distribution, {});
+}
+
+// Args: {number of metadata entries}.
+void BM_OracleApply(benchmark::State& state) {
+  std::unique_ptr<Distribution> distribution =
+      GetOracleDistribution("frequency", 0, 1'000);
+  ItemMetadata item_metadata = {{"frequency", 1}};
+  for (int64_t i = 1; i < state.range(0); ++i) {
+    item_metadata[absl::StrCat("feature-", i)] = i;
+  }
+  RunApply(state, *distribution, item_metadata);
+}
+
+void DistributionArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgsProduct({{0, 1, 2}, {64, 100'000, 10'000'000}})
+      ->ArgNames({"fingerprinter", "size"});
+}
+
+BENCHMARK(BM_UniformApply)->Apply(DistributionArgs);
+BENCHMARK(BM_ExponentialApply)->Apply(DistributionArgs);
+BENCHMARK(BM_GeometricApply)->Apply(DistributionArgs);
+BENCHMARK(BM_OracleApply)->Arg(1)->Arg(8)->ArgName("metadata_entries");
+
+// Args: {fingerprinter, item length}.
+void BM_Fingerprint(benchmark::State& state) {
+  const Fingerprinter* fingerprinter = GetFingerprinter(state.range(0));
+  std::vector<std::string> items;
+  for (int i = 0; i < kItemPoolSize; ++i) {
+    std::string item = absl::StrCat(i, "-");
+    item.resize(state.range(1), 'x');
+    items.push_back(std::move(item));
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        fingerprinter->Fingerprint(items[i++ % items.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * state.range(1));
+}
+
+BENCHMARK(BM_Fingerprint)
+    ->ArgsProduct({{1, 2}, {8, 16, 64, 256}})
+    ->ArgNames({"fingerprinter", "item_bytes"});
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,127 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Compares the packed sketch encoding with the Sketch proto wire format.
+//
+// Sketches look like Liquid Legions sketches: registers at a fraction of the
+// indexes in [0, register count / fill), each with a 63-bit key and a small
+// frequency. Bytes per second are in terms of the proto size, so that the two
+// encodings are measured against the same amount of sketch.
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "any_sketch/packed_sketch.h"
+#include "benchmark/benchmark.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+// Args: {register count, fill percentage}.
+Sketch CreateSketch(const benchmark::State& state) {
+  const int64_t register_count = state.range(0);
+  const int64_t fill_percent = state.range(1);
+  Sketch sketch;
+  sketch.mutable_config()->add_values()->set_aggregator(
+      SketchConfig::ValueSpec::UNIQUE);
+  sketch.mutable_config()->add_values()->set_aggregator(
+      SketchConfig::ValueSpec::SUM);
+  uint64_t random = 1;
+  int64_t index = 0;
+  for (int64_t i = 0; i < register_count; ++i) {
+    random = random * 6364136223846793005 + 1442695040888963407;
+    // Skips each index with probability 1 - fill.
+    while (static_cast<int64_t>((random >> 33) % 100) >= fill_percent) {
+      random = random * 6364136223846793005 + 1442695040888963407;
+      ++index;
+    }
+    Sketch::Register* sketch_register = sketch.add_registers();
+    sketch_register->set_index(index++);
+    sketch_register->add_values(static_cast<int64_t>(random >> 1));
+    sketch_register->add_values(1 + (random >> 60) % 4);
+  }
+  return sketch;
+}
+
+void SetCounters(benchmark::State& state, const Sketch& sketch,
+                 size_t encoded_bytes) {
+  state.SetBytesProcessed(state.iterations() * sketch.ByteSizeLong());
+  state.SetItemsProcessed(state.iterations() * sketch.registers_size());
+  state.counters["bytes_per_register"] =
+      static_cast<double>(encoded_bytes) / sketch.registers_size();
+}
+
+void BM_PackedEncode(benchmark::State& state) {
+  const Sketch sketch = CreateSketch(state);
+  size_t encoded_bytes = 0;
+  for (auto _ : state) {
+    absl::StatusOr<std::string> packed = EncodePackedSketch(sketch);
+    encoded_bytes = packed->size();
+    benchmark::DoNotOptimize(packed);
+  }
+  SetCounters(state, sketch, encoded_bytes);
+}
+
+void BM_PackedDecode(benchmark::State& state) {
+  const Sketch sketch = CreateSketch(state);
+  const std::string packed = *EncodePackedSketch(sketch);
+  for (auto _ : state) {
+    absl::StatusOr<Sketch> decoded = DecodePackedSketch(packed);
+    if (!decoded.ok()) {
+      state.SkipWithError(decoded.status().ToString().c_str());
+      break;
+    }
+    benchmark::DoNotOptimize(decoded);
+  }
+  SetCounters(state, sketch, packed.size());
+}
+
+void BM_ProtoSerialize(benchmark::State& state) {
+  const Sketch sketch = CreateSketch(state);
+  for (auto _ : state) {
+    std::string serialized = sketch.SerializeAsString();
+    benchmark::DoNotOptimize(serialized);
+  }
+  SetCounters(state, sketch, sketch.ByteSizeLong());
+}
+
+void BM_ProtoParse(benchmark::State& state) {
+  const Sketch sketch = CreateSketch(state);
+  const std::string serialized = sketch.SerializeAsString();
+  for (auto _ : state) {
+    Sketch parsed;
+    if (!parsed.ParseFromString(serialized)) {
+      state.SkipWithError("failed to parse the Sketch proto");
+      break;
+    }
+    benchmark::DoNotOptimize(parsed);
+  }
+  SetCounters(state, sketch, serialized.size());
+}
+
+void SketchArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {5, 50, 100}})
+      ->ArgNames({"registers", "fill_percent"})
+      ->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_PackedEncode)->Apply(SketchArgs);
+BENCHMARK(BM_PackedDecode)->Apply(SketchArgs);
+BENCHMARK(BM_ProtoSerialize)->Apply(SketchArgs);
+BENCHMARK(BM_ProtoParse)->Apply(SketchArgs);
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,274 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Accuracy versus speed of EstimateCardinalityLiquidLegions.
+//
+// For every combination of decay rate, register count, sampling rate and
+// cardinality, it runs independent trials that sketch a synthetic set of known
+// cardinality with AnySketch and estimate its cardinality from the number of
+// active registers. Trials run in parallel. Each configuration reports:
+//   * the bias and the 50th, 90th and 99th percentiles of the absolute
+//     relative error of the estimates,
+//   * the median insert throughput,
+//   * the mean sketch memory, from AnySketch::Stats,
+//   * the median estimation latency.
+// Trials that activate every register cannot be estimated and are counted as
+// saturated instead.
+//
+// Example:
+//   bazel run -c opt
+//       //src/benchmark/cc/estimation:estimator_accuracy_benchmark --
+//       --sizes=10000,100000 --cardinalities=100000,1000000 --trials=200
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "common_cpp/fingerprinters/fingerprinters.h"
+#include "estimation/estimators.h"
+#include "glog/logging.h"
+
+ABSL_FLAG(std::vector<std::string>, decay_rates, {"12"},
+          "Decay rates of the Liquid Legions sketches.");
+ABSL_FLAG(std::vector<std::string>, sizes,
+          std::vector<std::string>({"10000", "100000"}),
+          "Register counts of the Liquid Legions sketches.");
+ABSL_FLAG(std::vector<std::string>, sampling_rates, {"1"},
+          "Fractions of the items that are inserted into the sketches.");
+ABSL_FLAG(std::vector<std::string>, cardinalities,
+          std::vector<std::string>({"10000", "100000"}),
+          "Cardinalities of the synthetic sets.");
+ABSL_FLAG(int, trials, 100, "Number of trials per configuration.");
+ABSL_FLAG(int, threads, 0,
+          "Number of threads running trials. Defaults to the number of "
+          "hardware threads.");
+ABSL_FLAG(uint64_t, seed, 1, "Seed of the synthetic sets.");
+
+namespace wfa::estimation {
+namespace {
+
+using ::wfa::any_sketch::AnySketch;
+using ::wfa::any_sketch::AnySketchStats;
+using ::wfa::any_sketch::Distribution;
+using ::wfa::any_sketch::GetExponentialDistribution;
+
+// Resolution of the sampling decision.
+constexpr uint64_t kSamplingBuckets = 1'000'000;
+
+struct Configuration {
+  double decay_rate;
+  int64_t size;
+  double sampling_rate;
+  int64_t cardinality;
+};
+
+struct TrialResult {
+  bool saturated = false;
+  double relative_error = 0;
+  double inserts_per_second = 0;
+  int64_t memory_bytes = 0;
+  absl::Duration estimation_latency;
+};
+
+// Salt of the sampling decision.
+constexpr uint64_t kSamplingSalt = 0x5a3b11c0ffee;
+
+// SplitMix64 finalizer.
+uint64_t Mix(uint64_t z) {
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// Returns a well-mixed item for `i`, so that the trials use unrelated sets.
+uint64_t SyntheticItem(uint64_t seed, uint64_t trial, uint64_t i) {
+  return Mix(seed * 0x9e3779b97f4a7c15 + (trial << 40) + i);
+}
+
+TrialResult RunTrial(const Configuration& configuration, uint64_t seed,
+                     int trial) {
+  const Fingerprinter* fingerprinter = &GetFarmFingerprinter();
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetExponentialDistribution(
+      fingerprinter, configuration.decay_rate, configuration.size));
+  AnySketch sketch(std::move(indexes), {});
+  const uint64_t sampling_threshold =
+      std::llround(configuration.sampling_rate * kSamplingBuckets);
+
+  absl::Time start = absl::Now();
+  for (int64_t i = 0; i < configuration.cardinality; ++i) {
+    uint64_t item = SyntheticItem(seed, trial, i);
+    // The salted hash is independent of the fingerprint choosing the
+    // register.
+    if (Mix(item ^ kSamplingSalt) % kSamplingBuckets >= sampling_threshold) {
+      continue;
+    }
+    CHECK(sketch.Insert(item, {}).ok());
+  }
+  absl::Duration insert_time = absl::Now() - start;
+
+  TrialResult result;
+  AnySketchStats stats = sketch.Stats();
+  result.inserts_per_second =
+      configuration.cardinality / absl::ToDoubleSeconds(insert_time);
+  result.memory_bytes = stats.memory_bytes;
+  if (stats.register_count >= static_cast<size_t>(configuration.size)) {
+    result.saturated = true;
+    return result;
+  }
+
+  start = absl::Now();
+  int64_t estimate = EstimateCardinalityLiquidLegions(
+      configuration.decay_rate, configuration.size, stats.register_count,
+      configuration.sampling_rate);
+  result.estimation_latency = absl::Now() - start;
+  result.relative_error =
+      static_cast<double>(estimate - configuration.cardinality) /
+      configuration.cardinality;
+  return result;
+}
+
+// Runs `trials` trials of `configuration` on `threads` threads.
+std::vector<TrialResult> RunTrials(const Configuration& configuration,
+                                   uint64_t seed, int trials, int threads) {
+  std::vector<TrialResult> results(trials);
+  std::atomic<int> next_trial = 0;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; ++i) {
+    workers.emplace_back([&] {
+      for (int trial = next_trial++; trial < trials; trial = next_trial++) {
+        results[trial] = RunTrial(configuration, seed, trial);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  return results;
+}
+
+// Returns the `q` quantile of `values` using the nearest rank.
+template <typename T>
+T Quantile(std::vector<T> values, double q) {
+  if (values.empty()) return T();
+  size_t rank = std::ceil(q * values.size());
+  rank = std::clamp<size_t>(rank, 1, values.size()) - 1;
+  std::nth_element(values.begin(), values.begin() + rank, values.end());
+  return values[rank];
+}
+
+void PrintHeader() {
+  std::cout << absl::StrFormat(
+      "%6s %10s %8s %12s %9s %8s %8s %8s %8s %14s %12s %12s\n", "decay",
+      "registers", "sampling", "cardinality", "saturated", "bias%", "p50%",
+      "p90%", "p99%", "inserts/sec", "memory_kib", "estimate_us");
+}
+
+void PrintSummary(const Configuration& configuration,
+                  const std::vector<TrialResult>& results) {
+  std::vector<double> absolute_errors;
+  std::vector<double> inserts_per_second;
+  std::vector<absl::Duration> latencies;
+  double error_sum = 0;
+  double memory_sum = 0;
+  int saturated = 0;
+  for (const TrialResult& result : results) {
+    inserts_per_second.push_back(result.inserts_per_second);
+    memory_sum += result.memory_bytes;
+    if (result.saturated) {
+      ++saturated;
+      continue;
+    }
+    absolute_errors.push_back(std::abs(result.relative_error));
+    error_sum += result.relative_error;
+    latencies.push_back(result.estimation_latency);
+  }
+  double bias =
+      absolute_errors.empty() ? 0 : error_sum / absolute_errors.size();
+  std::cout << absl::StrFormat(
+      "%6g %10d %8g %12d %9d %8.2f %8.2f %8.2f %8.2f %14.0f %12.1f %12.2f\n",
+      configuration.decay_rate, configuration.size,
+      configuration.sampling_rate, configuration.cardinality, saturated,
+      100 * bias, 100 * Quantile(absolute_errors, 0.5),
+      100 * Quantile(absolute_errors, 0.9),
+      100 * Quantile(absolute_errors, 0.99), Quantile(inserts_per_second, 0.5),
+      memory_sum / results.size() / 1024,
+      absl::ToDoubleMicroseconds(Quantile(latencies, 0.5)));
+}
+
+template <typename T>
+std::vector<T> ParseList(const std::vector<std::string>& values,
+                         absl::string_view flag) {
+  std::vector<T> result;
+  for (const std::string& value : values) {
+    double parsed;
+    CHECK(absl::SimpleAtod(value, &parsed))
+        << "Invalid value for --" << flag << ": " << value;
+    result.push_back(static_cast<T>(parsed));
+  }
+  return result;
+}
+
+void Run() {
+  const int trials = absl::GetFlag(FLAGS_trials);
+  int threads = absl::GetFlag(FLAGS_threads);
+  if (threads <= 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const uint64_t seed = absl::GetFlag(FLAGS_seed);
+
+  PrintHeader();
+  for (double decay_rate :
+       ParseList<double>(absl::GetFlag(FLAGS_decay_rates), "decay_rates")) {
+    for (int64_t size :
+         ParseList<int64_t>(absl::GetFlag(FLAGS_sizes), "sizes")) {
+      for (double sampling_rate : ParseList<double>(
+               absl::GetFlag(FLAGS_sampling_rates), "sampling_rates")) {
+        CHECK(sampling_rate > 0 && sampling_rate <= 1)
+            << "Sampling rates must be in (0, 1]";
+        for (int64_t cardinality : ParseList<int64_t>(
+                 absl::GetFlag(FLAGS_cardinalities), "cardinalities")) {
+          Configuration configuration = {decay_rate, size, sampling_rate,
+                                         cardinality};
+          PrintSummary(configuration,
+                       RunTrials(configuration, seed, trials, threads));
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+}  // namespace wfa::estimation
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+  wfa::estimation::Run();
+  return 0;
+}
@@ -0,0 +1,66 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the cardinality estimators.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "estimation/estimators.h"
+#include "math/expint.h"
+
+namespace wfa::estimation {
+namespace {
+
+constexpr double kDecayRate = 12;
+
+// Returns the expected number of active registers of a Liquid Legions sketch
+// for the given cardinality, capped below the total number of registers.
+uint64_t GetActiveRegisterCount(double decay_rate,
+                                uint64_t num_of_total_registers,
+                                double cardinality) {
+  double exp_rate = std::exp(decay_rate);
+  double t = cardinality / static_cast<double>(num_of_total_registers);
+  double negative_term = -wfa::math::expint((-decay_rate * t) / (exp_rate - 1));
+  double positive_term =
+      wfa::math::expint((-decay_rate * exp_rate * t) / (exp_rate - 1));
+  uint64_t active_register_count =
+      (1 - (negative_term + positive_term) / decay_rate) *
+      num_of_total_registers;
+  return std::min(active_register_count, num_of_total_registers - 1);
+}
+
+// Args: {number of registers, log10 of the cardinality}.
+void BM_EstimateCardinalityLiquidLegions(benchmark::State& state) {
+  const uint64_t num_of_total_registers = state.range(0);
+  const double cardinality = std::pow(10.0, state.range(1));
+  const uint64_t active_register_count = GetActiveRegisterCount(
+      kDecayRate, num_of_total_registers, cardinality);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EstimateCardinalityLiquidLegions(
+        kDecayRate, num_of_total_registers, active_register_count));
+  }
+  state.counters["active_registers"] = active_register_count;
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EstimateCardinalityLiquidLegions)
+    ->ArgsProduct({{10'000, 100'000, 1'000'000},
+                   benchmark::CreateDenseRange(0, 10, /*step=*/1)})
+    ->ArgNames({"registers", "log10_cardinality"});
+
+}  // namespace
+}  // namespace wfa::estimation
@@ -0,0 +1,98 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks for the exponential integral.
+//
+// BM_Expint measures wfa::math::expint, which resolves to std::expint when the
+// standard library provides the special math functions and to llvm::expint
+// otherwise. BM_LlvmExpint always measures the third_party implementation, and
+// BM_StdExpint is only built when std::expint is available, so that both can be
+// compared in the same binary.
+//
+// The argument selects the input range, which determines the evaluation
+// method of llvm::expint:
+//   0: x < -1, continued fraction.
+//   1: -1 <= x < 1, power series.
+//   2: x >= 40, asymptotic series.
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "expint/expint.h"
+#include "math/expint.h"
+
+namespace wfa::math {
+namespace {
+
+constexpr int kInputCount = 1024;
+
+std::vector<double> MakeInputs(int64_t input_range) {
+  double low, high;
+  switch (input_range) {
+    case 0:
+      low = -50;
+      high = -1;
+      break;
+    case 1:
+      low = -1;
+      high = 1;
+      break;
+    default:
+      low = 40;
+      high = 100;
+      break;
+  }
+  std::vector<double> inputs;
+  inputs.reserve(kInputCount);
+  for (int i = 0; i < kInputCount; ++i) {
+    double x = low + (high - low) * i / kInputCount;
+    // expint has a singularity at 0.
+    inputs.push_back(x == 0 ? 1.0 / kInputCount : x);
+  }
+  return inputs;
+}
+
+template <double (*Expint)(double)>
+void BM_ExpintImpl(benchmark::State& state) {
+  const std::vector<double> inputs = MakeInputs(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Expint(inputs[i++ % inputs.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+double LlvmExpint(double x) { return llvm::expint(x); }
+
+BENCHMARK_TEMPLATE(BM_ExpintImpl, expint)
+    ->Name("BM_Expint")
+    ->DenseRange(0, 2)
+    ->ArgName("input_range");
+BENCHMARK_TEMPLATE(BM_ExpintImpl, LlvmExpint)
+    ->Name("BM_LlvmExpint")
+    ->DenseRange(0, 2)
+    ->ArgName("input_range");
+
+#ifdef __STDCPP_MATH_SPEC_FUNCS__
+double StdExpint(double x) { return std::expint(x); }
+
+BENCHMARK_TEMPLATE(BM_ExpintImpl, StdExpint)
+    ->Name("BM_StdExpint")
+    ->DenseRange(0, 2)
+    ->ArgName("input_range");
+#endif
+
+}  // namespace
+}  // namespace wfa::math
@@ -0,0 +1,105 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for the distributed noisers across privacy parameters.
+//
+// The noisers are configured like publisher noise, from epsilon, delta and the
+// contributor count. Both report samples/sec; the discrete Gaussian noiser
+// also reports the mean number of rejection loop iterations per sample, which
+// is what makes it slow for small epsilon.
+
+#include <cstdint>
+#include <iterator>
+
+#include "absl/status/statusor.h"
+#include "benchmark/benchmark.h"
+#include "math/distributed_discrete_gaussian_noiser.h"
+#include "math/distributed_geometric_noiser.h"
+#include "math/noise_parameters_computation.h"
+#include "wfa/any_sketch/differential_privacy.pb.h"
+
+namespace wfa::math {
+namespace {
+
+using ::wfa::any_sketch::DifferentialPrivacyParams;
+
+constexpr double kEpsilons[] = {0.01, 0.1, 1, 10};
+constexpr double kDeltas[] = {1e-12, 1e-9, 1e-5};
+
+// Returns the privacy parameters for the epsilon and delta at the given
+// indexes of kEpsilons and kDeltas, and labels the benchmark with them.
+DifferentialPrivacyParams GetParams(benchmark::State& state,
+                                    int64_t epsilon_index,
+                                    int64_t delta_index) {
+  DifferentialPrivacyParams params;
+  params.set_epsilon(kEpsilons[epsilon_index]);
+  params.set_delta(kDeltas[delta_index]);
+  state.counters["epsilon"] = params.epsilon();
+  state.counters["delta"] = params.delta();
+  return params;
+}
+
+// Args: {epsilon index, delta index, publisher count}.
+void BM_GeometricNoise(benchmark::State& state) {
+  DifferentialPrivacyParams params =
+      GetParams(state, state.range(0), state.range(1));
+  DistributedGeometricNoiser noiser(
+      GetGeometricPublisherNoiseOptions(params, state.range(2)));
+  for (auto _ : state) {
+    absl::StatusOr<int64_t> noise = noiser.GenerateNoiseComponent();
+    if (!noise.ok()) {
+      state.SkipWithError(noise.status().ToString().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(*noise);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Args: {epsilon index, delta index, contributor count}.
+void BM_DiscreteGaussianNoise(benchmark::State& state) {
+  DifferentialPrivacyParams params =
+      GetParams(state, state.range(0), state.range(1));
+  DistributedDiscreteGaussianNoiser noiser(
+      GetDiscreteGaussianPublisherNoiseOptions(params, state.range(2)));
+  for (auto _ : state) {
+    absl::StatusOr<int64_t> noise = noiser.GenerateNoiseComponent();
+    if (!noise.ok()) {
+      state.SkipWithError(noise.status().ToString().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(*noise);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["sigma_distributed"] = noiser.options().sigma_distributed;
+  state.counters["iterations_per_sample"] =
+      static_cast<double>(noiser.rejection_iteration_count()) /
+      state.iterations();
+}
+
+void NoiseArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark
+      ->ArgsProduct({benchmark::CreateDenseRange(0, std::size(kEpsilons) - 1,
+                                                 /*step=*/1),
+                     benchmark::CreateDenseRange(0, std::size(kDeltas) - 1,
+                                                 /*step=*/1),
+                     {1, 3, 10, 100}})
+      ->ArgNames({"epsilon", "delta", "contributors"});
+}
+
+BENCHMARK(BM_GeometricNoise)->Apply(NoiseArgs);
+BENCHMARK(BM_DiscreteGaussianNoise)->Apply(NoiseArgs);
+
+}  // namespace
+}  // namespace wfa::math
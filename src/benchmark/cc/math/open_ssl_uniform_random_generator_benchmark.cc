@@ -0,0 +1,75 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks for the OpenSSL random generators, reporting bytes/sec.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "benchmark/benchmark.h"
+#include "math/open_ssl_uniform_random_generator.h"
+#include "math/uniform_pseudorandom_generator.h"
+
+namespace wfa::math {
+namespace {
+
+void BM_UniformRandomGenerator(benchmark::State& state) {
+  OpenSslUniformRandomGenerator rnd;
+  if (rnd.status() != 1) {
+    state.SkipWithError("Failed to seed random generator.");
+    return;
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(rnd());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() *
+                          sizeof(OpenSslUniformRandomGenerator::result_type));
+}
+
+BENCHMARK(BM_UniformRandomGenerator);
+
+// Args: {bytes per request}.
+void BM_UniformPseudorandomGenerator(benchmark::State& state) {
+  std::vector<unsigned char> key(kBytesPerAes256Key, 1);
+  std::vector<unsigned char> iv(kBytesPerAes256Iv, 2);
+  absl::StatusOr<std::unique_ptr<UniformPseudorandomGenerator>> prng =
+      OpenSslUniformPseudorandomGenerator::Create(key, iv);
+  if (!prng.ok()) {
+    state.SkipWithError(prng.status().ToString().c_str());
+    return;
+  }
+  const uint64_t size = state.range(0);
+  for (auto _ : state) {
+    absl::StatusOr<std::vector<unsigned char>> bytes =
+        (*prng)->GetPseudorandomBytes(size);
+    if (!bytes.ok()) {
+      state.SkipWithError(bytes.status().ToString().c_str());
+      return;
+    }
+    benchmark::DoNotOptimize(bytes->data());
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_UniformPseudorandomGenerator)
+    ->RangeMultiplier(16)
+    ->Range(16, 16 << 20)
+    ->ArgName("bytes");
+
+}  // namespace
+}  // namespace wfa::math
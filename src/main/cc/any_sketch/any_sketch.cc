@@ -19,10 +19,12 @@
 #include <iostream>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "absl/base/macros.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -33,6 +35,23 @@
 #include "common_cpp/macros/macros.h"
 
 namespace wfa::any_sketch {
+namespace {
+
+// Returns the number of bytes `array` allocated outside of itself.
+template <typename T>
+size_t HeapBytes(const absl::FixedArray<T>& array) {
+  return array.size() > absl::FixedArray<T>::inline_elements ? array.memsize()
+                                                              : 0;
+}
+
+void SortByIndex(std::vector<AnySketch::Register>& registers) {
+  std::sort(registers.begin(), registers.end(),
+            [](const AnySketch::Register& a, const AnySketch::Register& b) {
+              return a.index < b.index;
+            });
+}
+
+}  // namespace
 
 AnySketch::AnySketch(std::vector<std::unique_ptr<Distribution>> indexes,
                      std::vector<ValueFunction> values)
@@ -58,15 +77,20 @@ absl::Status AnySketch::AggregateIntoRegister(
 
   if (inserted) {
     std::copy(new_values.begin(), new_values.end(), register_values.begin());
+    MarkChanged(index);
     return absl::OkStatus();
   }
 
   // Otherwise, merge.
+  bool changed = false;
   for (size_t i = 0; i < register_values.size(); ++i) {
     const Aggregator& aggregator = GetAggregator(values_[i].aggregator_type);
-    register_values[i] =
+    const ValueType aggregated =
         aggregator.Aggregate(register_values[i], new_values[i]);
+    changed |= aggregated != register_values[i];
+    register_values[i] = aggregated;
   }
+  if (changed) MarkChanged(index);
   return absl::OkStatus();
 }
 
@@ -99,15 +123,36 @@ absl::Status AnySketch::Insert(uint64_t item,
   return Insert(arr, item_metadata);
 }
 
-absl::Status AnySketch::Insert(absl::string_view item,
-                               const ItemMetadata& item_metadata) {
+absl::StatusOr<int64_t> AnySketch::ComputeRegister(
+    absl::string_view item, const ItemMetadata& item_metadata,
+    absl::Span<ValueType> values) const {
+  if (values.size() != register_size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Output has wrong dimension. Expected ", register_size(),
+                     " but got ", values.size()));
+  }
   ASSIGN_OR_RETURN(int64_t index, GetIndex(item, item_metadata));
-  absl::FixedArray<int64_t> new_values(register_size());
   for (size_t i = 0; i < register_size(); ++i) {
-    ASSIGN_OR_RETURN(new_values[i],
+    ASSIGN_OR_RETURN(values[i],
                      values_[i].distribution->Apply(item, item_metadata));
   }
-  return AggregateIntoRegister(index, new_values);
+  return index;
+}
+
+absl::Status AnySketch::Insert(absl::string_view item,
+                               const ItemMetadata& item_metadata) {
+  absl::FixedArray<int64_t> new_values(register_size());
+  ASSIGN_OR_RETURN(
+      int64_t index,
+      ComputeRegister(item, item_metadata, absl::MakeSpan(new_values)));
+  return InsertComputedRegister(index, new_values);
+}
+
+absl::Status AnySketch::InsertComputedRegister(
+    int64_t index, absl::Span<const int64_t> values) {
+  RETURN_IF_ERROR(AggregateIntoRegister(index, values));
+  ++insert_count_;
+  return absl::OkStatus();
 }
 
 absl::Status AnySketch::Merge(const AnySketch& other) {
@@ -115,6 +160,8 @@ absl::Status AnySketch::Merge(const AnySketch& other) {
   for (const auto& [item, new_values] : other.registers_) {
     RETURN_IF_ERROR(AggregateIntoRegister(item, new_values));
   }
+  ++merge_count_;
+  merged_register_count_ += other.registers_.size();
   return absl::OkStatus();
 }
 
@@ -126,6 +173,66 @@ absl::Status AnySketch::MergeAll(
   return absl::OkStatus();
 }
 
+absl::Status AnySketch::CheckRemovable(const AnySketch& other) const {
+  if (other.register_size() != register_size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The other sketch has ", other.register_size(),
+                     " values but this one has ", register_size()));
+  }
+  if (track_changes_) {
+    return absl::FailedPreconditionError(
+        "Registers cannot be removed while changes are tracked.");
+  }
+  return absl::OkStatus();
+}
+
+void AnySketch::RemoveRegisters(
+    const AnySketch& other, bool keep_found,
+    absl::FunctionRef<void(absl::FixedArray<ValueType>&,
+                           const absl::FixedArray<ValueType>&)>
+        on_found) {
+  // The lookups in the other table miss the cache for large sketches, so the
+  // slots of the registers a few steps ahead are fetched while the current one
+  // is looked up. Erasing does not move other registers, so the iterator ahead
+  // stays valid.
+  constexpr int kPrefetchDistance = 8;
+  auto ahead = registers_.begin();
+  for (int i = 0; i < kPrefetchDistance && ahead != registers_.end(); ++i) {
+    other.registers_.prefetch((ahead++)->first);
+  }
+  for (auto it = registers_.begin(); it != registers_.end();) {
+    if (ahead != registers_.end()) other.registers_.prefetch((ahead++)->first);
+    auto found = other.registers_.find(it->first);
+    if ((found != other.registers_.end()) != keep_found) {
+      registers_.erase(it++);
+      continue;
+    }
+    if (found != other.registers_.end()) on_found(it->second, found->second);
+    ++it;
+  }
+}
+
+absl::Status AnySketch::Intersect(const AnySketch& other) {
+  RETURN_IF_ERROR(CheckRemovable(other));
+  RemoveRegisters(other, /*keep_found=*/true,
+                  [this](absl::FixedArray<ValueType>& values,
+                         const absl::FixedArray<ValueType>& other_values) {
+                    for (size_t i = 0; i < values.size(); ++i) {
+                      values[i] = GetAggregator(values_[i].aggregator_type)
+                                      .Aggregate(values[i], other_values[i]);
+                    }
+                  });
+  return absl::OkStatus();
+}
+
+absl::Status AnySketch::Subtract(const AnySketch& other) {
+  RETURN_IF_ERROR(CheckRemovable(other));
+  RemoveRegisters(other, /*keep_found=*/false,
+                  [](absl::FixedArray<ValueType>&,
+                     const absl::FixedArray<ValueType>&) {});
+  return absl::OkStatus();
+}
+
 AnySketch::Iterator& AnySketch::Iterator::operator++() {
   ++pos_;
   return *this;
@@ -147,4 +254,118 @@ AnySketch::Iterator AnySketch::end() const {
   return Iterator(registers_.end());
 }
 
+std::vector<AnySketch::Register> AnySketch::SortedRegisters() const {
+  std::vector<Register> sorted;
+  sorted.reserve(registers_.size());
+  for (const auto& [index, values] : registers_) {
+    sorted.push_back({.index = index, .values = values});
+  }
+  SortByIndex(sorted);
+  return sorted;
+}
+
+void AnySketch::ForEachSorted(
+    absl::FunctionRef<void(const Register&)> fn) const {
+  for (const Register& sketch_register : SortedRegisters()) {
+    fn(sketch_register);
+  }
+}
+
+std::vector<std::vector<AnySketch::Register>> AnySketch::Partition(
+    int k) const {
+  std::vector<Register> sorted = SortedRegisters();
+  const size_t partition_count =
+      std::min(static_cast<size_t>(std::max(k, 1)), sorted.size());
+  std::vector<std::vector<Register>> partitions(partition_count);
+  for (size_t i = 0; i < partition_count; ++i) {
+    partitions[i].assign(sorted.begin() + i * sorted.size() / partition_count,
+                         sorted.begin() +
+                             (i + 1) * sorted.size() / partition_count);
+  }
+  return partitions;
+}
+
+void AnySketch::Checkpoint() {
+  track_changes_ = true;
+  changed_indexes_.clear();
+}
+
+std::vector<AnySketch::Register> AnySketch::ChangedRegisters() const {
+  if (!track_changes_) return SortedRegisters();
+
+  std::vector<Register> changed;
+  changed.reserve(changed_indexes_.size());
+  for (uint64_t index : changed_indexes_) {
+    changed.push_back(
+        {.index = index, .values = registers_.find(index)->second});
+  }
+  SortByIndex(changed);
+  return changed;
+}
+
+absl::Status AnySketch::ApplyDelta(absl::Span<const Register> delta) {
+  for (const Register& delta_register : delta) {
+    if (delta_register.values.size() != register_size()) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Register ", delta_register.index, " of the delta has ",
+          delta_register.values.size(), " values but the sketch has ",
+          register_size()));
+    }
+  }
+  for (const Register& delta_register : delta) {
+    auto [register_itr, inserted] =
+        registers_.try_emplace(delta_register.index, register_size());
+    absl::FixedArray<ValueType>& register_values = register_itr->second;
+    if (inserted || !std::equal(register_values.begin(), register_values.end(),
+                                delta_register.values.begin())) {
+      std::copy(delta_register.values.begin(), delta_register.values.end(),
+                register_values.begin());
+      MarkChanged(delta_register.index);
+    }
+  }
+  return absl::OkStatus();
+}
+
+AnySketchStats AnySketch::Stats() const {
+  using MapType = Iterator::MapType;
+
+  AnySketchStats stats;
+  stats.register_count = registers_.size();
+  stats.capacity = registers_.bucket_count();
+  stats.slot_bytes = sizeof(MapType::value_type) + 1;
+  if (stats.capacity > 0) {
+    stats.load_factor =
+        static_cast<double>(stats.register_count) / stats.capacity;
+    // The slots, plus a cloned group of control bytes so that probing never
+    // wraps mid-group.
+    stats.table_bytes = stats.capacity * stats.slot_bytes + 16;
+  }
+
+  for (const auto& [index, values] : registers_) {
+    stats.value_bytes += HeapBytes(values);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (values_[i].aggregator_type == AggregatorType::kUnique &&
+          values[i] == kUniqueAggregatorDestroyedValue) {
+        ++stats.destroyed_register_count;
+        break;
+      }
+    }
+  }
+
+  stats.memory_bytes = sizeof(AnySketch) + stats.table_bytes +
+                       stats.value_bytes + HeapBytes(indexes_) +
+                       HeapBytes(values_);
+  if (changed_indexes_.bucket_count() > 0) {
+    stats.memory_bytes +=
+        changed_indexes_.bucket_count() * (sizeof(uint64_t) + 1) + 16;
+  }
+
+  stats.insert_count = insert_count_;
+  stats.merge_count = merge_count_;
+  stats.merged_register_count = merged_register_count_;
+  stats.changed_register_count =
+      track_changes_ ? changed_indexes_.size() : registers_.size();
+  return stats;
+}
+
 }  // namespace wfa::any_sketch
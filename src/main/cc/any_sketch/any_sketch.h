@@ -16,12 +16,15 @@
 #define SRC_MAIN_CC_ANY_SKETCH_ANY_SKETCH_H_
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -31,6 +34,45 @@
 #include "common_cpp/fingerprinters/fingerprinters.h"
 
 namespace wfa::any_sketch {
+
+class AnySketch;
+
+// Returns new empty sketches, all with the same indexes and values.
+using AnySketchFactory = std::function<std::unique_ptr<AnySketch>()>;
+
+// Size, memory and activity statistics of an AnySketch. See AnySketch::Stats.
+struct AnySketchStats {
+  // Number of registers held.
+  size_t register_count = 0;
+  // Number of slots in the register hash table.
+  size_t capacity = 0;
+  // register_count / capacity, or 0 for an unallocated table.
+  double load_factor = 0;
+  // Number of registers with at least one destroyed UNIQUE value.
+  size_t destroyed_register_count = 0;
+
+  // Bytes per slot of the register hash table, including its control byte.
+  size_t slot_bytes = 0;
+  // Estimated bytes of the register hash table: its slots and control bytes.
+  size_t table_bytes = 0;
+  // Bytes of register values stored outside the hash table slots. Registers
+  // with few values keep them inline in their slot and contribute nothing.
+  size_t value_bytes = 0;
+  // Estimated total heap and object footprint of the sketch.
+  size_t memory_bytes = 0;
+
+  // Number of successful Insert calls.
+  int64_t insert_count = 0;
+  // Number of successful Merge calls, including those made by MergeAll.
+  int64_t merge_count = 0;
+  // Number of registers aggregated in by those Merge calls.
+  int64_t merged_register_count = 0;
+
+  // Number of registers changed since the last Checkpoint, or register_count
+  // if there was none.
+  size_t changed_register_count = 0;
+};
+
 // A generalized sketch class.
 // This sketch class generalizes the data structure required to
 // capture Bloom filters, HLLs, Cascading Legions, Vector of Counts, and
@@ -102,6 +144,23 @@ class AnySketch {
   ABSL_MUST_USE_RESULT absl::Status Insert(absl::string_view item,
                                            const ItemMetadata &item_metadata);
 
+  // Computes the register that Insert(item, item_metadata) aggregates into:
+  // writes its values to `values`, which must have one element per
+  // ValueFunction, and returns its index. The sketch is not modified, so the
+  // result can be aggregated into any sketch with the same indexes and values.
+  absl::StatusOr<int64_t> ComputeRegister(absl::string_view item,
+                                          const ItemMetadata &item_metadata,
+                                          absl::Span<ValueType> values) const;
+
+  // Completes an Insert whose register was computed by ComputeRegister: merges
+  // `values` into the register at `index` and counts the insert.
+  ABSL_MUST_USE_RESULT absl::Status InsertComputedRegister(
+      int64_t index, absl::Span<const int64_t> values);
+
+  // Hints that the register at `index` is about to be aggregated into, so
+  // that its slot is fetched into the cache while other work proceeds.
+  void PrefetchRegister(int64_t index) const { registers_.prefetch(index); }
+
   // Merges the other sketch into this one. The result is equivalent to
   // sketching the union of the sets that went into this and the other sketch.
   ABSL_MUST_USE_RESULT absl::Status Merge(const AnySketch &other);
@@ -111,17 +170,116 @@ class AnySketch {
   ABSL_MUST_USE_RESULT absl::Status MergeAll(
       absl::Span<const std::unique_ptr<AnySketch>> others);
 
+  // Keeps only the registers whose index is also in the other sketch, and
+  // aggregates the other sketch's values into them. The result is the
+  // register-level intersection, e.g. for overlap reporting.
+  //
+  // Fails if the sketches have different numbers of values, or if changes are
+  // tracked, since a delta cannot express removed registers.
+  ABSL_MUST_USE_RESULT absl::Status Intersect(const AnySketch &other);
+
+  // Removes the registers whose index is in the other sketch, leaving the
+  // registers of this sketch not in the other, e.g. for incremental reach.
+  // Fails like Intersect.
+  ABSL_MUST_USE_RESULT absl::Status Subtract(const AnySketch &other);
+
   Iterator begin() const;
 
   Iterator end() const;
 
+  // Returns the registers in increasing index order. The values of the
+  // registers remain valid until the sketch is next modified.
+  //
+  // Iteration with begin() and end() is in hash table order; this sorts a copy
+  // of the register views in O(n log n).
+  std::vector<Register> SortedRegisters() const;
+
+  // Calls `fn` on each register in increasing index order.
+  void ForEachSorted(absl::FunctionRef<void(const Register &)> fn) const;
+
+  // Splits the registers into at most `k` non-empty partitions of nearly equal
+  // size. Each partition is in increasing index order, and every index in a
+  // partition is below every index in the following ones, so the partitions
+  // can be scanned or merged independently, e.g. by separate threads. Values
+  // of `k` below 1 are treated as 1. As with SortedRegisters, the values remain
+  // valid until the sketch is next modified.
+  std::vector<std::vector<Register>> Partition(int k) const;
+
+  // Marks the current contents of the sketch as a checkpoint, from which
+  // ChangedRegisters tracks the registers that change.
+  //
+  // Tracking is off until the first Checkpoint, and then costs a hash set
+  // insertion the first time each register changes.
+  void Checkpoint();
+
+  // Returns the registers whose values changed since the last Checkpoint, in
+  // increasing index order, or every register if there was no checkpoint.
+  // Registers that were aggregated into but kept their values are omitted.
+  //
+  // These registers, with their current values, form a delta: applying it with
+  // ApplyDelta to a copy of the sketch at the checkpoint yields this sketch. As
+  // with SortedRegisters, the values remain valid until the sketch is next
+  // modified.
+  std::vector<Register> ChangedRegisters() const;
+
+  // Sets each register of `delta` to its values, replacing those of any
+  // register with the same index. Nothing is applied if a register of `delta`
+  // has the wrong number of values.
+  //
+  // Unlike AggregateIntoRegister, this overwrites, so that a delta of current
+  // values can be applied to an older copy of the sketch without counting the
+  // registers twice.
+  ABSL_MUST_USE_RESULT absl::Status ApplyDelta(
+      absl::Span<const Register> delta);
+
+  // Reserves space for at least `register_count` registers, so that adding
+  // them does not rehash the register table, e.g. before merging sketches of
+  // known sizes into an empty one.
+  void Reserve(size_t register_count) { registers_.reserve(register_count); }
+
+  // Returns the number of registers, in constant time.
+  size_t register_count() const { return registers_.size(); }
+
+  // Returns the functions computing each value of the registers.
+  absl::Span<const ValueFunction> value_functions() const { return values_; }
+
+  // Returns statistics on the current size and memory footprint of the sketch
+  // and the work done on it so far. Runs in time linear in the number of
+  // registers and does not allocate.
+  AnySketchStats Stats() const;
+
  private:
   absl::flat_hash_map<uint64_t, absl::FixedArray<ValueType>> registers_;
   absl::FixedArray<std::unique_ptr<Distribution>> indexes_;
   absl::FixedArray<ValueFunction> values_;
 
+  int64_t insert_count_ = 0;
+  int64_t merge_count_ = 0;
+  int64_t merged_register_count_ = 0;
+
+  // Whether Checkpoint was called, and the indexes of the registers changed
+  // since then.
+  bool track_changes_ = false;
+  absl::flat_hash_set<uint64_t> changed_indexes_;
+
   size_t register_size() const;
 
+  // Checks that registers can be removed because of `other`.
+  absl::Status CheckRemovable(const AnySketch &other) const;
+
+  // Removes each register for which `other` has (if `keep_found` is false) or
+  // lacks (if true) a register with the same index, and calls `on_found` on
+  // the registers kept, with their values in `other`.
+  void RemoveRegisters(
+      const AnySketch &other, bool keep_found,
+      absl::FunctionRef<void(absl::FixedArray<ValueType> &,
+                             const absl::FixedArray<ValueType> &)>
+          on_found);
+
+  void MarkChanged(uint64_t index) {
+    if (track_changes_) changed_indexes_.insert(index);
+  }
+
   absl::StatusOr<int64_t> GetIndex(absl::string_view item,
                                    const ItemMetadata &item_metadata) const;
 };
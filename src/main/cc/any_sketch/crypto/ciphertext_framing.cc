@@ -0,0 +1,253 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/ciphertext_framing.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "any_sketch/util.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+constexpr uint32_t kMagic = 0x43414657;  // "WFAC"
+constexpr uint8_t kFormatVersion = 1;
+constexpr size_t kMagicOffset = 0;
+constexpr size_t kVersionOffset = 4;
+constexpr size_t kPointBytesOffset = 5;
+constexpr size_t kStrategyOffset = 6;
+constexpr size_t kHashToCurveMethodOffset = 7;
+constexpr size_t kCiphertextsPerRegisterOffset = 8;
+constexpr size_t kRegistersPerBlockOffset = 12;
+constexpr size_t kRegisterCountOffset = 16;
+constexpr size_t kHeaderSize = 24;
+constexpr size_t kBlockHeaderSize = 4;
+// Upper bounds of the counts of a header, far above those of any sketch. They
+// keep the sizes of a register and of a block well within 64 bits.
+constexpr int kMaxCiphertextsPerRegister = 1 << 16;
+constexpr int kMaxRegistersPerBlock = 1 << 20;
+
+// The sign bytes of compressed points.
+constexpr char kEvenY = 0x02;
+constexpr char kOddY = 0x03;
+
+// The sizes of a register and a block in both formats, for a header that
+// passed ValidateHeader.
+struct Layout {
+  explicit Layout(const CiphertextFrameHeader& header)
+      : points_per_register(
+            2 * static_cast<uint64_t>(header.ciphertexts_per_register)),
+        point_bytes(header.point_bytes),
+        register_bytes(points_per_register * point_bytes),
+        registers_per_block(header.registers_per_block),
+        full_block_bytes(FramedBlockBytes(registers_per_block)) {}
+
+  // Bytes of a framed block of `registers` registers.
+  size_t FramedBlockBytes(uint64_t registers) const {
+    const uint64_t points = registers * points_per_register;
+    return kBlockHeaderSize + (points + 7) / 8 + points * (point_bytes - 1);
+  }
+
+  // Bytes of the framed sketch of `registers` registers.
+  size_t FramedBytes(uint64_t registers) const {
+    const uint64_t full_blocks = registers / registers_per_block;
+    const uint64_t remainder = registers % registers_per_block;
+    return kHeaderSize + full_blocks * full_block_bytes +
+           (remainder == 0 ? 0 : FramedBlockBytes(remainder));
+  }
+
+  uint64_t BlockCount(uint64_t registers) const {
+    return (registers + registers_per_block - 1) / registers_per_block;
+  }
+
+  uint64_t points_per_register;
+  uint64_t point_bytes;
+  uint64_t register_bytes;
+  uint64_t registers_per_block;
+  uint64_t full_block_bytes;
+};
+
+absl::Status ValidateHeader(const CiphertextFrameHeader& header) {
+  if (header.point_bytes < 2 || header.point_bytes > 255) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "point_bytes should be in [2, 255], not ", header.point_bytes));
+  }
+  if (header.ciphertexts_per_register < 1 ||
+      header.ciphertexts_per_register > kMaxCiphertextsPerRegister) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("ciphertexts_per_register should be in [1, ",
+                     kMaxCiphertextsPerRegister, "], not ",
+                     header.ciphertexts_per_register));
+  }
+  if (header.registers_per_block < 1 ||
+      header.registers_per_block > kMaxRegistersPerBlock) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "registers_per_block should be in [1, ", kMaxRegistersPerBlock,
+        "], not ", header.registers_per_block));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> FrameCiphertexts(
+    absl::string_view encrypted_sketch, const CiphertextFrameHeader& header) {
+  RETURN_IF_ERROR(ValidateHeader(header));
+  const Layout layout(header);
+  if (encrypted_sketch.size() % layout.register_bytes != 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The encrypted sketch has ", encrypted_sketch.size(),
+        " bytes, which is not a multiple of the ", layout.register_bytes,
+        " bytes of a register."));
+  }
+  const uint64_t register_count =
+      encrypted_sketch.size() / layout.register_bytes;
+
+  std::string framed(layout.FramedBytes(register_count), '\0');
+  char* data = framed.data();
+  Store32(kMagic, data + kMagicOffset);
+  data[kVersionOffset] = static_cast<char>(kFormatVersion);
+  data[kPointBytesOffset] = static_cast<char>(header.point_bytes);
+  data[kStrategyOffset] = static_cast<char>(header.destroyed_register_strategy);
+  data[kHashToCurveMethodOffset] =
+      static_cast<char>(header.hash_to_curve_method);
+  Store32(header.ciphertexts_per_register,
+          data + kCiphertextsPerRegisterOffset);
+  Store32(header.registers_per_block, data + kRegistersPerBlockOffset);
+  Store64(register_count, data + kRegisterCountOffset);
+
+  const char* point = encrypted_sketch.data();
+  char* block = data + kHeaderSize;
+  for (uint64_t begin = 0; begin < register_count;
+       begin += layout.registers_per_block) {
+    const uint64_t registers =
+        std::min(layout.registers_per_block, register_count - begin);
+    const uint64_t points = registers * layout.points_per_register;
+    Store32(registers, block);
+    char* signs = block + kBlockHeaderSize;
+    char* x = signs + (points + 7) / 8;
+    for (uint64_t i = 0; i < points; ++i) {
+      if (point[0] == kOddY) {
+        signs[i / 8] |= static_cast<char>(1 << (i % 8));
+      } else if (point[0] != kEvenY) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Point ", (point - encrypted_sketch.data()) / layout.point_bytes,
+            " of the encrypted sketch is not compressed."));
+      }
+      std::memcpy(x, point + 1, layout.point_bytes - 1);
+      x += layout.point_bytes - 1;
+      point += layout.point_bytes;
+    }
+    block = x;
+  }
+  return framed;
+}
+
+bool IsFramedCiphertexts(absl::string_view encrypted_sketch) {
+  return encrypted_sketch.size() >= kHeaderSize &&
+         Load32(encrypted_sketch.data() + kMagicOffset) == kMagic;
+}
+
+absl::StatusOr<CiphertextFrameHeader> ParseCiphertextFrameHeader(
+    absl::string_view framed) {
+  if (!IsFramedCiphertexts(framed)) {
+    return absl::InvalidArgumentError(
+        "The encrypted sketch is not in the framed format.");
+  }
+  const char* data = framed.data();
+  const uint8_t version = data[kVersionOffset];
+  if (version != kFormatVersion) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Unsupported framed ciphertext format version ", version, "."));
+  }
+  CiphertextFrameHeader header;
+  header.point_bytes = static_cast<uint8_t>(data[kPointBytesOffset]);
+  header.destroyed_register_strategy =
+      static_cast<EncryptSketchRequest::DestroyedRegisterStrategy>(
+          data[kStrategyOffset]);
+  header.hash_to_curve_method =
+      static_cast<EncryptSketchRequest::HashToCurveMethod>(
+          data[kHashToCurveMethodOffset]);
+  header.ciphertexts_per_register =
+      static_cast<int>(Load32(data + kCiphertextsPerRegisterOffset));
+  header.registers_per_block =
+      static_cast<int>(Load32(data + kRegistersPerBlockOffset));
+  header.register_count = Load64(data + kRegisterCountOffset);
+  if (absl::Status status = ValidateHeader(header); !status.ok()) {
+    return absl::DataLossError(absl::StrCat(
+        "Invalid framed ciphertext header: ", status.message()));
+  }
+  return header;
+}
+
+absl::StatusOr<std::string> UnframeCiphertexts(absl::string_view framed,
+                                               int thread_count) {
+  ASSIGN_OR_RETURN(CiphertextFrameHeader header,
+                   ParseCiphertextFrameHeader(framed));
+  const Layout layout(header);
+  const uint64_t register_count = header.register_count;
+  // Every register takes at least the bytes of its x coordinates. Bounding the
+  // register count by them before anything is multiplied by it bounds the
+  // framed and the concatenated sizes by a small multiple of framed.size(), so
+  // neither can wrap around.
+  const uint64_t min_register_bytes =
+      layout.points_per_register * (layout.point_bytes - 1);
+  if (register_count > framed.size() / min_register_bytes ||
+      framed.size() != layout.FramedBytes(register_count)) {
+    return absl::DataLossError(absl::StrCat(
+        "The framed sketch has ", framed.size(), " bytes, which does not ",
+        "match its ", register_count, " registers."));
+  }
+
+  std::string encrypted_sketch(register_count * layout.register_bytes, '\0');
+  auto unframe_blocks = [&](int64_t begin, int64_t end) -> absl::Status {
+    for (int64_t block_index = begin; block_index < end; ++block_index) {
+      const uint64_t first_register =
+          static_cast<uint64_t>(block_index) * layout.registers_per_block;
+      const uint64_t registers = std::min(layout.registers_per_block,
+                                          register_count - first_register);
+      const char* block =
+          framed.data() + kHeaderSize +
+          static_cast<uint64_t>(block_index) * layout.full_block_bytes;
+      if (Load32(block) != registers) {
+        return absl::DataLossError(
+            absl::StrCat("Block ", block_index, " has ", Load32(block),
+                         " registers instead of ", registers, "."));
+      }
+      const uint64_t points = registers * layout.points_per_register;
+      const char* signs = block + kBlockHeaderSize;
+      const char* x = signs + (points + 7) / 8;
+      char* point =
+          encrypted_sketch.data() + first_register * layout.register_bytes;
+      for (uint64_t i = 0; i < points; ++i) {
+        point[0] = (signs[i / 8] >> (i % 8)) & 1 ? kOddY : kEvenY;
+        std::memcpy(point + 1, x, layout.point_bytes - 1);
+        x += layout.point_bytes - 1;
+        point += layout.point_bytes;
+      }
+    }
+    return absl::OkStatus();
+  };
+  RETURN_IF_ERROR(ForEachSlice(
+      thread_count, layout.BlockCount(register_count), unframe_blocks));
+  return encrypted_sketch;
+}
+
+}  // namespace wfa::any_sketch::crypto
@@ -0,0 +1,94 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_CRYPTO_CIPHERTEXT_FRAMING_H_
+#define SRC_MAIN_CC_ANY_SKETCH_CRYPTO_CIPHERTEXT_FRAMING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+
+// The FRAMED_V1 ciphertext format, a compact encoding of the concatenated
+// ciphertexts that SketchEncrypter emits.
+//
+// Each ciphertext of the concatenated format is two compressed points, and
+// each compressed point is a byte 0x02 or 0x03 for the sign of y followed by
+// x. The x coordinates are uniformly random, so the only redundancy is that
+// sign byte: the framed format packs the signs of all points into bitmaps, two
+// bits per ciphertext, which makes a P-256 ciphertext 64.25 bytes instead of
+// 66.
+//
+// A framed sketch is a 24-byte header followed by blocks of
+// registers_per_block registers, the last of which may be shorter:
+//
+//   header: "WFAC", version, point size, destroyed register strategy and
+//           hash to curve method as one byte each, then ciphertexts per
+//           register and registers per block as 32-bit and the register count
+//           as 64-bit little-endian integers.
+//   block:  the register count of the block as a 32-bit little-endian integer,
+//           the bitmap of the signs of its points, least significant bit
+//           first and padded to a whole byte, and the x coordinates of its
+//           points in order.
+//
+// Every block but the last has the same size, so the offset of each block
+// follows from the header and blocks can be decoded in parallel. The register
+// count of each block makes them self-delimiting when streamed.
+namespace wfa::any_sketch::crypto {
+
+struct CiphertextFrameHeader {
+  // Bytes of a compressed point, 33 on P-256.
+  int point_bytes = 33;
+  // Ciphertexts of each register: its index and its values. At most 2^16.
+  int ciphertexts_per_register = 0;
+  // At most 2^20.
+  int registers_per_block = 1024;
+  // Set by FrameCiphertexts from the size of the encrypted sketch.
+  uint64_t register_count = 0;
+  // How the sketch was encrypted, for the decrypter.
+  EncryptSketchRequest::DestroyedRegisterStrategy destroyed_register_strategy =
+      EncryptSketchRequest::UNSPECIFIED;
+  EncryptSketchRequest::HashToCurveMethod hash_to_curve_method =
+      EncryptSketchRequest::TRY_AND_INCREMENT;
+};
+
+// Returns `encrypted_sketch`, concatenated ciphertexts of registers of
+// header.ciphertexts_per_register ciphertexts each, in the framed format.
+// Returns INVALID_ARGUMENT if the size is not a whole number of registers or a
+// point is not compressed.
+absl::StatusOr<std::string> FrameCiphertexts(
+    absl::string_view encrypted_sketch, const CiphertextFrameHeader& header);
+
+// Returns whether `encrypted_sketch` is framed rather than concatenated. The
+// concatenated format starts with the sign byte of a point, which is never the
+// first byte of the header.
+bool IsFramedCiphertexts(absl::string_view encrypted_sketch);
+
+// Returns the header of the framed sketch `framed`, or INVALID_ARGUMENT if it
+// is not framed or has an unsupported version, or DATA_LOSS if its counts are
+// out of range.
+absl::StatusOr<CiphertextFrameHeader> ParseCiphertextFrameHeader(
+    absl::string_view framed);
+
+// Returns the concatenated ciphertexts of the framed sketch `framed`, whose
+// blocks are decoded by `thread_count` threads. Returns DATA_LOSS if its size
+// does not match its header or a block has the wrong register count.
+absl::StatusOr<std::string> UnframeCiphertexts(absl::string_view framed,
+                                               int thread_count = 1);
+
+}  // namespace wfa::any_sketch::crypto
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_CRYPTO_CIPHERTEXT_FRAMING_H_
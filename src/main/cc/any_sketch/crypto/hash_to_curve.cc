@@ -0,0 +1,270 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/hash_to_curve.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "common_cpp/macros/macros.h"
+#include "openssl/obj_mac.h"
+#include "private_join_and_compute/crypto/big_num.h"
+
+namespace wfa::any_sketch::crypto {
+
+namespace {
+using ::private_join_and_compute::BigNum;
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+
+// The field modulus and curve coefficient B of P-256. A is -3.
+constexpr absl::string_view kP256P =
+    "ffffffff00000001000000000000000000000000ffffffffffffffffffffffff";
+constexpr absl::string_view kP256B =
+    "5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b";
+// Z of the P256_XMD:SHA-256_SSWU_RO_ suite is -10.
+constexpr uint64_t kMinusZ = 10;
+// Bytes of each field element of hash_to_field: L = ceil((256 + 128) / 8).
+constexpr int kFieldElementBytes = 48;
+// hash_to_curve expands a plaintext to two field elements.
+constexpr int kExpandedBytes = 2 * kFieldElementBytes;
+constexpr int kSha256Bytes = 32;
+constexpr int kSha256BlockBytes = 64;
+
+// expand_message_xmd of RFC 9380 with SHA-256, for kExpandedBytes bytes.
+// `dst_prime` is the domain separation tag followed by its length byte.
+std::string ExpandMessageXmd(Context& ctx, absl::string_view message,
+                             absl::string_view dst_prime) {
+  static_assert(kExpandedBytes < 256 * kSha256Bytes);
+  const char expanded_length[] = {0, kExpandedBytes, 0};
+  const std::string b_0 = ctx.Sha256String(
+      absl::StrCat(std::string(kSha256BlockBytes, '\0'), message,
+                   absl::string_view(expanded_length, 3), dst_prime));
+  std::string uniform_bytes;
+  uniform_bytes.reserve(kExpandedBytes + kSha256Bytes);
+  std::string b_i = ctx.Sha256String(
+      absl::StrCat(b_0, absl::string_view("\x01", 1), dst_prime));
+  uniform_bytes.append(b_i);
+  for (char i = 2; uniform_bytes.size() < kExpandedBytes; ++i) {
+    for (int j = 0; j < kSha256Bytes; ++j) b_i[j] ^= b_0[j];
+    b_i = ctx.Sha256String(
+        absl::StrCat(b_i, absl::string_view(&i, 1), dst_prime));
+    uniform_bytes.append(b_i);
+  }
+  uniform_bytes.resize(kExpandedBytes);
+  return uniform_bytes;
+}
+
+}  // namespace
+
+struct HashToCurve::SswuParameters {
+  BigNum p;
+  BigNum a;
+  BigNum b;
+  BigNum z;
+  BigNum one;
+  BigNum zero;
+  // (p + 1) / 4, the exponent of square roots since p = 3 mod 4.
+  BigNum sqrt_exponent;
+  // sqrt(-Z)^3, which maps the square root of -g(x1) to that of g(x2).
+  BigNum sqrt_minus_z_cubed;
+  // -B / A and B / (Z * A), the x1 of non-exceptional and exceptional inputs.
+  BigNum minus_b_over_a;
+  BigNum b_over_za;
+  // The domain separation tag followed by its length.
+  std::string dst_prime;
+};
+
+absl::StatusOr<HashToCurve> HashToCurve::Create(HashToCurveMethod method,
+                                                int curve_id,
+                                                const ECGroup* ec_group,
+                                                Context* ctx) {
+  switch (method) {
+    case EncryptSketchRequest::TRY_AND_INCREMENT:
+      return HashToCurve(method, ec_group, ctx, nullptr);
+    case EncryptSketchRequest::SSWU_V1:
+      return CreateSswu(curve_id, kSswuV1DomainSeparationTag, ec_group, ctx);
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid HashToCurveMethod: ", method));
+  }
+}
+
+absl::StatusOr<HashToCurve> HashToCurve::CreateSswu(
+    int curve_id, absl::string_view domain_separation_tag,
+    const ECGroup* ec_group, Context* ctx) {
+  if (curve_id != NID_X9_62_prime256v1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The SSWU hash to curve is only supported on P-256, not curve ",
+        curve_id));
+  }
+  if (domain_separation_tag.empty() || domain_separation_tag.size() > 255) {
+    return absl::InvalidArgumentError(
+        "The domain separation tag should have 1 to 255 bytes.");
+  }
+
+  const BigNum p = ctx->CreateBigNum(absl::HexStringToBytes(kP256P));
+  const BigNum b = ctx->CreateBigNum(absl::HexStringToBytes(kP256B));
+  const BigNum a = p.Sub(ctx->CreateBigNum(3));
+  const BigNum z = p.Sub(ctx->CreateBigNum(kMinusZ));
+  const BigNum sqrt_exponent = p.Add(ctx->One()).Rshift(2);
+  const BigNum sqrt_minus_z =
+      ctx->CreateBigNum(kMinusZ).ModExp(sqrt_exponent, p);
+  ASSIGN_OR_RETURN(BigNum a_inverse, a.ModInverse(p));
+  ASSIGN_OR_RETURN(BigNum za_inverse, z.ModMul(a, p).ModInverse(p));
+
+  auto sswu = std::make_unique<const SswuParameters>(SswuParameters{
+      .p = p,
+      .a = a,
+      .b = b,
+      .z = z,
+      .one = ctx->One(),
+      .zero = ctx->Zero(),
+      .sqrt_exponent = sqrt_exponent,
+      .sqrt_minus_z_cubed =
+          sqrt_minus_z.ModMul(sqrt_minus_z, p).ModMul(sqrt_minus_z, p),
+      .minus_b_over_a = p.Sub(b).ModMul(a_inverse, p),
+      .b_over_za = b.ModMul(za_inverse, p),
+      .dst_prime = absl::StrCat(
+          domain_separation_tag,
+          std::string(1, static_cast<char>(domain_separation_tag.size()))),
+  });
+  return HashToCurve(EncryptSketchRequest::SSWU_V1, ec_group, ctx,
+                     std::move(sswu));
+}
+
+HashToCurve::HashToCurve(HashToCurveMethod method, const ECGroup* ec_group,
+                         Context* ctx,
+                         std::unique_ptr<const SswuParameters> sswu)
+    : method_(method), ec_group_(ec_group), ctx_(ctx), sswu_(std::move(sswu)) {}
+
+HashToCurve::HashToCurve(HashToCurve&&) = default;
+HashToCurve& HashToCurve::operator=(HashToCurve&&) = default;
+HashToCurve::~HashToCurve() = default;
+
+absl::StatusOr<ECPoint> HashToCurve::Hash(absl::string_view plaintext) const {
+  if (sswu_ == nullptr) {
+    return ec_group_->GetPointByHashingToCurveSha256(plaintext);
+  }
+  ASSIGN_OR_RETURN(std::vector<ECPoint> points,
+                   HashBatch({std::string(plaintext)}));
+  return std::move(points[0]);
+}
+
+absl::StatusOr<std::vector<ECPoint>> HashToCurve::HashBatch(
+    absl::Span<const std::string> plaintexts) const {
+  std::vector<ECPoint> points;
+  points.reserve(plaintexts.size());
+  if (sswu_ == nullptr) {
+    for (const std::string& plaintext : plaintexts) {
+      ASSIGN_OR_RETURN(ECPoint point,
+                       ec_group_->GetPointByHashingToCurveSha256(plaintext));
+      points.push_back(std::move(point));
+    }
+    return points;
+  }
+  const SswuParameters& sswu = *sswu_;
+  const BigNum& p = sswu.p;
+
+  // hash_to_field: two field elements u per plaintext, and for each the
+  // Z * u^2 and Z^2 * u^4 + Z * u^2 of the map, whose inverse x1 needs.
+  const size_t field_count = 2 * plaintexts.size();
+  std::vector<BigNum> u;
+  std::vector<BigNum> zu2;
+  std::vector<BigNum> denominators;
+  u.reserve(field_count);
+  zu2.reserve(field_count);
+  denominators.reserve(field_count);
+  for (const std::string& plaintext : plaintexts) {
+    const std::string uniform_bytes =
+        ExpandMessageXmd(*ctx_, plaintext, sswu.dst_prime);
+    for (int i = 0; i < 2; ++i) {
+      u.push_back(ctx_->CreateBigNum(absl::string_view(uniform_bytes)
+                                         .substr(i * kFieldElementBytes,
+                                                 kFieldElementBytes))
+                      .Mod(p));
+      zu2.push_back(sswu.z.ModMul(u.back().ModMul(u.back(), p), p));
+      denominators.push_back(zu2.back().ModMul(zu2.back(), p).ModAdd(
+          zu2.back(), p));
+    }
+  }
+
+  // Inverts all denominators with one inversion (Montgomery's trick): the
+  // inverse of the product of the first i + 1 denominators, times the
+  // product of the first i, is the inverse of denominator i. inv0 of RFC 9380
+  // maps 0 to 0, so zero denominators are skipped.
+  std::vector<BigNum> prefix_products;
+  prefix_products.reserve(field_count);
+  BigNum product = sswu.one;
+  for (const BigNum& denominator : denominators) {
+    if (!denominator.IsZero()) product = product.ModMul(denominator, p);
+    prefix_products.push_back(product);
+  }
+  ASSIGN_OR_RETURN(BigNum inverse, product.ModInverse(p));
+  std::vector<BigNum> inverses(field_count, sswu.zero);
+  for (size_t i = field_count; i-- > 0;) {
+    if (denominators[i].IsZero()) continue;
+    inverses[i] = i == 0 ? inverse : inverse.ModMul(prefix_products[i - 1], p);
+    inverse = inverse.ModMul(denominators[i], p);
+  }
+
+  // The simplified SWU map of each u, after which the two points of each
+  // plaintext are added. The cofactor of P-256 is 1.
+  auto map_to_curve = [&](size_t i) -> absl::StatusOr<ECPoint> {
+    auto g = [&](const BigNum& x) {
+      return x.ModMul(x, p).ModAdd(sswu.a, p).ModMul(x, p).ModAdd(sswu.b, p);
+    };
+    const BigNum x1 =
+        denominators[i].IsZero()
+            ? sswu.b_over_za
+            : sswu.minus_b_over_a.ModMul(sswu.one.ModAdd(inverses[i], p), p);
+    const BigNum gx1 = g(x1);
+    // y1^2 is g(x1) if g(x1) is a square, and -g(x1) otherwise, since -1 is
+    // not a square. g(x2) = -Z^3 * u^6 * -g(x1) then has the square root
+    // sqrt(-Z)^3 * u^3 * y1.
+    const BigNum y1 = gx1.ModExp(sswu.sqrt_exponent, p);
+    const bool gx1_is_square = y1.ModMul(y1, p) == gx1;
+    BigNum x = gx1_is_square ? x1 : zu2[i].ModMul(x1, p);
+    BigNum y = gx1_is_square ? y1
+                             : sswu.sqrt_minus_z_cubed
+                                   .ModMul(u[i].ModMul(u[i], p), p)
+                                   .ModMul(u[i], p)
+                                   .ModMul(y1, p);
+    if (u[i].IsBitSet(0) != y.IsBitSet(0)) y = y.ModNegate(p);
+    return ec_group_->CreateECPoint(x, y);
+  };
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    ASSIGN_OR_RETURN(ECPoint q0, map_to_curve(2 * i));
+    ASSIGN_OR_RETURN(ECPoint q1, map_to_curve(2 * i + 1));
+    ASSIGN_OR_RETURN(ECPoint point, q0.Add(q1));
+    points.push_back(std::move(point));
+  }
+  return points;
+}
+
+absl::StatusOr<int> CompressedPointBytes(int curve_id) {
+  Context ctx;
+  ASSIGN_OR_RETURN(ECGroup ec_group, ECGroup::Create(curve_id, &ctx));
+  ASSIGN_OR_RETURN(ECPoint generator, ec_group.GetFixedGenerator());
+  ASSIGN_OR_RETURN(std::string bytes, generator.ToBytesCompressed());
+  return static_cast<int>(bytes.size());
+}
+
+}  // namespace wfa::any_sketch::crypto
@@ -0,0 +1,105 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_CRYPTO_HASH_TO_CURVE_H_
+#define SRC_MAIN_CC_ANY_SKETCH_CRYPTO_HASH_TO_CURVE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+
+namespace wfa::any_sketch::crypto {
+
+using HashToCurveMethod = EncryptSketchRequest::HashToCurveMethod;
+
+// The domain separation tag of SSWU_V1. Changing it changes every point, so a
+// new tag needs a new HashToCurveMethod.
+inline constexpr absl::string_view kSswuV1DomainSeparationTag =
+    "WFA-ANY-SKETCH-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_";
+
+// Maps plaintexts to points of an elliptic curve with a HashToCurveMethod, as
+// the SketchEncrypter does before encrypting them.
+//
+// TRY_AND_INCREMENT hashes the plaintext with a counter until the hash is the
+// x coordinate of a point, which takes a variable number of hashes and square
+// roots. SSWU_V1 follows hash_to_curve of RFC 9380 instead: it expands the
+// plaintext to two field elements with SHA-256, maps each to the curve with
+// the simplified SWU map, and adds the two points. The map is a fixed sequence
+// of field operations with a single exponentiation and a single inversion,
+// and HashBatch shares one inversion among all the plaintexts of a batch.
+//
+// Not thread-safe, since it uses the Context it was created with.
+class HashToCurve {
+ public:
+  // Creates a HashToCurve with `method` on the curve `curve_id`, whose group
+  // is `ec_group`. Returns INVALID_ARGUMENT for SSWU_V1 on curves other than
+  // P-256. `ec_group` and `ctx` must outlive the result.
+  static absl::StatusOr<HashToCurve> Create(
+      HashToCurveMethod method, int curve_id,
+      const private_join_and_compute::ECGroup* ec_group,
+      private_join_and_compute::Context* ctx);
+
+  // Creates a P256_XMD:SHA-256_SSWU_RO_ HashToCurve with another domain
+  // separation tag, e.g. that of the RFC 9380 test vectors.
+  static absl::StatusOr<HashToCurve> CreateSswu(
+      int curve_id, absl::string_view domain_separation_tag,
+      const private_join_and_compute::ECGroup* ec_group,
+      private_join_and_compute::Context* ctx);
+
+  HashToCurve(HashToCurve&&);
+  HashToCurve& operator=(HashToCurve&&);
+  ~HashToCurve();
+
+  // Returns the point of `plaintext`.
+  absl::StatusOr<private_join_and_compute::ECPoint> Hash(
+      absl::string_view plaintext) const;
+
+  // Returns the points of `plaintexts`, in the same order.
+  absl::StatusOr<std::vector<private_join_and_compute::ECPoint>> HashBatch(
+      absl::Span<const std::string> plaintexts) const;
+
+  HashToCurveMethod method() const { return method_; }
+
+ private:
+  // The constants of the SSWU map on P-256.
+  struct SswuParameters;
+
+  HashToCurve(HashToCurveMethod method,
+              const private_join_and_compute::ECGroup* ec_group,
+              private_join_and_compute::Context* ctx,
+              std::unique_ptr<const SswuParameters> sswu);
+
+  HashToCurveMethod method_;
+  const private_join_and_compute::ECGroup* ec_group_;
+  private_join_and_compute::Context* ctx_;
+  // Null for TRY_AND_INCREMENT.
+  std::unique_ptr<const SswuParameters> sswu_;
+};
+
+// Returns the bytes of a compressed point of the curve `curve_id`, which is the
+// size of a mapped plaintext and of each half of its ciphertexts whatever the
+// encoding of the public key.
+absl::StatusOr<int> CompressedPointBytes(int curve_id);
+
+}  // namespace wfa::any_sketch::crypto
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_CRYPTO_HASH_TO_CURVE_H_
@@ -0,0 +1,79 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/identity_encryption_pool.h"
+
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "common_cpp/macros/macros.h"
+#include "private_join_and_compute/crypto/big_num.h"
+
+namespace wfa::any_sketch::crypto {
+
+using ::private_join_and_compute::BigNum;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+
+IdentityEncryptionPool::IdentityEncryptionPool(const ECGroup* ec_group,
+                                               ECPoint g, ECPoint y)
+    : ec_group_(ec_group), g_(std::move(g)), y_(std::move(y)) {}
+
+absl::StatusOr<IdentityEncryptionPool> IdentityEncryptionPool::Create(
+    const ECGroup* ec_group,
+    const std::pair<std::string, std::string>& public_key_bytes) {
+  ASSIGN_OR_RETURN_ERROR(
+      ECPoint g, ec_group->CreateECPoint(public_key_bytes.first),
+      absl::StrCat("Invalid generator: ", public_key_bytes.first));
+  ASSIGN_OR_RETURN_ERROR(
+      ECPoint y, ec_group->CreateECPoint(public_key_bytes.second),
+      absl::StrCat("Invalid element: ", public_key_bytes.second));
+  return IdentityEncryptionPool(ec_group, std::move(g), std::move(y));
+}
+
+absl::Status IdentityEncryptionPool::Precompute(int count) {
+  pool_.reserve(pool_.size() + count);
+  for (int i = 0; i < count; ++i) {
+    const BigNum s = ec_group_->GeneratePrivateKey();
+    ASSIGN_OR_RETURN(ECPoint u, g_.Mul(s));
+    ASSIGN_OR_RETURN(ECPoint e, y_.Mul(s));
+    pool_.emplace_back(std::move(u), std::move(e));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status IdentityEncryptionPool::AppendEncryptions(
+    absl::string_view plaintext, int count, std::string& ciphertexts) {
+  if (count <= 0) return absl::OkStatus();
+  ASSIGN_OR_RETURN(ECPoint m, ec_group_->CreateECPoint(plaintext));
+  if (size() < count) {
+    RETURN_IF_ERROR(Precompute(count - size()));
+  }
+  for (int i = 0; i < count; ++i) {
+    // Moved out, so that the encryption of the identity is gone even if this
+    // fails.
+    Ciphertext identity = std::move(pool_.back());
+    pool_.pop_back();
+    ASSIGN_OR_RETURN(ECPoint e, m.Add(identity.second));
+    ASSIGN_OR_RETURN(std::string u_bytes, identity.first.ToBytesCompressed());
+    ASSIGN_OR_RETURN(std::string e_bytes, e.ToBytesCompressed());
+    ciphertexts.append(u_bytes);
+    ciphertexts.append(e_bytes);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace wfa::any_sketch::crypto
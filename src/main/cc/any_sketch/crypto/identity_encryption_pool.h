@@ -0,0 +1,89 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_CRYPTO_IDENTITY_ENCRYPTION_POOL_H_
+#define SRC_MAIN_CC_ANY_SKETCH_CRYPTO_IDENTITY_ENCRYPTION_POOL_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
+
+namespace wfa::any_sketch::crypto {
+
+// A pool of ElGamal encryptions of the identity under one public key (g, y),
+// i.e. pairs (g^s, y^s) for independent uniformly random s, used to encrypt
+// the same plaintext many times.
+//
+// An encryption of a point m is m times an encryption of the identity,
+// (g^s, m * y^s), so AppendEncryptions maps m from its bytes once and then
+// only multiplies it with one encryption of the identity per ciphertext,
+// instead of decoding it again for each. The ciphertexts are exactly those of
+// independent encryptions of m, since every encryption of the identity is
+// drawn from the pool once and then discarded. Reusing one would link the
+// ciphertexts it produced, and an encryption of the identity decrypts every
+// ciphertext derived from it, so the pool is never exposed.
+//
+// The scalar multiplications of the encryptions of the identity are the bulk
+// of the cost of an encryption. Precompute moves them ahead of encryption,
+// e.g. to before the sketch is available; AppendEncryptions computes any that
+// are missing.
+//
+// Not thread-safe.
+class IdentityEncryptionPool {
+ public:
+  // Creates an empty pool for the compressed public key `public_key_bytes`,
+  // (g, y), on `ec_group`, which must outlive the result. Returns
+  // INVALID_ARGUMENT if g or y is not a point of the curve.
+  static absl::StatusOr<IdentityEncryptionPool> Create(
+      const private_join_and_compute::ECGroup* ec_group,
+      const std::pair<std::string, std::string>& public_key_bytes);
+
+  IdentityEncryptionPool(IdentityEncryptionPool&&) = default;
+  IdentityEncryptionPool& operator=(IdentityEncryptionPool&&) = default;
+
+  // Computes `count` more encryptions of the identity.
+  absl::Status Precompute(int count);
+
+  // Appends `count` independent encryptions of the compressed point
+  // `plaintext`, each the bytes of u followed by those of e, to `ciphertexts`.
+  absl::Status AppendEncryptions(absl::string_view plaintext, int count,
+                                 std::string& ciphertexts);
+
+  // Returns the number of precomputed encryptions of the identity left.
+  int size() const { return static_cast<int>(pool_.size()); }
+
+ private:
+  using Ciphertext = std::pair<private_join_and_compute::ECPoint,
+                               private_join_and_compute::ECPoint>;
+
+  IdentityEncryptionPool(const private_join_and_compute::ECGroup* ec_group,
+                         private_join_and_compute::ECPoint g,
+                         private_join_and_compute::ECPoint y);
+
+  const private_join_and_compute::ECGroup* ec_group_;
+  private_join_and_compute::ECPoint g_;
+  private_join_and_compute::ECPoint y_;
+  // Encryptions of the identity, each used once and taken from the back.
+  std::vector<Ciphertext> pool_;
+};
+
+}  // namespace wfa::any_sketch::crypto
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_CRYPTO_IDENTITY_ENCRYPTION_POOL_H_
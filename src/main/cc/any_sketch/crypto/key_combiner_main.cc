@@ -12,11 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "any_sketch/crypto/sketch_encrypter.h"
 #include "glog/logging.h"
 
@@ -25,8 +31,54 @@ ABSL_FLAG(int, curve_id, 0, "The Elliptic curve id.");
 ABSL_FLAG(std::vector<std::string>, element_list, {},
           "The list of ElGamal public key elements to combine.");
 
+ABSL_FLAG(std::string, key_sets_file, "",
+          "Path of a file of key sets to combine instead of --element_list, "
+          "one set per line as comma-separated elements. The combined "
+          "elements are written one per line, in the same order.");
+
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads combining the key sets of --key_sets_file.");
+
 using ::wfa::any_sketch::crypto::ElGamalPublicKey;
 
+namespace {
+
+// Returns the public key of hex element `y`. The generator g doesn't matter,
+// only set the y component.
+ElGamalPublicKey KeyOfElement(absl::string_view y) {
+  ElGamalPublicKey key;
+  key.set_element(absl::HexStringToBytes(y));
+  return key;
+}
+
+// Combines the key sets of the file at `path` and prints their elements.
+int CombineKeySetsFile(int curve_id, const std::string& path) {
+  std::ifstream file(path);
+  CHECK(file) << "Cannot open " << path;
+  std::vector<std::vector<ElGamalPublicKey>> key_sets;
+  for (std::string line; std::getline(file, line);) {
+    if (line.empty()) continue;
+    std::vector<ElGamalPublicKey>& keys = key_sets.emplace_back();
+    for (absl::string_view y : absl::StrSplit(line, ',')) {
+      keys.push_back(KeyOfElement(y));
+    }
+  }
+
+  const int thread_count = absl::GetFlag(FLAGS_threads);
+  std::vector<ElGamalPublicKey> results =
+      wfa::any_sketch::crypto::CombineElGamalPublicKeySets(curve_id, key_sets,
+                                                           thread_count)
+          .value();
+  std::cerr << "Combined " << results.size() << " key sets with "
+            << thread_count << " threads.\n";
+  for (const ElGamalPublicKey& result : results) {
+    std::cout << absl::BytesToHexString(result.element()) << "\n";
+  }
+  return 0;
+}
+
+}  // namespace
+
 int main(int argc, char** argv) {
   absl::ParseCommandLine(argc, argv);
 
@@ -34,14 +86,19 @@ int main(int argc, char** argv) {
   CHECK(curveId > 0) << "curveId should be greater than 0";
   std::cerr << "curveId: " << curveId << "\n";
 
+  if (const std::string path = absl::GetFlag(FLAGS_key_sets_file);
+      !path.empty()) {
+    CHECK(absl::GetFlag(FLAGS_element_list).empty())
+        << "--element_list and --key_sets_file are exclusive";
+    return CombineKeySetsFile(curveId, path);
+  }
+
   std::vector<ElGamalPublicKey> keys;
 
   std::cerr << "Keys to combine:\n";
   for (const std::string& y : absl::GetFlag(FLAGS_element_list)) {
     std::cerr << y << "\n";
-    keys.emplace_back();
-    // The generator g doesn't matter, only set the y component.
-    keys.back().set_element(absl::HexStringToBytes(y));
+    keys.push_back(KeyOfElement(y));
   }
 
   auto result =
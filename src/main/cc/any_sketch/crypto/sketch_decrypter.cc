@@ -0,0 +1,373 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/sketch_decrypter.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "any_sketch/crypto/ciphertext_framing.h"
+#include "any_sketch/crypto/hash_to_curve.h"
+#include "any_sketch/util.h"
+#include "common_cpp/macros/macros.h"
+#include "private_join_and_compute/crypto/commutative_elgamal.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+
+namespace wfa::any_sketch::crypto {
+
+namespace {
+using ::private_join_and_compute::CommutativeElGamal;
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+
+// The seeds of the constant points of SketchEncrypter.
+constexpr absl::string_view kUnitECPointSeed = "unit_ec_point";
+constexpr absl::string_view kDestroyedRegisterKey = "destroyed_register_key";
+constexpr absl::string_view kPublisherNoiseRegisterId =
+    "publisher_noise_register_id";
+// Integers are hashed to the curve in batches of this many.
+constexpr int64_t kHashBatchSize = 1024;
+
+// Returns the compressed points of the decimal strings of [0, size), as
+// SketchEncrypter::MapToCurve hashes integers with `method`.
+absl::StatusOr<std::vector<std::string>> HashIntegersToCurve(
+    int curve_id, HashToCurveMethod method, int64_t size, int thread_count) {
+  std::vector<std::string> points(size);
+  RETURN_IF_ERROR(ForEachSlice(
+      thread_count, size, [&](int64_t begin, int64_t end) -> absl::Status {
+        Context ctx;
+        ASSIGN_OR_RETURN(ECGroup ec_group, ECGroup::Create(curve_id, &ctx));
+        ASSIGN_OR_RETURN(
+            HashToCurve hash_to_curve,
+            HashToCurve::Create(method, curve_id, &ec_group, &ctx));
+        std::vector<std::string> batch;
+        for (int64_t batch_begin = begin; batch_begin < end;
+             batch_begin += kHashBatchSize) {
+          const int64_t batch_end = std::min(batch_begin + kHashBatchSize, end);
+          batch.clear();
+          for (int64_t i = batch_begin; i < batch_end; ++i) {
+            batch.push_back(std::to_string(i));
+          }
+          ASSIGN_OR_RETURN(std::vector<ECPoint> batch_points,
+                           hash_to_curve.HashBatch(batch));
+          for (int64_t i = batch_begin; i < batch_end; ++i) {
+            ASSIGN_OR_RETURN(points[i],
+                             batch_points[i - batch_begin].ToBytesCompressed());
+          }
+        }
+        return absl::OkStatus();
+      }));
+  return points;
+}
+
+// Returns whether the register is destroyed. See IsRegisterDestroyed in
+// sketch_encrypter.cc.
+bool IsRegisterDestroyed(const Sketch::Register& reg,
+                         const SketchConfig& config) {
+  for (int i = 0; i < reg.values_size(); ++i) {
+    if (config.values(i).aggregator() == SketchConfig::ValueSpec::UNIQUE &&
+        reg.values(i) <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+absl::StatusOr<ElGamalKeyPair> GenerateElGamalKeyPair(int curve_id) {
+  ASSIGN_OR_RETURN(std::unique_ptr<CommutativeElGamal> cipher,
+                   CommutativeElGamal::CreateWithNewKeyPair(curve_id));
+  ASSIGN_OR_RETURN(auto public_key, cipher->GetPublicKeyBytes());
+  ElGamalKeyPair key_pair;
+  ASSIGN_OR_RETURN(*key_pair.mutable_secret_key(),
+                   cipher->GetPrivateKeyBytes());
+  key_pair.mutable_public_key()->set_generator(std::move(public_key.first));
+  key_pair.mutable_public_key()->set_element(std::move(public_key.second));
+  return key_pair;
+}
+
+absl::StatusOr<std::unique_ptr<SketchDecrypter>> SketchDecrypter::Create(
+    const ElGamalKeyPair& key_pair, const SketchDecrypterOptions& options) {
+  if (options.index_count < 0 || options.max_unique_value < 0) {
+    return absl::InvalidArgumentError(
+        "index_count and max_unique_value should not be negative.");
+  }
+  if (key_pair.public_key().generator().empty()) {
+    return absl::InvalidArgumentError("The key pair has no public key.");
+  }
+  // Fails early on a key pair of another curve.
+  RETURN_IF_ERROR(CommutativeElGamal::CreateFromPublicAndPrivateKeys(
+                      options.curve_id,
+                      std::make_pair(key_pair.public_key().generator(),
+                                     key_pair.public_key().element()),
+                      key_pair.secret_key())
+                      .status());
+
+  ASSIGN_OR_RETURN(
+      std::vector<std::string> integer_points,
+      HashIntegersToCurve(
+          options.curve_id, options.hash_to_curve_method,
+          std::max(options.index_count, options.max_unique_value + 1),
+          options.thread_count));
+
+  absl::flat_hash_map<std::string, Plaintext> plaintexts;
+  plaintexts.reserve(integer_points.size() + options.max_counter_value + 3);
+  for (size_t i = 0; i < integer_points.size(); ++i) {
+    plaintexts.try_emplace(std::move(integer_points[i]),
+                           Plaintext{Plaintext::Kind::kInteger,
+                                     static_cast<int64_t>(i)});
+  }
+
+  Context ctx;
+  ASSIGN_OR_RETURN(ECGroup ec_group, ECGroup::Create(options.curve_id, &ctx));
+  ASSIGN_OR_RETURN(HashToCurve hash_to_curve,
+                   HashToCurve::Create(options.hash_to_curve_method,
+                                       options.curve_id, &ec_group, &ctx));
+  auto add_constant = [&](absl::string_view seed,
+                          Plaintext plaintext) -> absl::Status {
+    ASSIGN_OR_RETURN(ECPoint point, hash_to_curve.Hash(seed));
+    ASSIGN_OR_RETURN(std::string bytes, point.ToBytesCompressed());
+    plaintexts.try_emplace(std::move(bytes), plaintext);
+    return absl::OkStatus();
+  };
+  RETURN_IF_ERROR(add_constant(
+      kDestroyedRegisterKey, {Plaintext::Kind::kDestroyedRegisterKey, 0}));
+  RETURN_IF_ERROR(add_constant(kPublisherNoiseRegisterId,
+                               {Plaintext::Kind::kNoiseRegister, 0}));
+
+  // Count n is n times the unit point. Successive additions are much cheaper
+  // than the multiplications of the encrypter.
+  ASSIGN_OR_RETURN(ECPoint unit, hash_to_curve.Hash(kUnitECPointSeed));
+  ASSIGN_OR_RETURN(ECPoint count_point, unit.Clone());
+  for (size_t n = 1; n <= options.max_counter_value + 1; ++n) {
+    if (n > 1) {
+      ASSIGN_OR_RETURN(count_point, count_point.Add(unit));
+    }
+    ASSIGN_OR_RETURN(std::string bytes, count_point.ToBytesCompressed());
+    plaintexts.try_emplace(
+        std::move(bytes),
+        Plaintext{Plaintext::Kind::kCount, static_cast<int64_t>(n)});
+  }
+
+  // The public key may be uncompressed, but the ciphertexts are always made of
+  // compressed points.
+  ASSIGN_OR_RETURN(int point_bytes, CompressedPointBytes(options.curve_id));
+  return absl::WrapUnique(new SketchDecrypter(key_pair, options, point_bytes,
+                                              std::move(plaintexts)));
+}
+
+SketchDecrypter::SketchDecrypter(
+    const ElGamalKeyPair& key_pair, const SketchDecrypterOptions& options,
+    int point_bytes, absl::flat_hash_map<std::string, Plaintext> plaintexts)
+    : key_pair_(key_pair),
+      options_(options),
+      point_bytes_(point_bytes),
+      plaintexts_(std::move(plaintexts)) {}
+
+absl::Status SketchDecrypter::DecryptPoints(
+    absl::string_view ciphertexts,
+    absl::Span<const Plaintext*> plaintexts) const {
+  // CommutativeElGamal is not thread-safe, so each slice has its own.
+  ASSIGN_OR_RETURN(std::unique_ptr<CommutativeElGamal> cipher,
+                   CommutativeElGamal::CreateFromPublicAndPrivateKeys(
+                       options_.curve_id,
+                       std::make_pair(key_pair_.public_key().generator(),
+                                      key_pair_.public_key().element()),
+                       key_pair_.secret_key()));
+  // A ciphertext is two compressed points, u and e.
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext = ciphertexts.substr(i * 2 * point_bytes_);
+    absl::StatusOr<std::string> point = cipher->Decrypt(
+        std::make_pair(std::string(ciphertext.substr(0, point_bytes_)),
+                       std::string(ciphertext.substr(point_bytes_,
+                                                     point_bytes_))));
+    if (!point.ok()) {
+      return absl::DataLossError(
+          absl::StrCat("Cannot decrypt ciphertext ", i, ": ",
+                       point.status().message()));
+    }
+    auto plaintext = plaintexts_.find(*point);
+    plaintexts[i] = plaintext == plaintexts_.end() ? nullptr
+                                                   : &plaintext->second;
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<DecryptedSketch> SketchDecrypter::Decrypt(
+    absl::string_view encrypted_sketch, const SketchConfig& config) const {
+  const size_t ciphertext_bytes = 2 * point_bytes_;
+  const int register_size = 1 + config.values_size();
+  std::string unframed;
+  if (IsFramedCiphertexts(encrypted_sketch)) {
+    ASSIGN_OR_RETURN(CiphertextFrameHeader header,
+                     ParseCiphertextFrameHeader(encrypted_sketch));
+    if (header.hash_to_curve_method != options_.hash_to_curve_method) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The sketch was encrypted with hash to curve method ",
+          header.hash_to_curve_method, " but the decrypter uses ",
+          options_.hash_to_curve_method, "."));
+    }
+    if (header.ciphertexts_per_register != register_size) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "The sketch has registers of ", header.ciphertexts_per_register,
+          " ciphertexts, but the config has ", register_size, "."));
+    }
+    ASSIGN_OR_RETURN(unframed, UnframeCiphertexts(encrypted_sketch,
+                                                  options_.thread_count));
+    encrypted_sketch = unframed;
+  }
+  if (encrypted_sketch.size() % (register_size * ciphertext_bytes) != 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The encrypted sketch has ", encrypted_sketch.size(),
+                     " bytes, which is not a whole number of registers of ",
+                     register_size, " ciphertexts of ", ciphertext_bytes,
+                     " bytes."));
+  }
+  const int64_t register_count =
+      encrypted_sketch.size() / (register_size * ciphertext_bytes);
+
+  // Decrypting is the bulk of the work, so it is split among the threads by
+  // whole registers. The registers are then assembled in order.
+  std::vector<const Plaintext*> plaintexts(register_count * register_size);
+  RETURN_IF_ERROR(ForEachSlice(
+      options_.thread_count, register_count,
+      [&](int64_t begin, int64_t end) {
+        return DecryptPoints(
+            encrypted_sketch.substr(begin * register_size * ciphertext_bytes,
+                                    (end - begin) * register_size *
+                                        ciphertext_bytes),
+            absl::MakeSpan(plaintexts)
+                .subspan(begin * register_size, (end - begin) * register_size));
+      }));
+
+  DecryptedSketch result;
+  *result.sketch.mutable_config() = config;
+  auto register_plaintexts = [&](int64_t r) {
+    return absl::MakeConstSpan(plaintexts)
+        .subspan(r * register_size, register_size);
+  };
+  const int64_t conflicting_second_count =
+      std::min<int64_t>(2, options_.max_counter_value + 1);
+  // Returns whether all values of the register are the count `n`.
+  auto has_all_counts = [&](int64_t r, int64_t n) {
+    absl::Span<const Plaintext* const> values =
+        register_plaintexts(r).subspan(1);
+    return !values.empty() &&
+           std::all_of(values.begin(), values.end(), [n](const Plaintext* p) {
+             return p != nullptr && p->kind == Plaintext::Kind::kCount &&
+                    p->value == n;
+           });
+  };
+  for (int64_t r = 0; r < register_count; ++r) {
+    absl::Span<const Plaintext* const> reg = register_plaintexts(r);
+    const Plaintext* index = reg[0];
+    if (index != nullptr && index->kind == Plaintext::Kind::kNoiseRegister) {
+      // The values of noise registers are random points.
+      ++result.noise_registers;
+      continue;
+    }
+    if (index == nullptr || index->kind != Plaintext::Kind::kInteger) {
+      return absl::DataLossError(
+          absl::StrCat("Register ", r, " has no index in [0, ",
+                       options_.index_count, ")."));
+    }
+
+    Sketch::Register* decrypted = result.sketch.add_registers();
+    decrypted->set_index(index->value);
+    absl::Span<const Plaintext* const> values = reg.subspan(1);
+    if (!values.empty() &&
+        std::all_of(values.begin(), values.end(), [](const Plaintext* p) {
+          return p != nullptr &&
+                 p->kind == Plaintext::Kind::kDestroyedRegisterKey;
+        })) {
+      ++result.flagged_registers;
+      decrypted->mutable_values()->Resize(config.values_size(), 0);
+      continue;
+    }
+    // CONFLICTING_KEYS encrypts a destroyed register as two registers with its
+    // index, whose values are all 1 and all 2 respectively, with 2 capped at
+    // max_counter_value + 1 like every count.
+    if (r + 1 < register_count && register_plaintexts(r + 1)[0] == index &&
+        has_all_counts(r, 1) &&
+        has_all_counts(r + 1, conflicting_second_count)) {
+      ++result.conflicting_registers;
+      decrypted->mutable_values()->Resize(config.values_size(), 0);
+      ++r;
+      continue;
+    }
+    for (int i = 0; i < config.values_size(); ++i) {
+      const Plaintext::Kind expected_kind =
+          config.values(i).aggregator() == SketchConfig::ValueSpec::SUM
+              ? Plaintext::Kind::kCount
+              : Plaintext::Kind::kInteger;
+      if (values[i] == nullptr || values[i]->kind != expected_kind) {
+        return absl::DataLossError(absl::StrCat(
+            "Value ", i, " of register ", r, " is not a ",
+            expected_kind == Plaintext::Kind::kCount ? "count" : "UNIQUE value",
+            " in the lookup tables."));
+      }
+      decrypted->add_values(values[i]->value);
+    }
+  }
+  return result;
+}
+
+absl::Status VerifyDecryptedSketch(const Sketch& plaintext,
+                                   const Sketch& decrypted,
+                                   size_t max_counter_value) {
+  if (plaintext.registers_size() != decrypted.registers_size()) {
+    return absl::FailedPreconditionError(
+        absl::StrCat("The plaintext has ", plaintext.registers_size(),
+                     " registers but the decryption has ",
+                     decrypted.registers_size(), "."));
+  }
+  const SketchConfig& config = plaintext.config();
+  const int64_t max_count = static_cast<int64_t>(max_counter_value) + 1;
+  for (int r = 0; r < plaintext.registers_size(); ++r) {
+    const Sketch::Register& expected = plaintext.registers(r);
+    const Sketch::Register& actual = decrypted.registers(r);
+    if (expected.index() != actual.index() ||
+        expected.values_size() != actual.values_size()) {
+      return absl::FailedPreconditionError(
+          absl::StrCat("Register ", r, " has index ", actual.index(),
+                       " rather than ", expected.index(), "."));
+    }
+    const bool destroyed = IsRegisterDestroyed(expected, config);
+    for (int i = 0; i < expected.values_size(); ++i) {
+      int64_t expected_value = 0;
+      if (!destroyed) {
+        expected_value =
+            config.values(i).aggregator() == SketchConfig::ValueSpec::SUM
+                ? std::min(expected.values(i), max_count)
+                : expected.values(i);
+      }
+      if (actual.values(i) != expected_value) {
+        return absl::FailedPreconditionError(absl::StrCat(
+            "Value ", i, " of register ", r, " with index ", expected.index(),
+            " is ", actual.values(i), " rather than ", expected_value, "."));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace wfa::any_sketch::crypto
@@ -0,0 +1,142 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_DECRYPTER_H_
+#define SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_DECRYPTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "wfa/any_sketch/crypto/el_gamal_key.pb.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch::crypto {
+
+// Returns a new ElGamal key pair on the curve `curve_id`, whose public key can
+// be passed to CreateWithPublicKey.
+absl::StatusOr<ElGamalKeyPair> GenerateElGamalKeyPair(int curve_id);
+
+struct SketchDecrypterOptions {
+  // The elliptic curve of the key pair.
+  int curve_id = 0;
+  // The max_counter_value the sketch was encrypted with. SUM values are
+  // decrypted up to max_counter_value + 1, which stands for all greater values.
+  size_t max_counter_value = 0;
+  // Register indexes are looked up in [0, index_count).
+  int64_t index_count = 0;
+  // UNIQUE values are looked up in [1, max_unique_value].
+  int64_t max_unique_value = 0;
+  // Threads building the lookup tables and decrypting ciphertexts.
+  int thread_count = 1;
+  // The method the sketch was encrypted with, i.e. the hash_to_curve_method
+  // of its EncryptSketchResponse.
+  EncryptSketchRequest::HashToCurveMethod hash_to_curve_method =
+      EncryptSketchRequest::TRY_AND_INCREMENT;
+};
+
+// The result of decrypting a sketch encrypted by a SketchEncrypter.
+struct DecryptedSketch {
+  // The registers in the order they were encrypted, with the config passed to
+  // Decrypt. Destroyed registers have all their values equal to 0, which is
+  // all the encryption keeps of them.
+  Sketch sketch;
+  // Registers of publisher noise, which are dropped from `sketch`.
+  int64_t noise_registers = 0;
+  // Registers destroyed with the FLAGGED_KEY and CONFLICTING_KEYS strategies.
+  int64_t flagged_registers = 0;
+  int64_t conflicting_registers = 0;
+};
+
+// Decrypts sketches encrypted by a SketchEncrypter with the public key of a
+// key pair, as a stand-in for the MPC workers in offline tests and
+// benchmarks.
+//
+// The encrypter maps each plaintext to a point before encrypting it: indexes
+// and UNIQUE values are hashed to the curve, and each SUM value n is n times
+// a fixed point. ElGamal decryption only recovers the points, so the
+// decrypter inverts that mapping with tables of the points of every index,
+// UNIQUE value and count in the ranges of the options. The tables are built
+// once at creation, which costs one hash to the curve per entry, and are
+// shared by the threads decrypting each sketch.
+//
+// Thread-safe.
+class SketchDecrypter {
+ public:
+  static absl::StatusOr<std::unique_ptr<SketchDecrypter>> Create(
+      const ElGamalKeyPair& key_pair, const SketchDecrypterOptions& options);
+
+  SketchDecrypter(const SketchDecrypter&) = delete;
+  SketchDecrypter& operator=(const SketchDecrypter&) = delete;
+
+  // Decrypts `encrypted_sketch`, the output of SketchEncrypter::Encrypt for a
+  // sketch with config `config`, possibly followed by noise registers from
+  // SketchEncrypter::AppendNoiseRegisters. It may also be in the framed format
+  // of ciphertext_framing.h, whose hash to curve method must be that of the
+  // options.
+  //
+  // Returns DATA_LOSS if a ciphertext cannot be decrypted with the key pair or
+  // its point is not in the tables, e.g. for an index outside of the options'
+  // range.
+  absl::StatusOr<DecryptedSketch> Decrypt(absl::string_view encrypted_sketch,
+                                          const SketchConfig& config) const;
+
+  // Returns the number of points in the lookup tables.
+  size_t lookup_table_size() const { return plaintexts_.size(); }
+
+ private:
+  // What a point stands for.
+  struct Plaintext {
+    enum class Kind { kInteger, kCount, kDestroyedRegisterKey, kNoiseRegister };
+    Kind kind;
+    int64_t value;
+  };
+
+  SketchDecrypter(const ElGamalKeyPair& key_pair,
+                  const SketchDecrypterOptions& options, int point_bytes,
+                  absl::flat_hash_map<std::string, Plaintext> plaintexts);
+
+  // Decrypts `ciphertexts`, which hold plaintexts.size() ciphertexts, and sets
+  // each plaintext to the entry of its point, or to nullptr if the point is
+  // not in the tables.
+  absl::Status DecryptPoints(absl::string_view ciphertexts,
+                             absl::Span<const Plaintext*> plaintexts) const;
+
+  const ElGamalKeyPair key_pair_;
+  const SketchDecrypterOptions options_;
+  // Bytes of a compressed point of the curve, i.e. of half a ciphertext.
+  const int point_bytes_;
+  // The plaintexts of the compressed points, for all integers and counts in
+  // the ranges of the options and the constants of the encrypter.
+  const absl::flat_hash_map<std::string, Plaintext> plaintexts_;
+};
+
+// Returns OK if `decrypted` is the decryption of an encryption of `plaintext`:
+// it has the same registers in the same order, except that destroyed
+// registers have values 0 and SUM values are capped at max_counter_value + 1.
+// Otherwise returns FAILED_PRECONDITION describing the first difference.
+absl::Status VerifyDecryptedSketch(const Sketch& plaintext,
+                                   const Sketch& decrypted,
+                                   size_t max_counter_value);
+
+}  // namespace wfa::any_sketch::crypto
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_DECRYPTER_H_
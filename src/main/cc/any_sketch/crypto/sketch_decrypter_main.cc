@@ -0,0 +1,178 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Generates ElGamal key pairs and decrypts sketches encrypted with their
+// public keys, to check encrypted sketches without the MPC workers.
+//
+// With --generate_key_pair, writes a new serialized ElGamalKeyPair and prints
+// its public key. Otherwise decrypts --encrypted_sketch with --key_pair, and
+// optionally checks the result against the plaintext --expected_sketch.
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/strings/escaping.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "any_sketch/crypto/sketch_decrypter.h"
+#include "any_sketch/sketch_spec.h"
+#include "glog/logging.h"
+#include "wfa/any_sketch/crypto/el_gamal_key.pb.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+ABSL_FLAG(int, curve_id, 0, "The Elliptic curve id.");
+ABSL_FLAG(std::string, generate_key_pair, "",
+          "Path to write a new serialized ElGamalKeyPair to.");
+ABSL_FLAG(std::string, key_pair, "",
+          "Path of the serialized ElGamalKeyPair to decrypt with.");
+ABSL_FLAG(std::string, sketch_config, "",
+          "Path of the SketchConfig of the sketch, in text format.");
+ABSL_FLAG(std::string, encrypted_sketch, "",
+          "Path of the encrypted sketch, the concatenated ciphertexts.");
+ABSL_FLAG(int64_t, index_count, 0,
+          "Register indexes are decrypted in [0, index_count).");
+ABSL_FLAG(int64_t, max_unique_value, 0,
+          "UNIQUE values are decrypted in [1, max_unique_value].");
+ABSL_FLAG(int64_t, max_counter_value, 10,
+          "The maximum_value the sketch was encrypted with.");
+ABSL_FLAG(std::string, hash_to_curve_method, "TRY_AND_INCREMENT",
+          "The EncryptSketchRequest.HashToCurveMethod the sketch was "
+          "encrypted with.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads decrypting the sketch.");
+ABSL_FLAG(std::string, expected_sketch, "",
+          "Optional path of the serialized plaintext Sketch to verify the "
+          "decryption against.");
+ABSL_FLAG(std::string, output, "",
+          "Optional path to write the decrypted serialized Sketch to.");
+
+namespace {
+
+using ::wfa::any_sketch::SerializeSketchConfigText;
+using ::wfa::any_sketch::Sketch;
+using ::wfa::any_sketch::SketchConfig;
+using ::wfa::any_sketch::crypto::DecryptedSketch;
+using ::wfa::any_sketch::crypto::ElGamalKeyPair;
+using ::wfa::any_sketch::crypto::EncryptSketchRequest;
+using ::wfa::any_sketch::crypto::GenerateElGamalKeyPair;
+using ::wfa::any_sketch::crypto::SketchDecrypter;
+using ::wfa::any_sketch::crypto::SketchDecrypterOptions;
+using ::wfa::any_sketch::crypto::VerifyDecryptedSketch;
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file) << "Cannot open " << path;
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+void WriteFile(const std::string& path, const std::string& contents) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  CHECK(file) << "Cannot open " << path;
+  file.write(contents.data(), contents.size());
+  CHECK(file.flush()) << "Cannot write " << path;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  const int curve_id = absl::GetFlag(FLAGS_curve_id);
+  CHECK(curve_id > 0) << "--curve_id should be greater than 0";
+
+  if (const std::string path = absl::GetFlag(FLAGS_generate_key_pair);
+      !path.empty()) {
+    const ElGamalKeyPair key_pair = GenerateElGamalKeyPair(curve_id).value();
+    WriteFile(path, key_pair.SerializeAsString());
+    std::cerr << "Wrote a key pair to " << path << "\nPublic key generator:\n"
+              << absl::BytesToHexString(key_pair.public_key().generator())
+              << "\nPublic key element:\n";
+    std::cout << absl::BytesToHexString(key_pair.public_key().element())
+              << std::endl;
+    return 0;
+  }
+
+  const std::string key_pair_path = absl::GetFlag(FLAGS_key_pair);
+  const std::string config_path = absl::GetFlag(FLAGS_sketch_config);
+  const std::string encrypted_path = absl::GetFlag(FLAGS_encrypted_sketch);
+  CHECK(!key_pair_path.empty()) << "--key_pair is required";
+  CHECK(!config_path.empty()) << "--sketch_config is required";
+  CHECK(!encrypted_path.empty()) << "--encrypted_sketch is required";
+
+  ElGamalKeyPair key_pair;
+  CHECK(key_pair.ParseFromString(ReadFile(key_pair_path)))
+      << "Cannot parse the ElGamalKeyPair in " << key_pair_path;
+  SketchConfig config;
+  CHECK(config.ParseFromString(
+      SerializeSketchConfigText(ReadFile(config_path)).value()));
+
+  SketchDecrypterOptions options;
+  options.curve_id = curve_id;
+  options.max_counter_value = absl::GetFlag(FLAGS_max_counter_value);
+  options.index_count = absl::GetFlag(FLAGS_index_count);
+  options.max_unique_value = absl::GetFlag(FLAGS_max_unique_value);
+  options.thread_count = absl::GetFlag(FLAGS_threads);
+  CHECK(EncryptSketchRequest::HashToCurveMethod_Parse(
+      absl::GetFlag(FLAGS_hash_to_curve_method),
+      &options.hash_to_curve_method))
+      << "Invalid --hash_to_curve_method";
+
+  absl::Time start = absl::Now();
+  const std::unique_ptr<SketchDecrypter> decrypter =
+      SketchDecrypter::Create(key_pair, options).value();
+  const absl::Duration table_duration = absl::Now() - start;
+
+  const std::string encrypted_sketch = ReadFile(encrypted_path);
+  start = absl::Now();
+  const DecryptedSketch decrypted =
+      decrypter->Decrypt(encrypted_sketch, config).value();
+  const absl::Duration decryption_duration = absl::Now() - start;
+
+  std::cerr << "Built " << decrypter->lookup_table_size()
+            << " lookup table entries in " << table_duration << ".\nDecrypted "
+            << encrypted_sketch.size() << " bytes in " << decryption_duration
+            << " with " << options.thread_count << " threads: "
+            << decrypted.sketch.registers_size() << " registers, of which "
+            << decrypted.flagged_registers + decrypted.conflicting_registers
+            << " destroyed, and " << decrypted.noise_registers
+            << " noise registers.\n";
+
+  if (const std::string path = absl::GetFlag(FLAGS_output); !path.empty()) {
+    WriteFile(path, decrypted.sketch.SerializeAsString());
+  }
+  if (const std::string path = absl::GetFlag(FLAGS_expected_sketch);
+      !path.empty()) {
+    Sketch expected;
+    CHECK(expected.ParseFromString(ReadFile(path)))
+        << "Cannot parse the Sketch in " << path;
+    if (!expected.has_config()) *expected.mutable_config() = config;
+    const absl::Status status = VerifyDecryptedSketch(
+        expected, decrypted.sketch, options.max_counter_value);
+    if (!status.ok()) {
+      std::cerr << "Verification failed: " << status << "\n";
+      return 1;
+    }
+    std::cerr << "The decryption matches " << path << ".\n";
+  }
+  return 0;
+}
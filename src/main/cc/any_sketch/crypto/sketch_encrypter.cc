@@ -14,11 +14,18 @@
 
 #include "any_sketch/crypto/sketch_encrypter.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "any_sketch/crypto/hash_to_curve.h"
+#include "any_sketch/crypto/identity_encryption_pool.h"
 #include "common_cpp/macros/macros.h"
 #include "math/distributed_discrete_gaussian_noiser.h"
 #include "math/distributed_geometric_noiser.h"
@@ -52,6 +59,29 @@ constexpr absl::string_view KDestroyedRegisterKey = "destroyed_register_key";
 // The seed for the EcPoint denoting the publisher noise register id.
 constexpr absl::string_view kPublisherNoiseRegisterId =
     "publisher_noise_register_id";
+// Register indexes are hashed to the curve in batches of this many registers,
+// which bounds the memory of a batch while sharing its field inversion.
+constexpr int kIndexBatchSize = 1024;
+
+// Adds the wall time of its scope to `*nanos`. Does nothing if `nanos` is null,
+// which is how stages are left untimed while metrics are disabled.
+class ScopedStageTimer {
+ public:
+  explicit ScopedStageTimer(int64_t* nanos)
+      : nanos_(nanos), start_(nanos == nullptr ? absl::Time() : absl::Now()) {}
+  ~ScopedStageTimer() {
+    if (nanos_ != nullptr) {
+      *nanos_ += absl::ToInt64Nanoseconds(absl::Now() - start_);
+    }
+  }
+
+  ScopedStageTimer(const ScopedStageTimer&) = delete;
+  ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+ private:
+  int64_t* nanos_;
+  absl::Time start_;
+};
 
 // Check if the sketch is valid or not.
 // A Sketch is valid if and only if all its registers contain the same number
@@ -90,6 +120,8 @@ class SketchEncrypterImpl : public SketchEncrypter {
   SketchEncrypterImpl(std::unique_ptr<CommutativeElGamal> el_gamal_cipher,
                       std::unique_ptr<Context> ctx,
                       std::unique_ptr<ECGroup> ec_group,
+                      HashToCurve hash_to_curve,
+                      IdentityEncryptionPool identity_encryption_pool,
                       size_t max_counter_value);
   ~SketchEncrypterImpl() override = default;
   SketchEncrypterImpl(SketchEncrypterImpl&& other) = delete;
@@ -106,6 +138,16 @@ class SketchEncrypterImpl : public SketchEncrypter {
           publisher_noise_parameter,
       int value_count, std::string& encrypted_sketch) override;
 
+  void EnableDeduplicatedEncryption(bool enabled) override;
+
+  absl::Status PrecomputeIdentityEncryptions(int count) override;
+
+  void EnableMetrics(bool enabled) override;
+
+  SketchEncrypterMetrics GetMetrics() override;
+
+  void ResetMetrics() override;
+
  private:
   // ElGamal cipher used to do the encryption
   std::unique_ptr<CommutativeElGamal> el_gamal_cipher_;
@@ -114,6 +156,12 @@ class SketchEncrypterImpl : public SketchEncrypter {
   std::unique_ptr<Context> ctx_;
   // The EC Group representing the curve definition.
   std::unique_ptr<ECGroup> ec_group_;
+  // Maps plaintexts to the curve, with *ec_group_ and *ctx_.
+  HashToCurve hash_to_curve_;
+  // Encrypts repeated values under the public key, with *ec_group_.
+  IdentityEncryptionPool identity_encryption_pool_;
+  // Whether repeated values are encrypted with identity_encryption_pool_.
+  bool deduplicated_encryption_enabled_ = false;
   // The max distinguishable counter value, all greater values are encrypted as
   // this max_counter_value_+1.
   size_t max_counter_value_;
@@ -128,6 +176,21 @@ class SketchEncrypterImpl : public SketchEncrypter {
   // thread safe, we use mutex to enforce thread safety in this class.
   absl::Mutex mutex_;
 
+  // Whether metrics_ is updated.
+  bool metrics_enabled_ = false;
+  SketchEncrypterMetrics metrics_;
+
+  // Returns the given stage timer of metrics_, or nullptr if metrics are
+  // disabled.
+  int64_t* StageNanos(int64_t SketchEncrypterMetrics::*stage) {
+    return metrics_enabled_ ? &(metrics_.*stage) : nullptr;
+  }
+  // Adds `delta` to the given counter of metrics_ if metrics are enabled.
+  void IncrementCounter(int64_t SketchEncrypterMetrics::*counter,
+                        int64_t delta = 1) {
+    if (metrics_enabled_) metrics_.*counter += delta;
+  }
+
   // Append an encrypted register with all values equal to a provided number
   // to the sketch.
   absl::Status AppendEncryptedRegisterWithSameValue(
@@ -141,21 +204,29 @@ class SketchEncrypterImpl : public SketchEncrypter {
   // Encrypt a destroyed register by inserting a pair of registers with the
   // same actual index but different values.
   absl::Status EncryptDestroyedRegister(
-      const Sketch::Register& reg,
+      const Sketch::Register& reg, absl::string_view index_ec,
       DestroyedRegisterStrategy destroyed_register_strategy,
       std::string& encrypted_sketch);
   // Encrypt a non-destroyed register according to the exact values.
   absl::Status EncryptNonDestroyedRegister(const Sketch::Register& reg,
+                                           absl::string_view index_ec,
                                            const SketchConfig& sketch_config,
                                            std::string& encrypted_sketch);
-  // Encrypt a Register and append the result to the encrypted_sketch.
+  // Encrypt a Register, whose index maps to `index_ec`, and append the result
+  // to the encrypted_sketch.
   absl::Status EncryptAdditionalRegister(
-      const Sketch::Register& reg, const SketchConfig& sketch_config,
+      const Sketch::Register& reg, absl::string_view index_ec,
+      const SketchConfig& sketch_config,
       DestroyedRegisterStrategy destroyed_register_strategy,
       std::string& encrypted_sketch);
   // Encrypt an ECPoint and append the result to the encrypted_sketch.
   absl::Status EncryptAdditionalECPoint(absl::string_view ec_point,
-                                        std::string& encrypted_sketch) const;
+                                        std::string& encrypted_sketch);
+  // Encrypt an ECPoint `count` times and append the results to the
+  // encrypted_sketch, with identity_encryption_pool_ if deduplicated
+  // encryption is enabled.
+  absl::Status EncryptRepeatedECPoint(absl::string_view ec_point, int count,
+                                      std::string& encrypted_sketch);
   // Lookup the corresponding ECPoint of the input integer in the map.
   // If the ECPoint doesn't exist in the map, calculate it and insert the result
   // to the map. n can not be 0 since there is no string representation of the
@@ -167,15 +238,22 @@ class SketchEncrypterImpl : public SketchEncrypter {
   // Hash a plaintext integer to the elliptical curve and return the compressed
   // bytes of the corresponding ECPoint.
   absl::StatusOr<std::string> MapToCurve(int64_t plaintext);
+  // Hash the indexes of registers [begin, end) of `sketch` to the elliptical
+  // curve in one batch and return the compressed bytes of their ECPoints.
+  absl::StatusOr<std::vector<std::string>> MapIndexesToCurve(
+      const Sketch& sketch, int begin, int end);
 };
 
 SketchEncrypterImpl::SketchEncrypterImpl(
     std::unique_ptr<CommutativeElGamal> el_gamal_cipher,
     std::unique_ptr<Context> ctx, std::unique_ptr<ECGroup> ec_group,
+    HashToCurve hash_to_curve, IdentityEncryptionPool identity_encryption_pool,
     size_t max_counter_value)
     : el_gamal_cipher_(std::move(el_gamal_cipher)),
       ctx_(std::move(ctx)),
       ec_group_(std::move(ec_group)),
+      hash_to_curve_(std::move(hash_to_curve)),
+      identity_encryption_pool_(std::move(identity_encryption_pool)),
       max_counter_value_(max_counter_value) {}
 
 absl::StatusOr<std::string> SketchEncrypterImpl::Encrypt(
@@ -184,7 +262,13 @@ absl::StatusOr<std::string> SketchEncrypterImpl::Encrypt(
   // Lock the mutex since most of the crypto computations here are NOT
   // thread-safe.
   absl::WriterMutexLock l(&mutex_);
-  if (!ValidateSketch(sketch)) {
+  bool valid;
+  {
+    ScopedStageTimer timer(
+        StageNanos(&SketchEncrypterMetrics::validation_nanos));
+    valid = ValidateSketch(sketch);
+  }
+  if (!valid) {
     return absl::InternalError("Sketch data doesn't match the config.");
   }
   const int num_registers = sketch.registers_size();
@@ -196,9 +280,15 @@ absl::StatusOr<std::string> SketchEncrypterImpl::Encrypt(
       num_registers * register_size * kBytesPerCipherText;
   std::string encrypted_sketch;
   encrypted_sketch.reserve(total_cipher_sketch_bytes);
-  for (auto& reg : sketch.registers()) {
-    RETURN_IF_ERROR(EncryptAdditionalRegister(
-        reg, sketch.config(), destroyed_register_strategy, encrypted_sketch));
+  for (int begin = 0; begin < num_registers; begin += kIndexBatchSize) {
+    const int end = std::min(begin + kIndexBatchSize, num_registers);
+    ASSIGN_OR_RETURN(std::vector<std::string> index_ecs,
+                     MapIndexesToCurve(sketch, begin, end));
+    for (int i = begin; i < end; ++i) {
+      RETURN_IF_ERROR(EncryptAdditionalRegister(
+          sketch.registers(i), index_ecs[i - begin], sketch.config(),
+          destroyed_register_strategy, encrypted_sketch));
+    }
   }
   return encrypted_sketch;
 }
@@ -241,6 +331,7 @@ absl::Status SketchEncrypterImpl::AppendNoiseRegisters(
       noise_count * (value_count + 1) * kBytesPerCipherText;
   encrypted_sketch.reserve(encrypted_sketch.size() + noise_register_bytes);
 
+  IncrementCounter(&SketchEncrypterMetrics::noise_registers, noise_count);
   for (int64_t i = 0; i < noise_count; ++i) {
     // Add register id, a predefined constant.
     RETURN_IF_ERROR(EncryptAdditionalECPoint(publisher_noise_register_id_ec,
@@ -249,10 +340,8 @@ absl::Status SketchEncrypterImpl::AppendNoiseRegisters(
         std::string random_value_ec,
         MapToCurve(ec_group_->GeneratePrivateKey().ToDecimalString()));
     // Add a same random value 'value_count' times.
-    for (int j = 0; j < value_count; ++j) {
-      RETURN_IF_ERROR(
-          EncryptAdditionalECPoint(random_value_ec, encrypted_sketch));
-    }
+    RETURN_IF_ERROR(
+        EncryptRepeatedECPoint(random_value_ec, value_count, encrypted_sketch));
   }
 
   return absl::OkStatus();
@@ -263,10 +352,7 @@ absl::Status SketchEncrypterImpl::AppendEncryptedRegisterWithSameValue(
     std::string& encrypted_sketch) {
   RETURN_IF_ERROR(EncryptAdditionalECPoint(index_ec, encrypted_sketch));
   ASSIGN_OR_RETURN(std::string value_ec, GetECPointForInteger(n));
-  for (size_t i = 0; i < num_of_values; ++i) {
-    RETURN_IF_ERROR(EncryptAdditionalECPoint(value_ec, encrypted_sketch));
-  }
-  return absl::OkStatus();
+  return EncryptRepeatedECPoint(value_ec, num_of_values, encrypted_sketch);
 }
 
 absl::Status SketchEncrypterImpl::AppendFlaggedDestroyedRegister(
@@ -278,18 +364,14 @@ absl::Status SketchEncrypterImpl::AppendFlaggedDestroyedRegister(
     ASSIGN_OR_RETURN(destroyed_register_key_ec_,
                      MapToCurve(KDestroyedRegisterKey));
   }
-  for (size_t i = 0; i < num_of_values; ++i) {
-    RETURN_IF_ERROR(
-        EncryptAdditionalECPoint(destroyed_register_key_ec_, encrypted_sketch));
-  }
-  return absl::OkStatus();
+  return EncryptRepeatedECPoint(destroyed_register_key_ec_, num_of_values,
+                                encrypted_sketch);
 }
 
 absl::Status SketchEncrypterImpl::EncryptDestroyedRegister(
-    const Sketch::Register& reg,
+    const Sketch::Register& reg, absl::string_view index_ec,
     DestroyedRegisterStrategy destroyed_register_strategy,
     std::string& encrypted_sketch) {
-  ASSIGN_OR_RETURN(std::string index_ec, MapToCurve(reg.index()));
   switch (destroyed_register_strategy) {
     case EncryptSketchRequest::CONFLICTING_KEYS: {
       // Add two registers with the same index for a destroyed register but
@@ -314,11 +396,8 @@ absl::Status SketchEncrypterImpl::EncryptDestroyedRegister(
 }
 
 absl::Status SketchEncrypterImpl::EncryptNonDestroyedRegister(
-    const Sketch::Register& reg, const SketchConfig& sketch_config,
-    std::string& encrypted_sketch) {
-  // We encrypt the index as a string, since we don't need to do
-  // addition on it.
-  ASSIGN_OR_RETURN(std::string index_ec, MapToCurve(reg.index()));
+    const Sketch::Register& reg, absl::string_view index_ec,
+    const SketchConfig& sketch_config, std::string& encrypted_sketch) {
   RETURN_IF_ERROR(EncryptAdditionalECPoint(index_ec, encrypted_sketch));
 
   for (int i = 0; i < reg.values_size(); ++i) {
@@ -354,23 +433,57 @@ absl::Status SketchEncrypterImpl::EncryptNonDestroyedRegister(
 }
 
 absl::Status SketchEncrypterImpl::EncryptAdditionalRegister(
-    const Sketch::Register& reg, const SketchConfig& sketch_config,
+    const Sketch::Register& reg, absl::string_view index_ec,
+    const SketchConfig& sketch_config,
     DestroyedRegisterStrategy destroyed_register_strategy,
     std::string& encrypted_sketch) {
   if (IsRegisterDestroyed(reg, sketch_config)) {
-    return EncryptDestroyedRegister(reg, destroyed_register_strategy,
+    return EncryptDestroyedRegister(reg, index_ec, destroyed_register_strategy,
                                     encrypted_sketch);
   } else {
-    return EncryptNonDestroyedRegister(reg, sketch_config, encrypted_sketch);
+    return EncryptNonDestroyedRegister(reg, index_ec, sketch_config,
+                                       encrypted_sketch);
   }
 }
 
 absl::Status SketchEncrypterImpl::EncryptAdditionalECPoint(
-    absl::string_view ec_point, std::string& encrypted_sketch) const {
-  ASSIGN_OR_RETURN(BlindersCiphertext ciphertext,
-                   el_gamal_cipher_->Encrypt(ec_point));
-  encrypted_sketch.append(ciphertext.first);
-  encrypted_sketch.append(ciphertext.second);
+    absl::string_view ec_point, std::string& encrypted_sketch) {
+  BlindersCiphertext ciphertext;
+  {
+    ScopedStageTimer timer(
+        StageNanos(&SketchEncrypterMetrics::encryption_nanos));
+    ASSIGN_OR_RETURN(ciphertext, el_gamal_cipher_->Encrypt(ec_point));
+  }
+  {
+    ScopedStageTimer timer(StageNanos(&SketchEncrypterMetrics::append_nanos));
+    encrypted_sketch.append(ciphertext.first);
+    encrypted_sketch.append(ciphertext.second);
+  }
+  IncrementCounter(&SketchEncrypterMetrics::encryptions);
+  IncrementCounter(&SketchEncrypterMetrics::bytes_emitted,
+                   ciphertext.first.size() + ciphertext.second.size());
+  return absl::OkStatus();
+}
+
+absl::Status SketchEncrypterImpl::EncryptRepeatedECPoint(
+    absl::string_view ec_point, int count, std::string& encrypted_sketch) {
+  if (!deduplicated_encryption_enabled_) {
+    for (int i = 0; i < count; ++i) {
+      RETURN_IF_ERROR(EncryptAdditionalECPoint(ec_point, encrypted_sketch));
+    }
+    return absl::OkStatus();
+  }
+  const size_t initial_size = encrypted_sketch.size();
+  {
+    ScopedStageTimer timer(
+        StageNanos(&SketchEncrypterMetrics::encryption_nanos));
+    RETURN_IF_ERROR(identity_encryption_pool_.AppendEncryptions(
+        ec_point, count, encrypted_sketch));
+  }
+  IncrementCounter(&SketchEncrypterMetrics::encryptions, count);
+  IncrementCounter(&SketchEncrypterMetrics::pooled_encryptions, count);
+  IncrementCounter(&SketchEncrypterMetrics::bytes_emitted,
+                   encrypted_sketch.size() - initial_size);
   return absl::OkStatus();
 }
 
@@ -378,11 +491,13 @@ absl::StatusOr<std::string> SketchEncrypterImpl::GetECPointForInteger(
     const uint64_t n) {
   if (auto ec_point = integer_to_ec_point_map_.find(n);
       ec_point != integer_to_ec_point_map_.end()) {
+    IncrementCounter(&SketchEncrypterMetrics::ec_point_cache_hits);
     return ec_point->second;
   }
   if (n > max_counter_value_ + 1) {
     return GetECPointForInteger(max_counter_value_ + 1);
   }
+  IncrementCounter(&SketchEncrypterMetrics::ec_point_cache_misses);
   std::string ec_point_string;
   if (n == 0) {
     // There is no string representation for 0 (ECPoint At Infinity).
@@ -390,8 +505,10 @@ absl::StatusOr<std::string> SketchEncrypterImpl::GetECPointForInteger(
   } else if (n == 1) {
     ASSIGN_OR_RETURN(ec_point_string, MapToCurve(KUnitECPointSeed));
   } else {
-    ASSIGN_OR_RETURN(ECPoint ec_1, ec_group_->GetPointByHashingToCurveSha256(
-                                       KUnitECPointSeed));
+    ScopedStageTimer timer(
+        StageNanos(&SketchEncrypterMetrics::hash_to_curve_nanos));
+    IncrementCounter(&SketchEncrypterMetrics::hash_to_curve_calls);
+    ASSIGN_OR_RETURN(ECPoint ec_1, hash_to_curve_.Hash(KUnitECPointSeed));
     ASSIGN_OR_RETURN(ECPoint ec_n, ec_1.Mul(ctx_->CreateBigNum(n)));
     ASSIGN_OR_RETURN(ec_point_string, ec_n.ToBytesCompressed());
   }
@@ -402,8 +519,10 @@ absl::StatusOr<std::string> SketchEncrypterImpl::GetECPointForInteger(
 
 absl::StatusOr<std::string> SketchEncrypterImpl::MapToCurve(
     absl::string_view plaintext) {
-  ASSIGN_OR_RETURN(ECPoint ec_point,
-                   ec_group_->GetPointByHashingToCurveSha256(plaintext));
+  ScopedStageTimer timer(
+      StageNanos(&SketchEncrypterMetrics::hash_to_curve_nanos));
+  IncrementCounter(&SketchEncrypterMetrics::hash_to_curve_calls);
+  ASSIGN_OR_RETURN(ECPoint ec_point, hash_to_curve_.Hash(plaintext));
   return ec_point.ToBytesCompressed();
 }
 
@@ -411,21 +530,116 @@ absl::StatusOr<std::string> SketchEncrypterImpl::MapToCurve(int64_t plaintext) {
   return MapToCurve(std::to_string(plaintext));
 }
 
+absl::StatusOr<std::vector<std::string>>
+SketchEncrypterImpl::MapIndexesToCurve(const Sketch& sketch, int begin,
+                                       int end) {
+  ScopedStageTimer timer(
+      StageNanos(&SketchEncrypterMetrics::hash_to_curve_nanos));
+  IncrementCounter(&SketchEncrypterMetrics::hash_to_curve_calls, end - begin);
+  // We encrypt the indexes as strings, since we don't need to do addition on
+  // them.
+  std::vector<std::string> indexes;
+  indexes.reserve(end - begin);
+  for (int i = begin; i < end; ++i) {
+    indexes.push_back(std::to_string(sketch.registers(i).index()));
+  }
+  ASSIGN_OR_RETURN(std::vector<ECPoint> ec_points,
+                   hash_to_curve_.HashBatch(indexes));
+  std::vector<std::string> index_ecs;
+  index_ecs.reserve(ec_points.size());
+  for (const ECPoint& ec_point : ec_points) {
+    ASSIGN_OR_RETURN(std::string index_ec, ec_point.ToBytesCompressed());
+    index_ecs.push_back(std::move(index_ec));
+  }
+  return index_ecs;
+}
+
+void SketchEncrypterImpl::EnableDeduplicatedEncryption(bool enabled) {
+  absl::WriterMutexLock l(&mutex_);
+  deduplicated_encryption_enabled_ = enabled;
+}
+
+absl::Status SketchEncrypterImpl::PrecomputeIdentityEncryptions(int count) {
+  absl::WriterMutexLock l(&mutex_);
+  if (count < 0) {
+    return absl::InvalidArgumentError("count should not be negative.");
+  }
+  return identity_encryption_pool_.Precompute(count);
+}
+
+void SketchEncrypterImpl::EnableMetrics(bool enabled) {
+  absl::WriterMutexLock l(&mutex_);
+  metrics_enabled_ = enabled;
+}
+
+SketchEncrypterMetrics SketchEncrypterImpl::GetMetrics() {
+  absl::ReaderMutexLock l(&mutex_);
+  return metrics_;
+}
+
+void SketchEncrypterImpl::ResetMetrics() {
+  absl::WriterMutexLock l(&mutex_);
+  metrics_ = SketchEncrypterMetrics();
+}
+
+// Returns the sum of the elements of `keys`, which has at least two keys with
+// the same generator. All keys are validated and decompressed before any is
+// added, so that the additions run over points that are already parsed.
+absl::StatusOr<ElGamalPublicKey> CombineKeysOnGroup(
+    const ECGroup& ec_group, const std::vector<ElGamalPublicKey>& keys) {
+  for (size_t i = 1; i < keys.size(); i++) {
+    if (keys[i].generator() != keys[0].generator()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Generators don't match", keys[i].generator(), " vs ",
+                       keys[0].generator()));
+    }
+  }
+  std::vector<ECPoint> elements;
+  elements.reserve(keys.size());
+  for (const ElGamalPublicKey& key : keys) {
+    ASSIGN_OR_RETURN_ERROR(ECPoint element_ec,
+                           ec_group.CreateECPoint(key.element()),
+                           absl::StrCat("Invalid ECPoint: ", key.element()));
+    elements.push_back(std::move(element_ec));
+  }
+  ASSIGN_OR_RETURN(ECPoint combined_element_ec, elements[0].Clone());
+  for (size_t i = 1; i < elements.size(); i++) {
+    ASSIGN_OR_RETURN(combined_element_ec,
+                     combined_element_ec.Add(elements[i]));
+  }
+
+  ElGamalPublicKey result;
+  result.set_generator(keys[0].generator());
+  ASSIGN_OR_RETURN(*result.mutable_element(),
+                   combined_element_ec.ToBytesCompressed());
+  return result;
+}
+
 }  // namespace
 
 absl::StatusOr<std::unique_ptr<SketchEncrypter>> CreateWithPublicKey(
     int curve_id, size_t max_counter_value,
-    const CiphertextString& public_key_bytes) {
+    const CiphertextString& public_key_bytes,
+    EncryptSketchRequest::HashToCurveMethod hash_to_curve_method) {
   auto ctx = absl::make_unique<Context>();
   ASSIGN_OR_RETURN(ECGroup temp_ec_group, ECGroup::Create(curve_id, ctx.get()));
   auto ec_group = absl::make_unique<ECGroup>(std::move(temp_ec_group));
+  ASSIGN_OR_RETURN(HashToCurve hash_to_curve,
+                   HashToCurve::Create(hash_to_curve_method, curve_id,
+                                       ec_group.get(), ctx.get()));
   ASSIGN_OR_RETURN(
       auto el_gamal_cipher,
       CommutativeElGamal::CreateFromPublicKey(
           curve_id, std::make_pair(public_key_bytes.u, public_key_bytes.e)));
+  ASSIGN_OR_RETURN(
+      IdentityEncryptionPool identity_encryption_pool,
+      IdentityEncryptionPool::Create(
+          ec_group.get(),
+          std::make_pair(public_key_bytes.u, public_key_bytes.e)));
   std::unique_ptr<SketchEncrypter> result =
       absl::make_unique<SketchEncrypterImpl>(
           std::move(el_gamal_cipher), std::move(ctx), std::move(ec_group),
+          std::move(hash_to_curve), std::move(identity_encryption_pool),
           max_counter_value);
   return {std::move(result)};
 }
@@ -439,30 +653,59 @@ absl::StatusOr<ElGamalPublicKey> CombineElGamalPublicKeys(
     return keys[0];
   }
 
-  ElGamalPublicKey result;
-  result.set_generator(keys[0].generator());
-
   Context ctx;
   ASSIGN_OR_RETURN_ERROR(ECGroup ec_group, ECGroup::Create(curve_id, &ctx),
                          absl::StrCat("Invalid Curve_id: ", curve_id));
-  ASSIGN_OR_RETURN_ERROR(ECPoint combined_element_ec,
-                         ec_group.CreateECPoint(keys[0].element()),
-                         absl::StrCat("Invalid ECPoint: ", keys[0].element()));
+  return CombineKeysOnGroup(ec_group, keys);
+}
 
-  for (size_t i = 1; i < keys.size(); i++) {
-    if (keys[i].generator() != result.generator()) {
-      return absl::InvalidArgumentError(
-          absl::StrCat("Generators don't match", keys[i].generator(), " vs ",
-                       result.generator()));
+absl::StatusOr<std::vector<ElGamalPublicKey>> CombineElGamalPublicKeySets(
+    int curve_id, const std::vector<std::vector<ElGamalPublicKey>>& key_sets,
+    int thread_count) {
+  std::vector<ElGamalPublicKey> results(key_sets.size());
+  // Each thread combines the sets i with i % thread_count == thread, on a
+  // group of its own, since ECGroup is not thread-safe.
+  thread_count = static_cast<int>(
+      std::clamp<size_t>(key_sets.size(), 1, std::max(thread_count, 1)));
+  std::vector<absl::Status> statuses(thread_count);
+  auto combine_sets = [&](int thread) {
+    Context ctx;
+    absl::StatusOr<ECGroup> ec_group = ECGroup::Create(curve_id, &ctx);
+    if (!ec_group.ok()) {
+      statuses[thread] = absl::InvalidArgumentError(
+          absl::StrCat("Invalid Curve_id: ", curve_id));
+      return;
+    }
+    for (size_t i = thread; i < key_sets.size(); i += thread_count) {
+      absl::StatusOr<ElGamalPublicKey> result =
+          key_sets[i].size() < 2 ? CombineElGamalPublicKeys(curve_id,
+                                                            key_sets[i])
+                                 : CombineKeysOnGroup(*ec_group, key_sets[i]);
+      if (!result.ok()) {
+        statuses[thread] = absl::Status(
+            result.status().code(),
+            absl::StrCat("Key set ", i, ": ", result.status().message()));
+        return;
+      }
+      results[i] = *std::move(result);
+    }
+  };
+  if (thread_count == 1) {
+    combine_sets(0);
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (int i = 0; i < thread_count; ++i) {
+      threads.emplace_back(combine_sets, i);
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
     }
-    ASSIGN_OR_RETURN_ERROR(
-        ECPoint element_ec, ec_group.CreateECPoint(keys[i].element()),
-        absl::StrCat("Invalid ECPoint: ", keys[i].element()));
-    ASSIGN_OR_RETURN(combined_element_ec, combined_element_ec.Add(element_ec));
   }
-  ASSIGN_OR_RETURN(*result.mutable_element(),
-                   combined_element_ec.ToBytesCompressed());
-  return std::move(result);
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+  return results;
 }
 
 }  // namespace wfa::any_sketch::crypto
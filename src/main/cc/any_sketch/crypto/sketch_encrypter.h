@@ -15,6 +15,7 @@
 #ifndef SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_ENCRYPTER_H_
 #define SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_ENCRYPTER_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,6 +33,37 @@ struct CiphertextString {
   std::string e;  // = m * y^r
 };
 
+// Counters and cumulative per-stage wall time of a SketchEncrypter, collected
+// while metrics are enabled. See SketchEncrypter::EnableMetrics.
+struct SketchEncrypterMetrics {
+  // Lookups of the ECPoint of a count that were served from the cache.
+  int64_t ec_point_cache_hits = 0;
+  // Lookups of the ECPoint of a count that had to be computed.
+  int64_t ec_point_cache_misses = 0;
+  // Plaintexts mapped to the curve by hashing.
+  int64_t hash_to_curve_calls = 0;
+  // ElGamal encryptions, i.e. ciphertexts produced.
+  int64_t encryptions = 0;
+  // Encryptions of repeated values with the identity encryption pool, which
+  // are also counted in encryptions. See EnableDeduplicatedEncryption.
+  int64_t pooled_encryptions = 0;
+  // Bytes appended to encrypted sketches.
+  int64_t bytes_emitted = 0;
+  // Publisher noise registers appended.
+  int64_t noise_registers = 0;
+
+  // Nanoseconds spent validating sketches against their config.
+  int64_t validation_nanos = 0;
+  // Nanoseconds spent hashing plaintexts to the curve, including computing
+  // the ECPoints of counts on cache misses.
+  int64_t hash_to_curve_nanos = 0;
+  // Nanoseconds spent in ElGamal encryption, including computing the
+  // encryptions of the identity that were not precomputed.
+  int64_t encryption_nanos = 0;
+  // Nanoseconds spent appending ciphertexts to the output.
+  int64_t append_nanos = 0;
+};
+
 // Add ElGamal Encryption to plaintext sketch word by word using the same public
 // key.
 class SketchEncrypter {
@@ -55,6 +87,30 @@ class SketchEncrypter {
           publisher_noise_parameter,
       int value_count, std::string& encrypted_sketch) = 0;
 
+  // Starts or stops encrypting the repeated values of a register, i.e. the
+  // values of destroyed registers and of publisher noise registers, with an
+  // IdentityEncryptionPool: each value is mapped from its bytes once and every
+  // ciphertext is its product with a fresh encryption of the identity.
+  // Disabled by default. The ciphertexts are the same as those of independent
+  // encryptions either way.
+  virtual void EnableDeduplicatedEncryption(bool enabled) = 0;
+
+  // Computes `count` encryptions of the identity for later use by deduplicated
+  // encryption, e.g. while the sketch is being built, and so takes most of the
+  // cost of encrypting `count` repeated values off the critical path.
+  virtual absl::Status PrecomputeIdentityEncryptions(int count) = 0;
+
+  // Starts or stops collecting metrics. Collection is disabled by default, in
+  // which case no clock is read and no counter is updated.
+  virtual void EnableMetrics(bool enabled) = 0;
+
+  // Returns the metrics collected since creation or the last call to
+  // ResetMetrics.
+  virtual SketchEncrypterMetrics GetMetrics() = 0;
+
+  // Sets all collected metrics to zero.
+  virtual void ResetMetrics() = 0;
+
  protected:
   SketchEncrypter() = default;
 };
@@ -68,14 +124,26 @@ class SketchEncrypter {
 //   max_counter_value: max decipherable counter value. Greater values are
 //     encrypted as the max_counter_value.
 //   public_key_bytes: the public key of the ElGamal cipher used for encryption.
+//   hash_to_curve_method: how plaintexts are mapped to the curve. Decrypters
+//     need the same method to recognize the plaintexts.
 absl::StatusOr<std::unique_ptr<SketchEncrypter>> CreateWithPublicKey(
     int curve_id, size_t max_counter_value,
-    const CiphertextString& public_key_bytes);
+    const CiphertextString& public_key_bytes,
+    EncryptSketchRequest::HashToCurveMethod hash_to_curve_method =
+        EncryptSketchRequest::TRY_AND_INCREMENT);
 
 // Combine a vector of ElGamalPublicKeys whose contain the same generator.
 absl::StatusOr<ElGamalPublicKey> CombineElGamalPublicKeys(
     int curve_id, const std::vector<ElGamalPublicKey>& keys);
 
+// Combines each of `key_sets` as CombineElGamalPublicKeys does, and returns
+// the combined keys in the same order. The sets are split among
+// `thread_count` threads, each of which creates the curve once for all of its
+// sets. Returns the first error, prefixed with the index of its set.
+absl::StatusOr<std::vector<ElGamalPublicKey>> CombineElGamalPublicKeySets(
+    int curve_id, const std::vector<std::vector<ElGamalPublicKey>>& key_sets,
+    int thread_count = 1);
+
 }  // namespace wfa::any_sketch::crypto
 
 #endif  // SRC_MAIN_CC_ANY_SKETCH_CRYPTO_SKETCH_ENCRYPTER_H_
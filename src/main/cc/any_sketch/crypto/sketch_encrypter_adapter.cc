@@ -14,44 +14,144 @@
 
 #include "any_sketch/crypto/sketch_encrypter_adapter.h"
 
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "any_sketch/crypto/ciphertext_framing.h"
+#include "any_sketch/crypto/hash_to_curve.h"
 #include "any_sketch/crypto/sketch_encrypter.h"
+#include "any_sketch/tracing.h"
 #include "common_cpp/macros/macros.h"
+#include "glog/logging.h"
 #include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
 
 namespace wfa::any_sketch::crypto {
+namespace {
+
+// Environment variable naming the Chrome trace file of requests that are
+// traced.
+constexpr char kTraceFileEnvVar[] = "ANY_SKETCH_TRACE_FILE";
+
+std::string GetTraceFile(const EncryptSketchRequest& request) {
+  if (!request.trace()) {
+    return "";
+  }
+  const char* trace_file = std::getenv(kTraceFileEnvVar);
+  return trace_file == nullptr ? "" : trace_file;
+}
+
+absl::StatusOr<std::string> EncryptSketch(const EncryptSketchRequest& request,
+                                          Tracer& tracer) {
+  std::unique_ptr<SketchEncrypter> sketch_encrypter;
+  {
+    ScopedTraceSpan span(tracer, "EncryptSketch/CreateWithPublicKey");
+    span.AddArg("curve_id", request.curve_id());
+    ASSIGN_OR_RETURN(sketch_encrypter,
+                     CreateWithPublicKey(
+                         request.curve_id(), request.maximum_value(),
+                         {.u = request.el_gamal_keys().generator(),
+                          .e = request.el_gamal_keys().element()},
+                         request.hash_to_curve_method()));
+    sketch_encrypter->EnableDeduplicatedEncryption(
+        request.deduplicate_repeated_values());
+  }
+
+  EncryptSketchResponse response;
+  response.set_hash_to_curve_method(request.hash_to_curve_method());
+  {
+    ScopedTraceSpan span(tracer, "EncryptSketch/Encrypt");
+    span.AddArg("register_count", request.sketch().registers_size());
+    span.AddArg("value_count", request.sketch().config().values_size());
+    ASSIGN_OR_RETURN(
+        *response.mutable_encrypted_sketch(),
+        sketch_encrypter->Encrypt(request.sketch(),
+                                  request.destroyed_register_strategy()));
+    span.AddArg("encrypted_bytes", response.encrypted_sketch().size());
+  }
+
+  if (request.has_noise_parameter()) {
+    ScopedTraceSpan span(tracer, "EncryptSketch/AppendNoiseRegisters");
+    span.AddArg("publisher_count", request.noise_parameter().publisher_count());
+    const int64_t encrypted_bytes = response.encrypted_sketch().size();
+    RETURN_IF_ERROR(sketch_encrypter->AppendNoiseRegisters(
+        request.noise_parameter(), request.sketch().config().values_size(),
+        *response.mutable_encrypted_sketch()));
+    span.AddArg("noise_bytes",
+                response.encrypted_sketch().size() - encrypted_bytes);
+  }
+
+  switch (request.ciphertext_format()) {
+    case EncryptSketchRequest::CONCATENATED:
+      break;
+    case EncryptSketchRequest::FRAMED_V1: {
+      ScopedTraceSpan span(tracer, "EncryptSketch/FrameCiphertexts");
+      CiphertextFrameHeader header;
+      ASSIGN_OR_RETURN(header.point_bytes,
+                       CompressedPointBytes(request.curve_id()));
+      header.ciphertexts_per_register =
+          1 + request.sketch().config().values_size();
+      header.destroyed_register_strategy =
+          request.destroyed_register_strategy();
+      header.hash_to_curve_method = request.hash_to_curve_method();
+      ASSIGN_OR_RETURN(
+          std::string framed,
+          FrameCiphertexts(response.encrypted_sketch(), header));
+      span.AddArg("framed_bytes", framed.size());
+      *response.mutable_encrypted_sketch() = std::move(framed);
+      break;
+    }
+    default:
+      return absl::InvalidArgumentError("Invalid CiphertextFormat.");
+  }
+  response.set_ciphertext_format(request.ciphertext_format());
+
+  ScopedTraceSpan span(tracer, "EncryptSketch/SerializeResponse");
+  std::string serialized_response = response.SerializeAsString();
+  span.AddArg("response_bytes", serialized_response.size());
+  return serialized_response;
+}
+
+}  // namespace
 
 absl::StatusOr<std::string> EncryptSketch(
     const std::string& serialized_request) {
+  const absl::Time start = absl::Now();
   EncryptSketchRequest request_proto;
   if (!request_proto.ParseFromString(serialized_request)) {
     return absl::InvalidArgumentError(
         "failed to parse the EncryptSketchRequest proto.");
   }
-  ASSIGN_OR_RETURN(auto sketch_encrypter,
-                   CreateWithPublicKey(
-                       request_proto.curve_id(), request_proto.maximum_value(),
-                       {.u = request_proto.el_gamal_keys().generator(),
-                        .e = request_proto.el_gamal_keys().element()}));
 
-  EncryptSketchResponse response;
-  ASSIGN_OR_RETURN(
-      *response.mutable_encrypted_sketch(),
-      sketch_encrypter->Encrypt(request_proto.sketch(),
-                                request_proto.destroyed_register_strategy()));
+  // Whether to write a trace file comes from the request, so the parse span is
+  // recorded once the request is available.
+  Tracer tracer(GetTraceFile(request_proto));
+  if (tracer.enabled()) {
+    tracer.Record({.name = "EncryptSketch/ParseRequest",
+                   .start = start,
+                   .duration = absl::Now() - start,
+                   .args = {{"request_bytes", serialized_request.size()}}});
+  }
 
-  if (request_proto.has_noise_parameter()) {
-    RETURN_IF_ERROR(sketch_encrypter->AppendNoiseRegisters(
-        request_proto.noise_parameter(),
-        request_proto.sketch().config().values_size(),
-        *response.mutable_encrypted_sketch()));
+  absl::StatusOr<std::string> response = EncryptSketch(request_proto, tracer);
+
+  if (tracer.enabled()) {
+    tracer.Record({.name = "EncryptSketch",
+                   .start = start,
+                   .duration = absl::Now() - start,
+                   .args = {{"ok", response.ok()}}});
+    if (absl::Status status = tracer.Flush(); !status.ok()) {
+      LOG(WARNING) << "Failed to write the EncryptSketch trace: " << status;
+    }
   }
-  return response.SerializeAsString();
+  return response;
 }
 
 absl::StatusOr<std::string> CombineElGamalPublicKeys(
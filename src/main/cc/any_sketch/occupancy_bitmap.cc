@@ -0,0 +1,291 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/occupancy_bitmap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "absl/numeric/bits.h"
+#include "any_sketch/any_sketch.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+constexpr int kChunkBits = 16;
+constexpr uint64_t kLowMask = (uint64_t{1} << kChunkBits) - 1;
+constexpr size_t kBitsetWords = (size_t{1} << kChunkBits) / 64;
+// The largest array, above which a bitset is smaller.
+constexpr size_t kMaxArraySize = 4096;
+
+bool TestBit(const std::vector<uint64_t>& bits, uint16_t low) {
+  return (bits[low / 64] >> (low % 64)) & 1;
+}
+
+std::vector<uint64_t> ToBitset(const std::vector<uint16_t>& array) {
+  std::vector<uint64_t> bits(kBitsetWords);
+  for (uint16_t low : array) bits[low / 64] |= uint64_t{1} << (low % 64);
+  return bits;
+}
+
+std::vector<uint16_t> ToArray(const std::vector<uint64_t>& bits,
+                              size_t cardinality) {
+  std::vector<uint16_t> array;
+  array.reserve(cardinality);
+  for (size_t i = 0; i < bits.size(); ++i) {
+    for (uint64_t word = bits[i]; word != 0; word &= word - 1) {
+      array.push_back(i * 64 + absl::countr_zero(word));
+    }
+  }
+  return array;
+}
+
+size_t Popcount(const std::vector<uint64_t>& bits) {
+  size_t count = 0;
+  for (uint64_t word : bits) count += absl::popcount(word);
+  return count;
+}
+
+}  // namespace
+
+OccupancyBitmap OccupancyBitmap::FromSketch(const AnySketch& sketch) {
+  std::vector<uint64_t> indexes;
+  indexes.reserve(sketch.register_count());
+  for (const AnySketch::Register& sketch_register : sketch) {
+    indexes.push_back(sketch_register.index);
+  }
+  return FromIndexes(std::move(indexes));
+}
+
+OccupancyBitmap OccupancyBitmap::FromIndexes(std::vector<uint64_t> indexes) {
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+  OccupancyBitmap bitmap;
+  for (auto it = indexes.begin(); it != indexes.end();) {
+    const uint64_t key = *it >> kChunkBits;
+    Chunk chunk{.key = key, .cardinality = 0};
+    for (; it != indexes.end() && *it >> kChunkBits == key; ++it) {
+      chunk.array.push_back(*it & kLowMask);
+    }
+    chunk.cardinality = chunk.array.size();
+    if (chunk.cardinality > kMaxArraySize) {
+      chunk.bits = ToBitset(chunk.array);
+      chunk.array = {};
+    }
+    bitmap.chunks_.push_back(std::move(chunk));
+  }
+  return bitmap;
+}
+
+OccupancyBitmap::Chunk OccupancyBitmap::AndChunks(const Chunk& a,
+                                                  const Chunk& b) {
+  Chunk result{.key = a.key, .cardinality = 0};
+  if (a.is_bitset() && b.is_bitset()) {
+    result.bits.resize(kBitsetWords);
+    for (size_t i = 0; i < kBitsetWords; ++i) {
+      result.bits[i] = a.bits[i] & b.bits[i];
+    }
+    result.cardinality = Popcount(result.bits);
+    if (result.cardinality <= kMaxArraySize) {
+      result.array = ToArray(result.bits, result.cardinality);
+      result.bits = {};
+    }
+    return result;
+  }
+  if (a.is_bitset() || b.is_bitset()) {
+    const Chunk& array = a.is_bitset() ? b : a;
+    const Chunk& bitset = a.is_bitset() ? a : b;
+    for (uint16_t low : array.array) {
+      if (TestBit(bitset.bits, low)) result.array.push_back(low);
+    }
+  } else {
+    std::set_intersection(a.array.begin(), a.array.end(), b.array.begin(),
+                          b.array.end(), std::back_inserter(result.array));
+  }
+  result.cardinality = result.array.size();
+  return result;
+}
+
+OccupancyBitmap::Chunk OccupancyBitmap::OrChunks(const Chunk& a,
+                                                 const Chunk& b) {
+  Chunk result{.key = a.key, .cardinality = 0};
+  if (a.is_bitset() && b.is_bitset()) {
+    result.bits.resize(kBitsetWords);
+    for (size_t i = 0; i < kBitsetWords; ++i) {
+      result.bits[i] = a.bits[i] | b.bits[i];
+    }
+    result.cardinality = Popcount(result.bits);
+    return result;
+  }
+  if (a.is_bitset() || b.is_bitset()) {
+    const Chunk& array = a.is_bitset() ? b : a;
+    const Chunk& bitset = a.is_bitset() ? a : b;
+    result.bits = bitset.bits;
+    result.cardinality = bitset.cardinality;
+    for (uint16_t low : array.array) {
+      if (!TestBit(result.bits, low)) {
+        result.bits[low / 64] |= uint64_t{1} << (low % 64);
+        ++result.cardinality;
+      }
+    }
+    return result;
+  }
+  std::set_union(a.array.begin(), a.array.end(), b.array.begin(),
+                 b.array.end(), std::back_inserter(result.array));
+  result.cardinality = result.array.size();
+  if (result.cardinality > kMaxArraySize) {
+    result.bits = ToBitset(result.array);
+    result.array = {};
+  }
+  return result;
+}
+
+size_t OccupancyBitmap::AndChunksCardinality(const Chunk& a, const Chunk& b) {
+  size_t count = 0;
+  if (a.is_bitset() && b.is_bitset()) {
+    for (size_t i = 0; i < kBitsetWords; ++i) {
+      count += absl::popcount(a.bits[i] & b.bits[i]);
+    }
+  } else if (a.is_bitset() || b.is_bitset()) {
+    const Chunk& array = a.is_bitset() ? b : a;
+    const Chunk& bitset = a.is_bitset() ? a : b;
+    for (uint16_t low : array.array) count += TestBit(bitset.bits, low);
+  } else {
+    // Branch-free, since which side advances is unpredictable.
+    const uint16_t* i = a.array.data();
+    const uint16_t* j = b.array.data();
+    const uint16_t* const i_end = i + a.array.size();
+    const uint16_t* const j_end = j + b.array.size();
+    while (i != i_end && j != j_end) {
+      const uint16_t x = *i;
+      const uint16_t y = *j;
+      count += x == y;
+      i += x <= y;
+      j += y <= x;
+    }
+  }
+  return count;
+}
+
+OccupancyBitmap OccupancyBitmap::And(const OccupancyBitmap& a,
+                                     const OccupancyBitmap& b) {
+  OccupancyBitmap result;
+  auto i = a.chunks_.begin();
+  auto j = b.chunks_.begin();
+  while (i != a.chunks_.end() && j != b.chunks_.end()) {
+    if (i->key < j->key) {
+      ++i;
+    } else if (j->key < i->key) {
+      ++j;
+    } else {
+      Chunk chunk = AndChunks(*i++, *j++);
+      if (chunk.cardinality > 0) result.chunks_.push_back(std::move(chunk));
+    }
+  }
+  return result;
+}
+
+OccupancyBitmap OccupancyBitmap::Or(const OccupancyBitmap& a,
+                                    const OccupancyBitmap& b) {
+  OccupancyBitmap result;
+  auto i = a.chunks_.begin();
+  auto j = b.chunks_.begin();
+  while (i != a.chunks_.end() || j != b.chunks_.end()) {
+    if (j == b.chunks_.end() || (i != a.chunks_.end() && i->key < j->key)) {
+      result.chunks_.push_back(*i++);
+    } else if (i == a.chunks_.end() || j->key < i->key) {
+      result.chunks_.push_back(*j++);
+    } else {
+      result.chunks_.push_back(OrChunks(*i++, *j++));
+    }
+  }
+  return result;
+}
+
+size_t OccupancyBitmap::AndCardinality(const OccupancyBitmap& a,
+                                       const OccupancyBitmap& b) {
+  size_t count = 0;
+  auto i = a.chunks_.begin();
+  auto j = b.chunks_.begin();
+  while (i != a.chunks_.end() && j != b.chunks_.end()) {
+    if (i->key < j->key) {
+      ++i;
+    } else if (j->key < i->key) {
+      ++j;
+    } else {
+      count += AndChunksCardinality(*i++, *j++);
+    }
+  }
+  return count;
+}
+
+bool OccupancyBitmap::Contains(uint64_t index) const {
+  const uint64_t key = index >> kChunkBits;
+  auto chunk = std::lower_bound(
+      chunks_.begin(), chunks_.end(), key,
+      [](const Chunk& chunk, uint64_t key) { return chunk.key < key; });
+  if (chunk == chunks_.end() || chunk->key != key) return false;
+  const uint16_t low = index & kLowMask;
+  if (chunk->is_bitset()) return TestBit(chunk->bits, low);
+  return std::binary_search(chunk->array.begin(), chunk->array.end(), low);
+}
+
+size_t OccupancyBitmap::cardinality() const {
+  size_t count = 0;
+  for (const Chunk& chunk : chunks_) count += chunk.cardinality;
+  return count;
+}
+
+void OccupancyBitmap::ForEach(absl::FunctionRef<void(uint64_t)> fn) const {
+  for (const Chunk& chunk : chunks_) {
+    const uint64_t base = chunk.key << kChunkBits;
+    if (chunk.is_bitset()) {
+      for (size_t i = 0; i < kBitsetWords; ++i) {
+        for (uint64_t word = chunk.bits[i]; word != 0; word &= word - 1) {
+          fn(base + i * 64 + absl::countr_zero(word));
+        }
+      }
+    } else {
+      for (uint16_t low : chunk.array) fn(base + low);
+    }
+  }
+}
+
+size_t OccupancyBitmap::memory_bytes() const {
+  size_t bytes = chunks_.capacity() * sizeof(Chunk);
+  for (const Chunk& chunk : chunks_) {
+    bytes += chunk.array.capacity() * sizeof(uint16_t) +
+             chunk.bits.capacity() * sizeof(uint64_t);
+  }
+  return bytes;
+}
+
+bool operator==(const OccupancyBitmap& a, const OccupancyBitmap& b) {
+  // Chunks are arrays exactly when they have at most kMaxArraySize indexes,
+  // so equal sets have equal chunks.
+  return std::equal(a.chunks_.begin(), a.chunks_.end(), b.chunks_.begin(),
+                    b.chunks_.end(),
+                    [](const OccupancyBitmap::Chunk& x,
+                       const OccupancyBitmap::Chunk& y) {
+                      return x.key == y.key && x.array == y.array &&
+                             x.bits == y.bits;
+                    });
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,98 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_OCCUPANCY_BITMAP_H_
+#define SRC_MAIN_CC_ANY_SKETCH_OCCUPANCY_BITMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "any_sketch/any_sketch.h"
+
+namespace wfa::any_sketch {
+
+// The set of register indexes present in a sketch, for consumers that only
+// need presence: Bloom filter membership, active register counts and overlaps
+// between sketches.
+//
+// The bitmap is compressed like a Roaring bitmap, so that it stays compact for
+// sparse index spaces, such as the 2^40 indexes of large Liquid Legions. The
+// index space is split into chunks of 2^16 indexes, and each non-empty chunk
+// is held as a sorted array of the low 16 bits of its indexes while it has at
+// most 4096 of them, and as a 2^16-bit bitset once it has more. A chunk thus
+// never takes more than 8 KiB, and dense chunks are combined word by word,
+// with popcounts for the cardinalities.
+class OccupancyBitmap {
+ public:
+  // Creates an empty bitmap.
+  OccupancyBitmap() = default;
+
+  // Returns the indexes of the registers of `sketch`.
+  static OccupancyBitmap FromSketch(const AnySketch& sketch);
+
+  // Returns a bitmap of `indexes`, which may be in any order and repeat.
+  static OccupancyBitmap FromIndexes(std::vector<uint64_t> indexes);
+
+  // Returns the indexes in both bitmaps.
+  static OccupancyBitmap And(const OccupancyBitmap& a,
+                             const OccupancyBitmap& b);
+
+  // Returns the indexes in either bitmap.
+  static OccupancyBitmap Or(const OccupancyBitmap& a, const OccupancyBitmap& b);
+
+  // Returns the number of indexes in both bitmaps, without building their
+  // intersection.
+  static size_t AndCardinality(const OccupancyBitmap& a,
+                               const OccupancyBitmap& b);
+
+  bool Contains(uint64_t index) const;
+
+  // Returns the number of indexes, in time linear in the number of chunks.
+  size_t cardinality() const;
+
+  bool empty() const { return chunks_.empty(); }
+
+  // Calls `fn` on each index in increasing order.
+  void ForEach(absl::FunctionRef<void(uint64_t)> fn) const;
+
+  // Returns the bytes of the chunks' arrays and bitsets.
+  size_t memory_bytes() const;
+
+  friend bool operator==(const OccupancyBitmap& a, const OccupancyBitmap& b);
+
+ private:
+  // The indexes of a chunk of 2^16 indexes: sorted low bits in `array`, or a
+  // bitset in `bits` if it is not empty.
+  struct Chunk {
+    uint64_t key;
+    std::vector<uint16_t> array;
+    std::vector<uint64_t> bits;
+    size_t cardinality;
+
+    bool is_bitset() const { return !bits.empty(); }
+  };
+
+  static Chunk AndChunks(const Chunk& a, const Chunk& b);
+  static Chunk OrChunks(const Chunk& a, const Chunk& b);
+  static size_t AndChunksCardinality(const Chunk& a, const Chunk& b);
+
+  // Chunks with at least one index, in increasing key order.
+  std::vector<Chunk> chunks_;
+};
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_OCCUPANCY_BITMAP_H_
@@ -0,0 +1,362 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/packed_sketch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/numeric/bits.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/util.h"
+#include "common_cpp/macros/macros.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+constexpr uint8_t kFormatVersion = 1;
+constexpr size_t kBlockSize = 128;
+// Bytes past the end of a block's packed offsets that UnpackBits may read.
+constexpr size_t kUnpackPadding = 16;
+
+absl::Status TruncatedError() {
+  return absl::InvalidArgumentError("The packed sketch is truncated.");
+}
+
+uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+void PutVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+class Reader {
+ public:
+  explicit Reader(absl::string_view data) : data_(data) {}
+
+  size_t remaining() const { return data_.size(); }
+
+  bool ReadByte(uint8_t& value) {
+    if (data_.empty()) return false;
+    value = static_cast<uint8_t>(data_.front());
+    data_.remove_prefix(1);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadByte(byte)) return false;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (byte < 0x80) return true;
+    }
+    return false;
+  }
+
+  bool ReadBytes(uint64_t size, absl::string_view& value) {
+    if (size > data_.size()) return false;
+    value = data_.substr(0, size);
+    data_.remove_prefix(size);
+    return true;
+  }
+
+ private:
+  absl::string_view data_;
+};
+
+size_t PackedSize(size_t count, int width) { return (count * width + 7) / 8; }
+
+// Block minimums of value columns may be negative and are zigzag encoded.
+// Those of index delta columns are unsigned.
+uint64_t EncodeBase(int64_t base) { return ZigZagEncode(base); }
+uint64_t EncodeBase(uint64_t base) { return base; }
+
+template <typename T>
+uint64_t DecodeBase(uint64_t encoded_base);
+
+template <>
+uint64_t DecodeBase<int64_t>(uint64_t encoded_base) {
+  return static_cast<uint64_t>(ZigZagDecode(encoded_base));
+}
+
+template <>
+uint64_t DecodeBase<uint64_t>(uint64_t encoded_base) {
+  return encoded_base;
+}
+
+// Appends the offsets of `block` from `base`, `width` bits each.
+template <typename T>
+void PackBits(absl::Span<const T> block, T base, int width, std::string& out) {
+  if (width == 0) return;
+  const size_t begin = out.size();
+  out.resize(begin + PackedSize(block.size(), width));
+  unsigned char* data = reinterpret_cast<unsigned char*>(&out[begin]);
+  uint64_t buffer = 0;
+  int buffered = 0;
+  for (T value : block) {
+    const uint64_t offset =
+        static_cast<uint64_t>(value) - static_cast<uint64_t>(base);
+    buffer |= offset << buffered;
+    buffered += width;
+    if (buffered >= 64) {
+      Store64(buffer, data);
+      data += 8;
+      buffered -= 64;
+      buffer = buffered == 0 ? 0 : offset >> (width - buffered);
+    }
+  }
+  for (; buffered > 0; buffered -= 8) {
+    *data++ = static_cast<unsigned char>(buffer);
+    buffer >>= 8;
+  }
+}
+
+// Writes the `count` offsets of `width` bits in `packed`, plus `base`, to
+// `out`.
+void UnpackBits(absl::string_view packed, size_t count, int width,
+                uint64_t base, uint64_t* out) {
+  if (width == 0) {
+    std::fill_n(out, count, base);
+    return;
+  }
+  // With the block copied to a padded buffer, every offset is read with an
+  // unaligned 64-bit load and no bounds checks, which keeps the loop
+  // branch-free.
+  unsigned char buffer[kBlockSize * 8 + kUnpackPadding];
+  std::memcpy(buffer, packed.data(), packed.size());
+  std::memset(buffer + packed.size(), 0, kUnpackPadding);
+  const uint64_t mask =
+      width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+  if (width <= 56) {
+    for (size_t i = 0; i < count; ++i) {
+      const size_t bit = i * width;
+      out[i] = base + ((Load64(buffer + bit / 8) >> (bit % 8)) & mask);
+    }
+  } else {
+    // Wider offsets may span nine bytes.
+    for (size_t i = 0; i < count; ++i) {
+      const size_t bit = i * width;
+      const int shift = bit % 8;
+      uint64_t offset = Load64(buffer + bit / 8) >> shift;
+      if (shift != 0) {
+        offset |= static_cast<uint64_t>(buffer[bit / 8 + 8]) << (64 - shift);
+      }
+      out[i] = base + (offset & mask);
+    }
+  }
+}
+
+template <typename T>
+void PackColumn(absl::Span<const T> column, std::string& out) {
+  for (size_t start = 0; start < column.size(); start += kBlockSize) {
+    absl::Span<const T> block = column.subspan(start, kBlockSize);
+    const T base = *std::min_element(block.begin(), block.end());
+    uint64_t offset_bits = 0;
+    for (T value : block) {
+      offset_bits |= static_cast<uint64_t>(value) - static_cast<uint64_t>(base);
+    }
+    const int width = absl::bit_width(offset_bits);
+    PutVarint(EncodeBase(base), out);
+    out.push_back(static_cast<char>(width));
+    PackBits(block, base, width, out);
+  }
+}
+
+// Reads a column of `size` entries written by PackColumn<T> into `out`.
+template <typename T>
+absl::Status UnpackColumn(Reader& reader, size_t size, uint64_t* out) {
+  for (size_t start = 0; start < size; start += kBlockSize) {
+    const size_t count = std::min(kBlockSize, size - start);
+    uint64_t encoded_base;
+    uint8_t width;
+    absl::string_view packed;
+    if (!reader.ReadVarint(encoded_base) || !reader.ReadByte(width)) {
+      return TruncatedError();
+    }
+    if (width > 64) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Invalid bit width ", static_cast<int>(width),
+                       " in the packed sketch."));
+    }
+    if (!reader.ReadBytes(PackedSize(count, width), packed)) {
+      return TruncatedError();
+    }
+    UnpackBits(packed, count, width, DecodeBase<T>(encoded_base), out + start);
+  }
+  return absl::OkStatus();
+}
+
+// Reads the columns of `register_count` registers with `value_count` values
+// each and appends the registers to `registers`.
+absl::Status DecodeRegisters(
+    Reader& reader, uint64_t register_count, uint64_t value_count,
+    google::protobuf::RepeatedPtrField<Sketch::Register>& registers) {
+  // Every block takes at least two bytes, which bounds the register count
+  // before anything is allocated for it.
+  if ((register_count - 1) / kBlockSize > reader.remaining() / 2) {
+    return TruncatedError();
+  }
+
+  uint64_t first_index;
+  if (!reader.ReadVarint(first_index)) {
+    return TruncatedError();
+  }
+  std::vector<uint64_t> column(register_count);
+  column[0] = static_cast<uint64_t>(ZigZagDecode(first_index));
+  RETURN_IF_ERROR(
+      UnpackColumn<uint64_t>(reader, register_count - 1, column.data() + 1));
+  for (size_t i = 1; i < register_count; ++i) {
+    column[i] += column[i - 1];
+  }
+
+  const int begin = registers.size();
+  registers.Reserve(begin + register_count);
+  for (size_t i = 0; i < register_count; ++i) {
+    Sketch::Register* sketch_register = registers.Add();
+    sketch_register->set_index(static_cast<int64_t>(column[i]));
+    sketch_register->mutable_values()->Resize(value_count, 0);
+  }
+  for (uint64_t j = 0; j < value_count; ++j) {
+    RETURN_IF_ERROR(
+        UnpackColumn<int64_t>(reader, register_count, column.data()));
+    for (size_t i = 0; i < register_count; ++i) {
+      registers.Mutable(begin + i)->set_values(j,
+                                               static_cast<int64_t>(column[i]));
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> EncodePackedSketch(const Sketch& sketch) {
+  const int register_count = sketch.registers_size();
+  const int value_count = sketch.config().values_size();
+  for (int i = 0; i < register_count; ++i) {
+    if (sketch.registers(i).values_size() != value_count) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Register ", i, " has ", sketch.registers(i).values_size(),
+          " values but the config has ", value_count, " ValueSpecs."));
+    }
+  }
+
+  // Sorting (index, position) pairs rather than positions keeps the
+  // comparisons within one contiguous array.
+  std::vector<std::pair<int64_t, int>> order(register_count);
+  for (int i = 0; i < register_count; ++i) {
+    order[i] = {sketch.registers(i).index(), i};
+  }
+  if (!std::is_sorted(order.begin(), order.end())) {
+    std::sort(order.begin(), order.end());
+  }
+
+  std::string out;
+  out.push_back(static_cast<char>(kFormatVersion));
+  const std::string config = sketch.config().SerializeAsString();
+  PutVarint(config.size(), out);
+  out.append(config);
+  PutVarint(register_count, out);
+  PutVarint(value_count, out);
+  if (register_count == 0) {
+    return out;
+  }
+
+  std::vector<uint64_t> deltas(register_count - 1);
+  int64_t previous_index = order[0].first;
+  PutVarint(ZigZagEncode(previous_index), out);
+  for (int i = 1; i < register_count; ++i) {
+    const int64_t index = order[i].first;
+    deltas[i - 1] =
+        static_cast<uint64_t>(index) - static_cast<uint64_t>(previous_index);
+    previous_index = index;
+  }
+  PackColumn<uint64_t>(deltas, out);
+
+  std::vector<int64_t> column(register_count);
+  for (int j = 0; j < value_count; ++j) {
+    for (int i = 0; i < register_count; ++i) {
+      column[i] = sketch.registers(order[i].second).values(j);
+    }
+    PackColumn<int64_t>(column, out);
+  }
+  return out;
+}
+
+absl::StatusOr<Sketch> DecodePackedSketch(absl::string_view packed) {
+  Reader reader(packed);
+  uint8_t version;
+  if (!reader.ReadByte(version)) {
+    return TruncatedError();
+  }
+  if (version != kFormatVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported packed sketch format version ",
+                     static_cast<int>(version), "."));
+  }
+
+  uint64_t config_size;
+  absl::string_view config;
+  if (!reader.ReadVarint(config_size) ||
+      !reader.ReadBytes(config_size, config)) {
+    return TruncatedError();
+  }
+  Sketch sketch;
+  if (!sketch.mutable_config()->ParseFromArray(config.data(), config.size())) {
+    return absl::InvalidArgumentError(
+        "failed to parse the SketchConfig of the packed sketch.");
+  }
+
+  uint64_t register_count;
+  uint64_t value_count;
+  if (!reader.ReadVarint(register_count) || !reader.ReadVarint(value_count)) {
+    return TruncatedError();
+  }
+  if (value_count != static_cast<uint64_t>(sketch.config().values_size())) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The packed sketch has ", value_count,
+                     " value columns but its config has ",
+                     sketch.config().values_size(), " ValueSpecs."));
+  }
+  if (register_count > 0) {
+    RETURN_IF_ERROR(DecodeRegisters(reader, register_count, value_count,
+                                    *sketch.mutable_registers()));
+  }
+  if (reader.remaining() != 0) {
+    return absl::InvalidArgumentError(
+        "The packed sketch has trailing bytes after its last column.");
+  }
+  return sketch;
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,59 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_PACKED_SKETCH_H_
+#define SRC_MAIN_CC_ANY_SKETCH_PACKED_SKETCH_H_
+
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+// A compact, columnar alternative to the wire format of the Sketch proto.
+//
+// Registers are sorted by index. The indexes are stored as the first index
+// followed by the deltas between consecutive indexes, and each value is stored
+// as its own column. Every column is split into blocks of 128 entries, and each
+// block is stored frame-of-reference: its minimum, followed by the offsets from
+// that minimum bit-packed at the width of the largest offset. Dense indexes and
+// small frequencies therefore take a few bits per register instead of a varint
+// and a message header each.
+//
+// Layout, with varints as in the proto wire format:
+//   format version (1 byte)
+//   config size (varint), serialized SketchConfig
+//   register count (varint), value count (varint)
+//   first index (zigzag varint), if there are registers
+//   index deltas: register count - 1 entries
+//   one column per value: register count entries
+// where each column is a sequence of blocks of
+//   minimum (zigzag varint for values, varint for deltas)
+//   bit width (1 byte)
+//   offsets, little-endian bit-packed, padded to a whole byte
+namespace wfa::any_sketch {
+
+// Returns `sketch` in the packed format. Every register must have as many
+// values as the config has ValueSpecs.
+//
+// The registers of the decoded sketch are ordered by index rather than in the
+// order of `sketch`.
+absl::StatusOr<std::string> EncodePackedSketch(const Sketch& sketch);
+
+// Returns the Sketch encoded in `packed` by EncodePackedSketch.
+absl::StatusOr<Sketch> DecodePackedSketch(absl::string_view packed);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_PACKED_SKETCH_H_
@@ -0,0 +1,115 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/register_join.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/fixed_array.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using Registers = absl::Span<const AnySketch::Register>;
+
+// Returns the position of the first register of `registers` at or after
+// `position` whose index is at least `index`, by exponential search.
+size_t Seek(Registers registers, size_t position, uint64_t index) {
+  size_t step = 1;
+  size_t bound = position;
+  while (bound < registers.size() && registers[bound].index < index) {
+    position = bound + 1;
+    bound += step;
+    step *= 2;
+  }
+  bound = std::min(bound, registers.size());
+  return std::lower_bound(registers.begin() + position,
+                          registers.begin() + bound, index,
+                          [](const AnySketch::Register& reg, uint64_t index) {
+                            return reg.index < index;
+                          }) -
+         registers.begin();
+}
+
+absl::Status CheckValueCount(const AnySketch::Register& reg,
+                             size_t value_count) {
+  if (reg.values.size() != value_count) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Register ", reg.index, " has ", reg.values.size(),
+                     " values but there are ", value_count, " functions"));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status IntersectSortedRegisters(
+    Registers left, Registers right,
+    absl::Span<const ValueFunction> value_functions,
+    absl::FunctionRef<void(const AnySketch::Register&)> fn) {
+  std::vector<const Aggregator*> aggregators;
+  for (const ValueFunction& value_function : value_functions) {
+    aggregators.push_back(&GetAggregator(value_function.aggregator_type));
+  }
+  absl::FixedArray<int64_t> values(aggregators.size());
+
+  size_t i = 0;
+  size_t j = 0;
+  while (i < left.size() && j < right.size()) {
+    if (left[i].index < right[j].index) {
+      i = Seek(left, i, right[j].index);
+    } else if (right[j].index < left[i].index) {
+      j = Seek(right, j, left[i].index);
+    } else {
+      RETURN_IF_ERROR(CheckValueCount(left[i], values.size()));
+      RETURN_IF_ERROR(CheckValueCount(right[j], values.size()));
+      for (size_t k = 0; k < values.size(); ++k) {
+        values[k] =
+            aggregators[k]->Aggregate(left[i].values[k], right[j].values[k]);
+      }
+      fn(AnySketch::Register{.index = left[i].index, .values = values});
+      ++i;
+      ++j;
+    }
+  }
+  return absl::OkStatus();
+}
+
+void SubtractSortedRegisters(
+    Registers left, Registers right,
+    absl::FunctionRef<void(const AnySketch::Register&)> fn) {
+  size_t j = 0;
+  for (const AnySketch::Register& reg : left) {
+    if (j < right.size() && right[j].index < reg.index) {
+      j = Seek(right, j, reg.index);
+    }
+    if (j < right.size() && right[j].index == reg.index) {
+      ++j;
+    } else {
+      fn(reg);
+    }
+  }
+}
+
+}  // namespace wfa::any_sketch
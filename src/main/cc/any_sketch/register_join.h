@@ -0,0 +1,53 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_REGISTER_JOIN_H_
+#define SRC_MAIN_CC_ANY_SKETCH_REGISTER_JOIN_H_
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/value_function.h"
+
+// Intersection and difference of registers held in increasing index order,
+// e.g. from AnySketch::SortedRegisters or AnySketch::Partition.
+//
+// These are merge-joins, which read both inputs sequentially rather than
+// probing a hash table. When one input is much smaller, the larger one is
+// skipped through by exponential search, so the cost approaches
+// O(m log(n / m)) for m registers joined against n.
+namespace wfa::any_sketch {
+
+// Calls `fn`, in increasing index order, on each index that is in both `left`
+// and `right`, with their values aggregated by the aggregators of
+// `value_functions`. The values passed to `fn` are only valid during the call.
+//
+// Fails if a joined register does not have one value per ValueFunction.
+ABSL_MUST_USE_RESULT absl::Status IntersectSortedRegisters(
+    absl::Span<const AnySketch::Register> left,
+    absl::Span<const AnySketch::Register> right,
+    absl::Span<const ValueFunction> value_functions,
+    absl::FunctionRef<void(const AnySketch::Register&)> fn);
+
+// Calls `fn`, in increasing index order, on each register of `left` whose index
+// is not in `right`.
+void SubtractSortedRegisters(
+    absl::Span<const AnySketch::Register> left,
+    absl::Span<const AnySketch::Register> right,
+    absl::FunctionRef<void(const AnySketch::Register&)> fn);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_REGISTER_JOIN_H_
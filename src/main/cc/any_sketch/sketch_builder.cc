@@ -0,0 +1,269 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_builder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/sketch_proto_conversion.h"
+#include "any_sketch/sketch_spec.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+absl::Status EventError(size_t offset, absl::string_view message) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Event at byte ", offset, ": ", message));
+}
+
+// Reads the length-delimited event starting at `offset` of `events` into
+// `event` and returns the offset following it.
+absl::StatusOr<size_t> ReadLengthDelimitedEvent(absl::string_view events,
+                                                size_t offset,
+                                                absl::string_view& event) {
+  uint64_t size = 0;
+  size_t position = offset;
+  for (int shift = 0;; shift += 7) {
+    if (position == events.size() || shift >= 64) {
+      return EventError(offset, "truncated or invalid length prefix.");
+    }
+    const uint8_t byte = static_cast<uint8_t>(events[position++]);
+    size |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (byte < 0x80) break;
+  }
+  if (size > events.size() - position) {
+    return EventError(offset, absl::StrCat("truncated event of ", size,
+                                           " bytes."));
+  }
+  event = events.substr(position, size);
+  return position + size;
+}
+
+// Returns the offsets at which to split `events` into `chunk_count` chunks of
+// about the same size, starting with 0 and ending with events.size(). Chunks
+// start at event boundaries and may be empty.
+absl::StatusOr<std::vector<size_t>> SplitEvents(
+    absl::string_view events, const EventFileOptions& options,
+    int chunk_count) {
+  std::vector<size_t> bounds = {0};
+  switch (options.format) {
+    case EventFileFormat::kNewlineDelimited:
+      for (int i = 1; i < chunk_count; ++i) {
+        const size_t target = events.size() * i / chunk_count;
+        // The chunk starts after the first newline at or after target - 1.
+        size_t start = 0;
+        if (target > 0) {
+          const size_t newline = events.find('\n', target - 1);
+          start =
+              newline == absl::string_view::npos ? events.size() : newline + 1;
+        }
+        bounds.push_back(std::max(bounds.back(), start));
+      }
+      break;
+    case EventFileFormat::kLengthDelimited: {
+      if (chunk_count == 1) break;
+      // Events can only be found from the start of the file, so this scans
+      // the length prefixes.
+      size_t offset = 0;
+      int next_chunk = 1;
+      absl::string_view event;
+      while (offset < events.size()) {
+        while (next_chunk < chunk_count &&
+               offset >= events.size() * next_chunk / chunk_count) {
+          bounds.push_back(offset);
+          ++next_chunk;
+        }
+        ASSIGN_OR_RETURN(offset,
+                         ReadLengthDelimitedEvent(events, offset, event));
+      }
+      break;
+    }
+  }
+  bounds.resize(chunk_count, events.size());
+  bounds.push_back(events.size());
+  return bounds;
+}
+
+// Parses the metadata `columns` of a newline-delimited event into `values`.
+absl::Status ParseMetadataColumns(absl::string_view columns, char delimiter,
+                                  absl::Span<int64_t* const> values,
+                                  size_t offset) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    const size_t column_end = columns.find(delimiter);
+    absl::string_view column = columns.substr(0, column_end);
+    if (!absl::SimpleAtoi(column, values[i])) {
+      return EventError(offset, absl::StrCat("metadata column ", i + 1, " (\"",
+                                             column, "\") is not an integer."));
+    }
+    if (column_end == absl::string_view::npos) {
+      if (i + 1 < values.size()) {
+        return EventError(offset,
+                          absl::StrCat("expected ", values.size(),
+                                       " metadata columns but got ", i + 1,
+                                       "."));
+      }
+      return absl::OkStatus();
+    }
+    columns.remove_prefix(column_end + 1);
+  }
+  return EventError(offset, absl::StrCat("expected ", values.size(),
+                                         " metadata columns but got more."));
+}
+
+// Inserts every event of `chunk`, which starts at byte `chunk_offset` of the
+// file, into `sketch`.
+absl::Status SketchNewlineDelimitedEvents(absl::string_view chunk,
+                                          size_t chunk_offset,
+                                          const EventFileOptions& options,
+                                          AnySketch& sketch) {
+  // The metadata map is filled in place for each event, so that its keys are
+  // only allocated once.
+  ItemMetadata metadata;
+  for (const std::string& column : options.metadata_columns) {
+    metadata[column] = 0;
+  }
+  std::vector<int64_t*> values;
+  for (const std::string& column : options.metadata_columns) {
+    values.push_back(&metadata.find(column)->second);
+  }
+
+  size_t position = 0;
+  while (position < chunk.size()) {
+    size_t line_end = chunk.find('\n', position);
+    if (line_end == absl::string_view::npos) line_end = chunk.size();
+    absl::string_view line = chunk.substr(position, line_end - position);
+    const size_t offset = chunk_offset + position;
+    position = line_end + 1;
+
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    if (line.empty()) continue;
+
+    absl::string_view event_id = line;
+    if (!values.empty()) {
+      const size_t id_end = line.find(options.column_delimiter);
+      if (id_end == absl::string_view::npos) {
+        return EventError(offset, "missing metadata columns.");
+      }
+      event_id = line.substr(0, id_end);
+      RETURN_IF_ERROR(ParseMetadataColumns(line.substr(id_end + 1),
+                                           options.column_delimiter,
+                                           values, offset));
+    }
+    if (absl::Status status = sketch.Insert(event_id, metadata);
+        !status.ok()) {
+      return EventError(offset, status.message());
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SketchLengthDelimitedEvents(absl::string_view chunk,
+                                         size_t chunk_offset,
+                                         AnySketch& sketch) {
+  const ItemMetadata metadata;
+  size_t position = 0;
+  absl::string_view event_id;
+  while (position < chunk.size()) {
+    const size_t offset = chunk_offset + position;
+    ASSIGN_OR_RETURN(position,
+                     ReadLengthDelimitedEvent(chunk, position, event_id));
+    if (absl::Status status = sketch.Insert(event_id, metadata);
+        !status.ok()) {
+      return EventError(offset, status.message());
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status SketchEvents(absl::string_view chunk, size_t chunk_offset,
+                          const EventFileOptions& options, AnySketch& sketch) {
+  switch (options.format) {
+    case EventFileFormat::kNewlineDelimited:
+      return SketchNewlineDelimitedEvents(chunk, chunk_offset, options, sketch);
+    case EventFileFormat::kLengthDelimited:
+      return SketchLengthDelimitedEvents(chunk, chunk_offset, sketch);
+  }
+  return absl::InvalidArgumentError("Unknown event file format.");
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<AnySketch>> BuildSketch(
+    const SketchSpec& spec, absl::string_view events,
+    const EventFileOptions& options) {
+  if (options.format == EventFileFormat::kLengthDelimited &&
+      !options.metadata_columns.empty()) {
+    return absl::InvalidArgumentError(
+        "Length-delimited events cannot have metadata columns.");
+  }
+  const int thread_count = std::max(options.thread_count, 1);
+  ASSIGN_OR_RETURN(std::vector<size_t> bounds,
+                   SplitEvents(events, options, thread_count));
+
+  std::vector<std::unique_ptr<AnySketch>> sketches(thread_count);
+  for (std::unique_ptr<AnySketch>& sketch : sketches) {
+    ASSIGN_OR_RETURN(sketch, CreateAnySketch(spec));
+  }
+  std::vector<absl::Status> statuses(thread_count);
+  auto sketch_chunk = [&](int i) {
+    statuses[i] =
+        SketchEvents(events.substr(bounds[i], bounds[i + 1] - bounds[i]),
+                     bounds[i], options, *sketches[i]);
+  };
+  if (thread_count == 1) {
+    sketch_chunk(0);
+  } else {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (int i = 0; i < thread_count; ++i) {
+      threads.emplace_back(sketch_chunk, i);
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+
+  std::unique_ptr<AnySketch> sketch = std::move(sketches[0]);
+  RETURN_IF_ERROR(sketch->MergeAll(absl::MakeConstSpan(sketches).subspan(1)));
+  return sketch;
+}
+
+absl::StatusOr<std::string> BuildSerializedSketch(
+    absl::string_view serialized_config, absl::string_view events,
+    const EventFileOptions& options) {
+  ASSIGN_OR_RETURN(SketchSpec spec, SketchSpecFromConfig(serialized_config));
+  ASSIGN_OR_RETURN(std::unique_ptr<AnySketch> sketch,
+                   BuildSketch(spec, events, options));
+  return SerializeSketchProto(*sketch, serialized_config);
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,68 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SKETCH_BUILDER_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SKETCH_BUILDER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/sketch_spec.h"
+
+// Builds sketches from files of events.
+//
+// Like sketch_spec.h, this header includes neither any_sketch.h nor the Sketch
+// proto, so that it can be used with either.
+namespace wfa::any_sketch {
+
+enum class EventFileFormat {
+  // One event per line: the event ID, followed by the metadata columns.
+  kNewlineDelimited,
+  // Events prefixed by their size as a varint, as written by protobuf's
+  // SerializeDelimitedToOstream. Each event is an event ID, which may contain
+  // any bytes. There are no metadata columns.
+  kLengthDelimited,
+};
+
+struct EventFileOptions {
+  EventFileFormat format = EventFileFormat::kNewlineDelimited;
+  // Separates the columns of newline-delimited events.
+  char column_delimiter = '\t';
+  // Names of the metadata columns following the event ID of newline-delimited
+  // events. Their values are integers and are passed to the sketch as the
+  // ItemMetadata of the event, e.g. for oracle distributions.
+  std::vector<std::string> metadata_columns;
+  // Number of threads. The events are split into this many contiguous chunks,
+  // each sketched by its own thread, and the sketches are then merged.
+  int thread_count = 1;
+};
+
+// Returns a sketch of `spec` with every event in `events`, the contents of an
+// event file.
+absl::StatusOr<std::unique_ptr<AnySketch>> BuildSketch(
+    const SketchSpec& spec, absl::string_view events,
+    const EventFileOptions& options);
+
+// Returns a serialized Sketch proto with config `serialized_config` and every
+// event in `events`.
+absl::StatusOr<std::string> BuildSerializedSketch(
+    absl::string_view serialized_config, absl::string_view events,
+    const EventFileOptions& options);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SKETCH_BUILDER_H_
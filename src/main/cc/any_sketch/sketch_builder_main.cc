@@ -0,0 +1,133 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Sketches a file of events.
+//
+// The event file is memory-mapped and split into one chunk per thread. The
+// output is either a serialized Sketch proto or its packed columnar encoding
+// (see packed_sketch.h).
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "any_sketch/mapped_file.h"
+#include "any_sketch/packed_sketch.h"
+#include "any_sketch/sketch_builder.h"
+#include "any_sketch/sketch_spec.h"
+#include "glog/logging.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+ABSL_FLAG(std::string, sketch_config, "",
+          "Path of the SketchConfig of the sketch, in text format.");
+ABSL_FLAG(std::string, input, "", "Path of the event file.");
+ABSL_FLAG(std::string, output, "", "Path to write the sketch to.");
+ABSL_FLAG(std::string, input_format, "newline",
+          "Format of the event file: newline or length_delimited.");
+ABSL_FLAG(std::string, column_delimiter, "\t",
+          "Delimiter of the columns of newline-delimited events.");
+ABSL_FLAG(std::vector<std::string>, metadata_columns, {},
+          "Names of the integer columns following the event ID of "
+          "newline-delimited events, passed to oracle distributions.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "Number of threads sketching the events.");
+ABSL_FLAG(std::string, output_format, "sketch",
+          "Format of the output: sketch (a serialized Sketch proto) or packed "
+          "(the packed columnar encoding).");
+
+namespace {
+
+using ::wfa::any_sketch::BuildSerializedSketch;
+using ::wfa::any_sketch::EncodePackedSketch;
+using ::wfa::any_sketch::EventFileFormat;
+using ::wfa::any_sketch::EventFileOptions;
+using ::wfa::any_sketch::MappedFile;
+using ::wfa::any_sketch::SerializeSketchConfigText;
+using ::wfa::any_sketch::Sketch;
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  CHECK(file) << "Cannot open " << path;
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::ParseCommandLine(argc, argv);
+
+  const std::string config_path = absl::GetFlag(FLAGS_sketch_config);
+  const std::string input_path = absl::GetFlag(FLAGS_input);
+  const std::string output_path = absl::GetFlag(FLAGS_output);
+  CHECK(!config_path.empty()) << "--sketch_config is required";
+  CHECK(!input_path.empty()) << "--input is required";
+  CHECK(!output_path.empty()) << "--output is required";
+
+  EventFileOptions options;
+  const std::string input_format = absl::GetFlag(FLAGS_input_format);
+  if (input_format == "newline") {
+    options.format = EventFileFormat::kNewlineDelimited;
+  } else if (input_format == "length_delimited") {
+    options.format = EventFileFormat::kLengthDelimited;
+  } else {
+    LOG(FATAL) << "Unknown --input_format " << input_format;
+  }
+  const std::string column_delimiter = absl::GetFlag(FLAGS_column_delimiter);
+  CHECK_EQ(column_delimiter.size(), 1)
+      << "--column_delimiter should be a single character";
+  options.column_delimiter = column_delimiter[0];
+  options.metadata_columns = absl::GetFlag(FLAGS_metadata_columns);
+  options.thread_count = absl::GetFlag(FLAGS_threads);
+  const std::string output_format = absl::GetFlag(FLAGS_output_format);
+  CHECK(output_format == "sketch" || output_format == "packed")
+      << "Unknown --output_format " << output_format;
+
+  const std::string config =
+      SerializeSketchConfigText(ReadFile(config_path)).value();
+  const MappedFile input = MappedFile::Open(input_path).value();
+
+  const absl::Time start = absl::Now();
+  std::string output =
+      BuildSerializedSketch(config, input.contents(), options).value();
+  const absl::Duration sketch_duration = absl::Now() - start;
+  if (output_format == "packed") {
+    Sketch sketch;
+    CHECK(sketch.ParseFromString(output));
+    output = EncodePackedSketch(sketch).value();
+  }
+
+  std::ofstream output_file(output_path, std::ios::binary | std::ios::trunc);
+  CHECK(output_file) << "Cannot open " << output_path;
+  output_file.write(output.data(), output.size());
+  CHECK(output_file.flush()) << "Cannot write " << output_path;
+
+  std::cerr << "Sketched " << input.contents().size() << " bytes of events in "
+            << sketch_duration << " with " << options.thread_count
+            << " threads.\nWrote " << output.size() << " bytes to "
+            << output_path << "\n";
+  return 0;
+}
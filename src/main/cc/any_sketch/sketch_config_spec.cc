@@ -0,0 +1,135 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The SketchConfig side of sketch_spec.h. This file must not include
+// any_sketch.h or distributions.h; see sketch_spec.h.
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/sketch_spec.h"
+#include "common_cpp/macros/macros.h"
+#include "google/protobuf/text_format.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+template <typename T>
+absl::Status CheckUnsalted(const T& distribution, absl::string_view type) {
+  if (distribution.has_salt()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Salted ", type, " distributions are not supported."));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<DistributionSpec> ToDistributionSpec(
+    const Distribution& distribution) {
+  DistributionSpec spec;
+  switch (distribution.distribution_choice_case()) {
+    case Distribution::kOracle:
+      spec.type = DistributionSpec::Type::kOracle;
+      spec.feature_name = distribution.oracle().key();
+      return spec;
+    case Distribution::kUniform:
+      RETURN_IF_ERROR(CheckUnsalted(distribution.uniform(), "uniform"));
+      spec.type = DistributionSpec::Type::kUniform;
+      spec.num_values = distribution.uniform().num_values();
+      return spec;
+    case Distribution::kExponential:
+      RETURN_IF_ERROR(CheckUnsalted(distribution.exponential(), "exponential"));
+      spec.type = DistributionSpec::Type::kExponential;
+      spec.num_values = distribution.exponential().num_values();
+      spec.rate = distribution.exponential().rate();
+      return spec;
+    case Distribution::kGeometric:
+      RETURN_IF_ERROR(CheckUnsalted(distribution.geometric(), "geometric"));
+      // AnySketch counts trailing zero bits of the fingerprint.
+      if (distribution.geometric().success_probability() != 0.5) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "Geometric distributions must have a success probability of 0.5, "
+            "got ",
+            distribution.geometric().success_probability(), "."));
+      }
+      spec.type = DistributionSpec::Type::kGeometric;
+      spec.num_values = distribution.geometric().num_values();
+      return spec;
+    case Distribution::kConstant:
+    case Distribution::kDiracMixture:
+    case Distribution::kVerbatim:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Distribution ", distribution.ShortDebugString(),
+                       " is not supported by AnySketch."));
+    case Distribution::DISTRIBUTION_CHOICE_NOT_SET:
+      break;
+  }
+  return absl::InvalidArgumentError("The distribution is not set.");
+}
+
+absl::StatusOr<AggregatorType> ToAggregatorType(
+    SketchConfig::ValueSpec::Aggregator aggregator) {
+  switch (aggregator) {
+    case SketchConfig::ValueSpec::SUM:
+      return AggregatorType::kSum;
+    case SketchConfig::ValueSpec::UNIQUE:
+      return AggregatorType::kUnique;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported aggregator ", aggregator, "."));
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<SketchSpec> SketchSpecFromConfig(
+    absl::string_view serialized_config) {
+  SketchConfig config;
+  if (!config.ParseFromArray(serialized_config.data(),
+                             serialized_config.size())) {
+    return absl::InvalidArgumentError("failed to parse the SketchConfig.");
+  }
+  SketchSpec spec;
+  for (const SketchConfig::IndexSpec& index : config.indexes()) {
+    ASSIGN_OR_RETURN(DistributionSpec distribution,
+                     ToDistributionSpec(index.distribution()));
+    spec.indexes.push_back(std::move(distribution));
+  }
+  for (const SketchConfig::ValueSpec& value : config.values()) {
+    ValueSpec& value_spec = spec.values.emplace_back();
+    value_spec.name = value.name();
+    ASSIGN_OR_RETURN(value_spec.aggregator_type,
+                     ToAggregatorType(value.aggregator()));
+    ASSIGN_OR_RETURN(value_spec.distribution,
+                     ToDistributionSpec(value.distribution()));
+  }
+  return spec;
+}
+
+absl::StatusOr<std::string> SerializeSketchConfigText(
+    absl::string_view text_config) {
+  SketchConfig config;
+  if (!google::protobuf::TextFormat::ParseFromString(std::string(text_config),
+                                                     &config)) {
+    return absl::InvalidArgumentError(
+        "failed to parse the SketchConfig text proto.");
+  }
+  return config.SerializeAsString();
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,85 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_group.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+
+absl::StatusOr<std::unique_ptr<SketchGroup>> SketchGroup::Create(
+    int member_count, AnySketchFactory sketch_factory) {
+  if (member_count < 1) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The member count should be positive but is ", member_count));
+  }
+  if (sketch_factory == nullptr) {
+    return absl::InvalidArgumentError("The sketch factory is empty.");
+  }
+  std::vector<std::unique_ptr<AnySketch>> members;
+  members.reserve(member_count);
+  for (int i = 0; i < member_count; ++i) {
+    members.push_back(sketch_factory());
+    if (members.back() == nullptr) {
+      return absl::InvalidArgumentError("The sketch factory returned null.");
+    }
+  }
+  return absl::WrapUnique(new SketchGroup(std::move(members)));
+}
+
+SketchGroup::SketchGroup(std::vector<std::unique_ptr<AnySketch>> members)
+    : members_(std::move(members)),
+      values_(members_.front()->value_functions().size()) {}
+
+absl::Status SketchGroup::Insert(absl::string_view item,
+                                 const ItemMetadata& item_metadata,
+                                 absl::Span<const int> members) {
+  for (int member : members) {
+    if (member < 0 || member >= member_count()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Member ", member, " is not in the group of ",
+                       member_count(), " sketches."));
+    }
+  }
+  if (members.empty()) return absl::OkStatus();
+
+  // The members share their distributions, so any of them computes the
+  // register.
+  ASSIGN_OR_RETURN(int64_t index,
+                   members_.front()->ComputeRegister(
+                       item, item_metadata, absl::MakeSpan(values_)));
+  // The members' register tables are independent, so fetching all of their
+  // slots first overlaps the cache misses of large sketches.
+  for (int member : members) {
+    members_[member]->PrefetchRegister(index);
+  }
+  for (int member : members) {
+    RETURN_IF_ERROR(members_[member]->InsertComputedRegister(index, values_));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,73 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SKETCH_GROUP_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SKETCH_GROUP_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/fixed_array.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+
+namespace wfa::any_sketch {
+
+// A group of sketches with the same indexes and values, e.g. one per campaign
+// or demographic, into which each item is inserted once.
+//
+// Inserting an item into k members with AnySketch::Insert fingerprints it and
+// applies every distribution k times. SketchGroup computes the register once
+// and aggregates it into each selected member, so the distributions are
+// evaluated once per item whatever the fan-out.
+class SketchGroup {
+ public:
+  // Creates a group of `member_count` empty sketches made by `sketch_factory`.
+  static absl::StatusOr<std::unique_ptr<SketchGroup>> Create(
+      int member_count, AnySketchFactory sketch_factory);
+
+  SketchGroup(const SketchGroup&) = delete;
+  SketchGroup& operator=(const SketchGroup&) = delete;
+
+  // Adds `item` to each sketch in `members`, given by their positions in the
+  // group, with the same registers and insert counts as calling
+  // AnySketch::Insert on each. Nothing is inserted if a position is out of
+  // range.
+  //
+  // Callers typically select the members from the item metadata, e.g. the
+  // campaign and demographic of an event.
+  ABSL_MUST_USE_RESULT absl::Status Insert(absl::string_view item,
+                                           const ItemMetadata& item_metadata,
+                                           absl::Span<const int> members);
+
+  int member_count() const { return static_cast<int>(members_.size()); }
+
+  AnySketch& member(int i) { return *members_[i]; }
+  const AnySketch& member(int i) const { return *members_[i]; }
+
+ private:
+  explicit SketchGroup(std::vector<std::unique_ptr<AnySketch>> members);
+
+  std::vector<std::unique_ptr<AnySketch>> members_;
+  // The values of the register being inserted, reused across inserts.
+  absl::FixedArray<AnySketch::ValueType> values_;
+};
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SKETCH_GROUP_H_
@@ -0,0 +1,166 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_proto_conversion.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/macros/macros.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::google::protobuf::io::CodedOutputStream;
+using ::google::protobuf::io::StringOutputStream;
+using ::google::protobuf::internal::WireFormatLite;
+
+// Field numbers from wfa/any_sketch/sketch.proto.
+constexpr int kSketchConfigField = 1;
+constexpr int kSketchRegistersField = 2;
+constexpr int kRegisterIndexField = 1;
+constexpr int kRegisterValuesField = 2;
+
+uint32_t LengthDelimitedTag(int field_number) {
+  return WireFormatLite::MakeTag(field_number,
+                                 WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+uint32_t VarintTag(int field_number) {
+  return WireFormatLite::MakeTag(field_number, WireFormatLite::WIRETYPE_VARINT);
+}
+
+// Writes a length-delimited field holding `size` bytes, except for the bytes
+// themselves.
+void WriteLengthDelimitedHeader(int field_number, size_t size,
+                                CodedOutputStream& output) {
+  output.WriteTag(LengthDelimitedTag(field_number));
+  output.WriteVarint64(size);
+}
+
+// Writes a Sketch.Register like its generated serializer would: a zero index
+// and empty values are omitted and the values are packed.
+void WriteRegister(uint64_t index, const std::vector<int64_t>& values,
+                   CodedOutputStream& output) {
+  size_t packed_size = 0;
+  for (int64_t value : values) {
+    packed_size += CodedOutputStream::VarintSize64(value);
+  }
+  size_t register_size = 0;
+  if (index != 0) {
+    register_size += CodedOutputStream::VarintSize32(
+                         VarintTag(kRegisterIndexField)) +
+                     CodedOutputStream::VarintSize64(index);
+  }
+  if (!values.empty()) {
+    register_size += CodedOutputStream::VarintSize32(
+                         LengthDelimitedTag(kRegisterValuesField)) +
+                     CodedOutputStream::VarintSize64(packed_size) +
+                     packed_size;
+  }
+
+  WriteLengthDelimitedHeader(kSketchRegistersField, register_size, output);
+  if (index != 0) {
+    output.WriteTag(VarintTag(kRegisterIndexField));
+    output.WriteVarint64(index);
+  }
+  if (!values.empty()) {
+    WriteLengthDelimitedHeader(kRegisterValuesField, packed_size, output);
+    for (int64_t value : values) {
+      output.WriteVarint64(value);
+    }
+  }
+}
+
+// Returns a serialized Sketch proto with `serialized_config` and the registers
+// that `for_each_register` passes to its callback.
+absl::StatusOr<std::string> SerializeRegisters(
+    const AnySketch& sketch, RegisterStream for_each_register,
+    absl::string_view serialized_config) {
+  std::vector<const Aggregator*> aggregators;
+  for (const ValueFunction& value_function : sketch.value_functions()) {
+    aggregators.push_back(&GetAggregator(value_function.aggregator_type));
+  }
+
+  std::string result;
+  {
+    StringOutputStream stream(&result);
+    CodedOutputStream output(&stream);
+    WriteLengthDelimitedHeader(kSketchConfigField, serialized_config.size(),
+                               output);
+    output.WriteRaw(serialized_config.data(), serialized_config.size());
+
+    std::vector<int64_t> encoded_values(aggregators.size());
+    absl::Status status;
+    RETURN_IF_ERROR(for_each_register([&](const AnySketch::Register& reg) {
+      if (!status.ok()) return;
+      if (reg.values.size() != aggregators.size()) {
+        status = absl::InvalidArgumentError(absl::StrCat(
+            "Register ", reg.index, " has ", reg.values.size(),
+            " values but the sketch has ", aggregators.size()));
+        return;
+      }
+      for (size_t i = 0; i < aggregators.size(); ++i) {
+        encoded_values[i] = aggregators[i]->EncodeToProtoValue(reg.values[i]);
+      }
+      WriteRegister(reg.index, encoded_values, output);
+    }));
+    RETURN_IF_ERROR(status);
+    if (output.HadError()) {
+      return absl::InternalError("Failed to serialize the Sketch proto.");
+    }
+  }
+  return result;
+}
+
+// Returns a RegisterStream over a range of Registers.
+template <typename RegisterRange>
+auto StreamRange(const RegisterRange& registers) {
+  return [&registers](RegisterCallback callback) {
+    for (const AnySketch::Register& reg : registers) callback(reg);
+    return absl::OkStatus();
+  };
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, absl::string_view serialized_config) {
+  return SerializeRegisters(sketch, StreamRange(sketch), serialized_config);
+}
+
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, absl::Span<const AnySketch::Register> registers,
+    absl::string_view serialized_config) {
+  return SerializeRegisters(sketch, StreamRange(registers), serialized_config);
+}
+
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, RegisterStream for_each_register,
+    absl::string_view serialized_config) {
+  return SerializeRegisters(sketch, for_each_register, serialized_config);
+}
+
+}  // namespace wfa::any_sketch
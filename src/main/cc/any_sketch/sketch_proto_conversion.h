@@ -0,0 +1,65 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SKETCH_PROTO_CONVERSION_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SKETCH_PROTO_CONVERSION_H_
+
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+
+// Conversion of an AnySketch to the wfa.any_sketch.Sketch proto.
+//
+// The generated wfa::any_sketch::Distribution message has the same name as the
+// Distribution class, so sketch.pb.h cannot be included together with
+// any_sketch.h. The conversion therefore works on serialized protos and writes
+// the Sketch wire format directly, without building a Sketch message.
+namespace wfa::any_sketch {
+
+// Returns `sketch` as a serialized Sketch proto, with `serialized_config` (a
+// serialized SketchConfig) as its config.
+//
+// Register values are encoded for the proto according to the aggregator of
+// their ValueFunction. The config is copied verbatim and is not checked
+// against the sketch.
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, absl::string_view serialized_config);
+
+// Like above, but with only `registers` of `sketch`, e.g. its
+// ChangedRegisters. The result is a delta sketch, which can be encrypted like
+// any other.
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, absl::Span<const AnySketch::Register> registers,
+    absl::string_view serialized_config);
+
+// Calls its argument on each register of a sketch, e.g. in the increasing
+// index order of SpillingSketch::ForEachSorted, and returns any error reading
+// them.
+using RegisterCallback = absl::FunctionRef<void(const AnySketch::Register&)>;
+using RegisterStream = absl::FunctionRef<absl::Status(RegisterCallback)>;
+
+// Like above, but with the registers of `for_each_register`, which need not
+// all be held in memory at once. `sketch` only provides the aggregators.
+absl::StatusOr<std::string> SerializeSketchProto(
+    const AnySketch& sketch, RegisterStream for_each_register,
+    absl::string_view serialized_config);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SKETCH_PROTO_CONVERSION_H_
@@ -0,0 +1,227 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_snapshot.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include "absl/container/fixed_array.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/mapped_file.h"
+#include "any_sketch/util.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+// The header: magic, format version and value count, register count and the
+// checksum of everything following the header.
+constexpr uint64_t kMagic = 0x50414e534b534e41;  // "ANSKSNAP"
+constexpr uint32_t kFormatVersion = 1;
+constexpr size_t kMagicOffset = 0;
+constexpr size_t kVersionOffset = 8;
+constexpr size_t kValueCountOffset = 12;
+constexpr size_t kRegisterCountOffset = 16;
+constexpr size_t kChecksumOffset = 24;
+constexpr size_t kHeaderSize = 32;
+
+constexpr size_t kWordSize = sizeof(uint64_t);
+
+// The aggregator types, one byte per value, padded to a whole word so that
+// the registers are aligned.
+size_t AggregatorsSize(size_t value_count) {
+  return (value_count + kWordSize - 1) / kWordSize * kWordSize;
+}
+
+size_t RecordSize(size_t value_count) {
+  return (1 + value_count) * kWordSize;
+}
+
+// A checksum of `data`, whose size is a multiple of kWordSize.
+uint64_t Checksum(absl::string_view data) {
+  uint64_t checksum = 0x9e3779b97f4a7c15;
+  for (size_t i = 0; i < data.size(); i += kWordSize) {
+    checksum ^= Load64(data.data() + i);
+    checksum *= 0xff51afd7ed558ccd;
+    checksum ^= checksum >> 32;
+  }
+  return checksum;
+}
+
+absl::Status WriteAll(int fd, absl::string_view data,
+                      const std::string& path) {
+  while (!data.empty()) {
+    const ssize_t written = write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return absl::UnavailableError(
+          absl::StrCat("Cannot write ", path, ": ", std::strerror(errno)));
+    }
+    data.remove_prefix(written);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WriteAndSync(const std::string& path, absl::string_view header,
+                          absl::string_view body) {
+  const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return absl::UnavailableError(
+        absl::StrCat("Cannot open ", path, ": ", std::strerror(errno)));
+  }
+  absl::Status status = WriteAll(fd, header, path);
+  if (status.ok()) status = WriteAll(fd, body, path);
+  if (status.ok() && fsync(fd) != 0) {
+    status = absl::UnavailableError(
+        absl::StrCat("Cannot sync ", path, ": ", std::strerror(errno)));
+  }
+  if (close(fd) != 0 && status.ok()) {
+    status = absl::UnavailableError(
+        absl::StrCat("Cannot close ", path, ": ", std::strerror(errno)));
+  }
+  return status;
+}
+
+}  // namespace
+
+SketchSnapshot SketchSnapshot::Capture(const AnySketch& sketch) {
+  absl::Span<const ValueFunction> value_functions = sketch.value_functions();
+  const size_t value_count = value_functions.size();
+  const size_t record_size = RecordSize(value_count);
+
+  SketchSnapshot snapshot;
+  snapshot.register_count_ = sketch.register_count();
+  snapshot.contents_.resize(kHeaderSize + AggregatorsSize(value_count) +
+                            snapshot.register_count_ * record_size);
+  char* data = snapshot.contents_.data();
+  Store64(kMagic, data + kMagicOffset);
+  Store32(kFormatVersion, data + kVersionOffset);
+  Store32(value_count, data + kValueCountOffset);
+  Store64(snapshot.register_count_, data + kRegisterCountOffset);
+  for (size_t i = 0; i < value_count; ++i) {
+    data[kHeaderSize + i] =
+        static_cast<char>(value_functions[i].aggregator_type);
+  }
+
+  char* record = data + kHeaderSize + AggregatorsSize(value_count);
+  for (const AnySketch::Register& sketch_register : sketch) {
+    Store64(sketch_register.index, record);
+    for (size_t i = 0; i < value_count; ++i) {
+      Store64(sketch_register.values[i], record + (i + 1) * kWordSize);
+    }
+    record += record_size;
+  }
+  return snapshot;
+}
+
+absl::Status SketchSnapshot::WriteToFile(const std::string& path) const {
+  absl::string_view contents = contents_;
+  std::string header(contents.substr(0, kHeaderSize));
+  Store64(Checksum(contents.substr(kHeaderSize)),
+          header.data() + kChecksumOffset);
+
+  const std::string temporary_path = absl::StrCat(path, ".tmp");
+  absl::Status status =
+      WriteAndSync(temporary_path, header, contents.substr(kHeaderSize));
+  if (status.ok() && std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    status = absl::UnavailableError(absl::StrCat(
+        "Cannot rename ", temporary_path, ": ", std::strerror(errno)));
+  }
+  if (!status.ok()) std::remove(temporary_path.c_str());
+  return status;
+}
+
+absl::Status RestoreSketchSnapshot(const std::string& path,
+                                   AnySketch& sketch) {
+  if (sketch.register_count() != 0) {
+    return absl::FailedPreconditionError(
+        "Snapshots can only be restored into an empty sketch.");
+  }
+  ASSIGN_OR_RETURN(MappedFile file, MappedFile::Open(path));
+  absl::string_view contents = file.contents();
+
+  if (contents.size() < kHeaderSize) {
+    return absl::DataLossError(
+        absl::StrCat("Snapshot ", path, " is truncated."));
+  }
+  const char* data = contents.data();
+  if (Load64(data + kMagicOffset) != kMagic) {
+    return absl::InvalidArgumentError(
+        absl::StrCat(path, " is not a sketch snapshot."));
+  }
+  const uint32_t version = Load32(data + kVersionOffset);
+  if (version != kFormatVersion) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported snapshot format version ", version, "."));
+  }
+  absl::Span<const ValueFunction> value_functions = sketch.value_functions();
+  const size_t value_count = Load32(data + kValueCountOffset);
+  if (value_count != value_functions.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The snapshot has ", value_count,
+                     " values but the sketch has ", value_functions.size()));
+  }
+  const uint64_t register_count =
+      Load64(data + kRegisterCountOffset);
+  const size_t record_size = RecordSize(value_count);
+  const size_t registers_offset = kHeaderSize + AggregatorsSize(value_count);
+  if (contents.size() < registers_offset ||
+      (contents.size() - registers_offset) / record_size != register_count ||
+      (contents.size() - registers_offset) % record_size != 0) {
+    return absl::DataLossError(absl::StrCat(
+        "Snapshot ", path, " has ", contents.size(), " bytes, which does not ",
+        "match its ", register_count, " registers."));
+  }
+  if (Load64(data + kChecksumOffset) !=
+      Checksum(contents.substr(kHeaderSize))) {
+    return absl::DataLossError(
+        absl::StrCat("Snapshot ", path, " is corrupted: bad checksum."));
+  }
+  for (size_t i = 0; i < value_count; ++i) {
+    if (data[kHeaderSize + i] !=
+        static_cast<char>(value_functions[i].aggregator_type)) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Value ", i, " of the snapshot has a different aggregator than the "
+          "sketch."));
+    }
+  }
+
+  sketch.Reserve(register_count);
+  absl::FixedArray<int64_t> values(value_count);
+  const char* record = data + registers_offset;
+  for (uint64_t i = 0; i < register_count; ++i) {
+    for (size_t j = 0; j < value_count; ++j) {
+      values[j] = Load64(record + (j + 1) * kWordSize);
+    }
+    RETURN_IF_ERROR(sketch.AggregateIntoRegister(
+        Load64(record), values));
+    record += record_size;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,71 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SKETCH_SNAPSHOT_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SKETCH_SNAPSHOT_H_
+
+#include <cstddef>
+#include <string>
+
+#include "absl/status/status.h"
+#include "any_sketch/any_sketch.h"
+
+// Checkpoints of the registers of an AnySketch, for restarting long-running
+// sketch builders.
+//
+// A snapshot file is a header followed by one fixed-size record per register:
+// its index and then its values, as 64-bit little-endian words, exactly as
+// they are held in memory. There is no per-register encoding, so capturing and
+// restoring are copies, and the file does not depend on where it is mapped.
+//
+// Snapshots are taken in two steps so that ingestion only stalls for the first:
+// Capture copies the registers into memory, and WriteToFile, which may run on
+// another thread while the sketch keeps changing, checksums and writes them.
+namespace wfa::any_sketch {
+
+class SketchSnapshot {
+ public:
+  // Copies the registers of `sketch`.
+  static SketchSnapshot Capture(const AnySketch& sketch);
+
+  SketchSnapshot(SketchSnapshot&&) = default;
+  SketchSnapshot& operator=(SketchSnapshot&&) = default;
+
+  // Writes the snapshot to `path`. The file is written under a temporary name,
+  // synced and then renamed, so `path` always holds a complete snapshot.
+  absl::Status WriteToFile(const std::string& path) const;
+
+  size_t register_count() const { return register_count_; }
+
+ private:
+  SketchSnapshot() = default;
+
+  size_t register_count_ = 0;
+  // The snapshot file, except for the checksum of the header.
+  std::string contents_;
+};
+
+// Restores the registers of the snapshot at `path` into `sketch`, which must be
+// empty and have the same values, with the same aggregators, as the sketch the
+// snapshot was captured from.
+//
+// The file is memory-mapped, and its size, format version, value aggregators
+// and checksum are validated before any register is restored. Distributions
+// are not recorded, so the caller must recreate the sketch from the same
+// config.
+absl::Status RestoreSketchSnapshot(const std::string& path, AnySketch& sketch);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SKETCH_SNAPSHOT_H_
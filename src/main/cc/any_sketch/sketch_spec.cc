@@ -0,0 +1,102 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The AnySketch side of sketch_spec.h. SketchConfig conversions are in
+// sketch_config_spec.cc.
+
+#include "any_sketch/sketch_spec.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/fingerprinters/fingerprinters.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+absl::StatusOr<std::unique_ptr<Distribution>> CreateDistribution(
+    const DistributionSpec& spec) {
+  if (spec.type == DistributionSpec::Type::kOracle) {
+    if (spec.feature_name.empty()) {
+      return absl::InvalidArgumentError(
+          "An oracle distribution needs a feature name.");
+    }
+    return GetOracleDistribution(spec.feature_name, 0,
+                                 std::numeric_limits<int64_t>::max() - 1);
+  }
+  if (spec.type == DistributionSpec::Type::kUniform && spec.num_values == 0) {
+    // Like an unset UniformDistribution.num_values, spans the int64 range.
+    return GetUniformDistribution(&GetFarmFingerprinter(), 0,
+                                  std::numeric_limits<int64_t>::max() - 1);
+  }
+  if (spec.num_values <= 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("A distribution needs a positive number of values, got ",
+                     spec.num_values, "."));
+  }
+  const Fingerprinter* fingerprinter = &GetFarmFingerprinter();
+  switch (spec.type) {
+    case DistributionSpec::Type::kUniform:
+      return GetUniformDistribution(fingerprinter, 0, spec.num_values - 1);
+    case DistributionSpec::Type::kExponential:
+      if (!(spec.rate > 0)) {
+        return absl::InvalidArgumentError(absl::StrCat(
+            "An exponential distribution needs a positive rate, got ",
+            spec.rate, "."));
+      }
+      return GetExponentialDistribution(fingerprinter, spec.rate,
+                                        spec.num_values);
+    case DistributionSpec::Type::kGeometric:
+      return GetGeometricDistribution(fingerprinter, 0, spec.num_values - 1);
+    case DistributionSpec::Type::kOracle:
+      break;
+  }
+  return absl::InvalidArgumentError("Unknown distribution type.");
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<AnySketch>> CreateAnySketch(
+    const SketchSpec& spec) {
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.reserve(spec.indexes.size());
+  for (const DistributionSpec& index : spec.indexes) {
+    ASSIGN_OR_RETURN(std::unique_ptr<Distribution> distribution,
+                     CreateDistribution(index));
+    indexes.push_back(std::move(distribution));
+  }
+  std::vector<ValueFunction> values;
+  values.reserve(spec.values.size());
+  for (const ValueSpec& value : spec.values) {
+    ASSIGN_OR_RETURN(std::unique_ptr<Distribution> distribution,
+                     CreateDistribution(value.distribution));
+    values.push_back({.name = value.name,
+                      .aggregator_type = value.aggregator_type,
+                      .distribution = std::move(distribution)});
+  }
+  return absl::make_unique<AnySketch>(std::move(indexes), std::move(values));
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,83 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SKETCH_SPEC_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SKETCH_SPEC_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/aggregators.h"
+
+// A description of the indexes and values of an AnySketch, from which sketches
+// can be created.
+//
+// This is the subset of the SketchConfig proto that AnySketch supports. It
+// exists because the generated wfa::any_sketch::Distribution message has the
+// same name as the Distribution class: this header includes neither, so that
+// it can be used on both sides.
+namespace wfa::any_sketch {
+
+class AnySketch;
+
+struct DistributionSpec {
+  enum class Type { kOracle, kUniform, kExponential, kGeometric };
+
+  Type type = Type::kUniform;
+  // The ItemMetadata key read by kOracle.
+  std::string feature_name;
+  // The number of values of the fingerprinting distributions, which return
+  // values in [0, num_values). 0 makes kUniform span the int64 range.
+  int64_t num_values = 0;
+  // The rate of kExponential.
+  double rate = 0;
+};
+
+struct ValueSpec {
+  std::string name;
+  AggregatorType aggregator_type = AggregatorType::kSum;
+  DistributionSpec distribution;
+};
+
+struct SketchSpec {
+  std::vector<DistributionSpec> indexes;
+  std::vector<ValueSpec> values;
+};
+
+// Returns an empty AnySketch with the indexes and values of `spec`.
+//
+// The fingerprinting distributions use the Farm fingerprinter. Oracle
+// distributions accept any non-negative value.
+absl::StatusOr<std::unique_ptr<AnySketch>> CreateAnySketch(
+    const SketchSpec& spec);
+
+// Returns the SketchSpec of `serialized_config`, a serialized SketchConfig.
+//
+// Fails for distributions that AnySketch does not implement: constant, Dirac
+// mixture, verbatim, salted distributions and geometric distributions with a
+// success probability other than 0.5.
+absl::StatusOr<SketchSpec> SketchSpecFromConfig(
+    absl::string_view serialized_config);
+
+// Returns the SketchConfig in text format `text_config`, serialized.
+absl::StatusOr<std::string> SerializeSketchConfigText(
+    absl::string_view text_config);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SKETCH_SPEC_H_
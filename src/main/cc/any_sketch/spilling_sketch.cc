@@ -0,0 +1,328 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/spilling_sketch.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/fixed_array.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/mapped_file.h"
+#include "any_sketch/sketch_proto_conversion.h"
+#include "any_sketch/util.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+// The header of a run: magic, value count and register count.
+constexpr uint64_t kRunMagic = 0x314e55524b534e41;  // "ANSKRUN1"
+constexpr size_t kValueCountOffset = 8;
+constexpr size_t kRegisterCountOffset = 16;
+constexpr size_t kRunHeaderSize = 24;
+
+constexpr size_t kWordSize = sizeof(uint64_t);
+// Words buffered per write of a run.
+constexpr size_t kWriteBufferWords = 8192;
+
+// Buffers the words of a run and writes them to its file.
+class RunWriter {
+ public:
+  RunWriter(int fd, const std::string& path)
+      : fd_(fd), path_(path), buffer_(kWriteBufferWords * kWordSize) {}
+
+  absl::Status Write(uint64_t word) {
+    if (size_ == buffer_.size()) RETURN_IF_ERROR(Flush());
+    Store64(word, buffer_.data() + size_);
+    size_ += kWordSize;
+    return absl::OkStatus();
+  }
+
+  absl::Status Flush() {
+    const char* data = buffer_.data();
+    size_t remaining = size_;
+    while (remaining > 0) {
+      const ssize_t written = write(fd_, data, remaining);
+      if (written < 0) {
+        if (errno == EINTR) continue;
+        return absl::UnavailableError(
+            absl::StrCat("Cannot write ", path_, ": ", std::strerror(errno)));
+      }
+      data += written;
+      remaining -= written;
+    }
+    size_ = 0;
+    return absl::OkStatus();
+  }
+
+ private:
+  const int fd_;
+  const std::string& path_;
+  std::vector<char> buffer_;
+  size_t size_ = 0;
+};
+
+// Writes the header and columns of a run of `registers` to `fd`.
+absl::Status WriteRun(absl::Span<const AnySketch::Register> registers,
+                      size_t value_count, int fd, const std::string& path) {
+  RunWriter writer(fd, path);
+  RETURN_IF_ERROR(writer.Write(kRunMagic));
+  RETURN_IF_ERROR(writer.Write(value_count));
+  RETURN_IF_ERROR(writer.Write(registers.size()));
+  for (const AnySketch::Register& reg : registers) {
+    RETURN_IF_ERROR(writer.Write(reg.index));
+  }
+  for (size_t i = 0; i < value_count; ++i) {
+    for (const AnySketch::Register& reg : registers) {
+      RETURN_IF_ERROR(writer.Write(reg.values[i]));
+    }
+  }
+  return writer.Flush();
+}
+
+// A position in a sorted source of registers: a mapped run or the in-memory
+// registers.
+struct Cursor {
+  // The columns of a run, or null for in-memory registers.
+  const char* columns = nullptr;
+  absl::Span<const AnySketch::Register> registers;
+  size_t size = 0;
+  size_t position = 0;
+
+  uint64_t index() const {
+    return columns != nullptr ? Load64(columns + position * kWordSize)
+                              : registers[position].index;
+  }
+
+  int64_t value(size_t i) const {
+    return columns != nullptr
+               ? Load64(columns + ((i + 1) * size + position) * kWordSize)
+               : registers[position].values[i];
+  }
+};
+
+// Validates the run `file` and returns a cursor over its registers.
+absl::StatusOr<Cursor> OpenRun(const MappedFile& file, size_t value_count,
+                               const std::string& path) {
+  absl::string_view contents = file.contents();
+  if (contents.size() < kRunHeaderSize ||
+      Load64(contents.data()) != kRunMagic) {
+    return absl::DataLossError(absl::StrCat(path, " is not a spilled run."));
+  }
+  const uint64_t run_value_count =
+      Load64(contents.data() + kValueCountOffset);
+  const uint64_t register_count =
+      Load64(contents.data() + kRegisterCountOffset);
+  if (run_value_count != value_count ||
+      contents.size() !=
+          kRunHeaderSize + (1 + value_count) * register_count * kWordSize) {
+    return absl::DataLossError(absl::StrCat(
+        "Spilled run ", path, " has ", contents.size(), " bytes, which does "
+        "not match its ", register_count, " registers."));
+  }
+  Cursor cursor;
+  cursor.columns = contents.data() + kRunHeaderSize;
+  cursor.size = register_count;
+  return cursor;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<SpillingSketch>> SpillingSketch::Create(
+    const SpillingSketchOptions& options, AnySketchFactory sketch_factory) {
+  if (sketch_factory == nullptr) {
+    return absl::InvalidArgumentError("The sketch factory is empty.");
+  }
+
+  // Measures the bytes of a table slot and of the values a register keeps
+  // outside of it.
+  std::unique_ptr<AnySketch> probe = sketch_factory();
+  RETURN_IF_ERROR(probe->AggregateIntoRegister(
+      0, std::vector<int64_t>(probe->value_functions().size())));
+  const AnySketchStats probe_stats = probe->Stats();
+  const size_t slot_bytes = probe_stats.slot_bytes;
+  const size_t value_bytes = probe_stats.value_bytes;
+
+  // Tables fill up to 7/8 of their capacity, which is rounded up to a power of
+  // two, so each register may need 16/7 slots.
+  const size_t budget = options.memory_budget_bytes;
+  const size_t register_count =
+      budget * 7 / (slot_bytes * 16 + value_bytes * 7);
+  if (register_count == 0) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "The memory budget of ", budget, " bytes cannot hold a register."));
+  }
+  // Spills once the allocated table is full, unless the values of that many
+  // registers exceed the budget.
+  std::unique_ptr<AnySketch> sketch = sketch_factory();
+  sketch->Reserve(register_count);
+  const AnySketchStats stats = sketch->Stats();
+  size_t spill_register_count = stats.capacity / 8 * 7;
+  if (value_bytes > 0 && stats.table_bytes < budget) {
+    spill_register_count = std::min(
+        spill_register_count, (budget - stats.table_bytes) / value_bytes);
+  }
+  spill_register_count = std::max(spill_register_count, register_count);
+
+  return absl::WrapUnique(new SpillingSketch(options, std::move(sketch_factory),
+                                             std::move(sketch),
+                                             spill_register_count));
+}
+
+SpillingSketch::SpillingSketch(const SpillingSketchOptions& options,
+                               AnySketchFactory sketch_factory,
+                               std::unique_ptr<AnySketch> sketch,
+                               size_t spill_register_count)
+    : spill_directory_(options.spill_directory),
+      sketch_factory_(std::move(sketch_factory)),
+      spill_register_count_(spill_register_count),
+      sketch_(std::move(sketch)) {}
+
+SpillingSketch::~SpillingSketch() {
+  for (const std::string& path : run_paths_) {
+    std::remove(path.c_str());
+  }
+}
+
+absl::Status SpillingSketch::Insert(absl::string_view item,
+                                    const ItemMetadata& item_metadata) {
+  RETURN_IF_ERROR(sketch_->Insert(item, item_metadata));
+  return SpillIfFull();
+}
+
+absl::Status SpillingSketch::AggregateIntoRegister(
+    int64_t index, absl::Span<const int64_t> values) {
+  RETURN_IF_ERROR(sketch_->AggregateIntoRegister(index, values));
+  return SpillIfFull();
+}
+
+absl::Status SpillingSketch::SpillIfFull() {
+  if (sketch_->register_count() < spill_register_count_) {
+    return absl::OkStatus();
+  }
+  return Spill();
+}
+
+absl::Status SpillingSketch::Spill() {
+  if (sketch_->register_count() == 0) return absl::OkStatus();
+
+  std::string path = absl::StrCat(spill_directory_, "/any_sketch_run_XXXXXX");
+  const int fd = mkstemp(path.data());
+  if (fd < 0) {
+    return absl::UnavailableError(absl::StrCat(
+        "Cannot create a run in ", spill_directory_, ": ",
+        std::strerror(errno)));
+  }
+  absl::Status status =
+      WriteRun(sketch_->SortedRegisters(), value_functions().size(), fd, path);
+  if (close(fd) != 0 && status.ok()) {
+    status = absl::UnavailableError(
+        absl::StrCat("Cannot close ", path, ": ", std::strerror(errno)));
+  }
+  if (!status.ok()) {
+    std::remove(path.c_str());
+    return status;
+  }
+  run_paths_.push_back(std::move(path));
+
+  sketch_ = sketch_factory_();
+  sketch_->Reserve(spill_register_count_);
+  return absl::OkStatus();
+}
+
+absl::Status SpillingSketch::ForEachSorted(RegisterCallback fn) const {
+  const size_t value_count = value_functions().size();
+  std::vector<const Aggregator*> aggregators;
+  for (const ValueFunction& value_function : value_functions()) {
+    aggregators.push_back(&GetAggregator(value_function.aggregator_type));
+  }
+
+  std::vector<MappedFile> files;
+  files.reserve(run_paths_.size());
+  std::vector<Cursor> cursors;
+  cursors.reserve(run_paths_.size() + 1);
+  for (const std::string& path : run_paths_) {
+    ASSIGN_OR_RETURN(MappedFile file, MappedFile::Open(path));
+    files.push_back(std::move(file));
+    ASSIGN_OR_RETURN(Cursor cursor,
+                     OpenRun(files.back(), value_count, path));
+    cursors.push_back(cursor);
+  }
+  const std::vector<AnySketch::Register> in_memory = sketch_->SortedRegisters();
+  Cursor& in_memory_cursor = cursors.emplace_back();
+  in_memory_cursor.registers = in_memory;
+  in_memory_cursor.size = in_memory.size();
+
+  // The smallest current index of each non-exhausted cursor.
+  using Entry = std::pair<uint64_t, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  for (size_t i = 0; i < cursors.size(); ++i) {
+    if (cursors[i].size > 0) heap.emplace(cursors[i].index(), i);
+  }
+  auto advance = [&cursors, &heap](size_t i) {
+    Cursor& cursor = cursors[i];
+    if (++cursor.position < cursor.size) heap.emplace(cursor.index(), i);
+  };
+
+  absl::FixedArray<int64_t> values(value_count);
+  while (!heap.empty()) {
+    const auto [index, first] = heap.top();
+    heap.pop();
+    for (size_t i = 0; i < value_count; ++i) {
+      values[i] = cursors[first].value(i);
+    }
+    advance(first);
+    // The other sources holding the index, each of which has it once.
+    while (!heap.empty() && heap.top().first == index) {
+      const size_t next = heap.top().second;
+      heap.pop();
+      for (size_t i = 0; i < value_count; ++i) {
+        values[i] =
+            aggregators[i]->Aggregate(values[i], cursors[next].value(i));
+      }
+      advance(next);
+    }
+    fn(AnySketch::Register{.index = index, .values = values});
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> SpillingSketch::SerializeSketchProto(
+    absl::string_view serialized_config) const {
+  return ::wfa::any_sketch::SerializeSketchProto(
+      *sketch_, [this](RegisterCallback fn) { return ForEachSorted(fn); },
+      serialized_config);
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,124 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_SPILLING_SKETCH_H_
+#define SRC_MAIN_CC_ANY_SKETCH_SPILLING_SKETCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/sketch_proto_conversion.h"
+
+namespace wfa::any_sketch {
+
+struct SpillingSketchOptions {
+  // Bytes that the in-memory register table may use. The table is allocated
+  // up front at the largest size that fits. Spilling the table and reading the
+  // registers each sort a copy of the in-memory registers, which takes another
+  // sizeof(AnySketch::Register) bytes per register outside of this budget.
+  size_t memory_budget_bytes = size_t{1} << 30;
+  // Directory of the spilled runs, which are deleted with the sketch.
+  std::string spill_directory = "/tmp";
+};
+
+// An AnySketch whose registers may outgrow memory, e.g. for indexes spread
+// uniformly over 2^40 buckets.
+//
+// Registers are aggregated into an in-memory AnySketch until its table is
+// full. It is then spilled: its registers are written to a file as a run in
+// increasing index order, and a new empty table takes its place. The runs and
+// the table are combined by a k-way merge whenever the registers are read, so
+// that each index is aggregated across them with the aggregators of its values
+// and the result equals that of a single AnySketch with the same inserts.
+//
+// A run is columnar: a header, then the indexes, then each value, as 64-bit
+// little-endian words. Runs are memory-mapped while merged, so reading the
+// registers keeps one page per run resident rather than the whole sketch.
+class SpillingSketch {
+ public:
+  // Creates an empty sketch whose in-memory tables are made by
+  // `sketch_factory`.
+  static absl::StatusOr<std::unique_ptr<SpillingSketch>> Create(
+      const SpillingSketchOptions& options, AnySketchFactory sketch_factory);
+
+  SpillingSketch(const SpillingSketch&) = delete;
+  SpillingSketch& operator=(const SpillingSketch&) = delete;
+
+  // Deletes the spilled runs.
+  ~SpillingSketch();
+
+  // Adds `item` to the sketch. See AnySketch::Insert.
+  ABSL_MUST_USE_RESULT absl::Status Insert(absl::string_view item,
+                                           const ItemMetadata& item_metadata);
+
+  // Merges a set of values into a register. See
+  // AnySketch::AggregateIntoRegister.
+  ABSL_MUST_USE_RESULT absl::Status AggregateIntoRegister(
+      int64_t index, absl::Span<const int64_t> values);
+
+  // Writes the in-memory registers to a new run, leaving the table empty.
+  // Called automatically when the table is full.
+  ABSL_MUST_USE_RESULT absl::Status Spill();
+
+  // Calls `fn` on each register in increasing index order, merging the runs
+  // and the in-memory table. The values passed to `fn` are only valid during
+  // the call.
+  ABSL_MUST_USE_RESULT absl::Status ForEachSorted(RegisterCallback fn) const;
+
+  // Returns the sketch as a serialized Sketch proto. See SerializeSketchProto.
+  absl::StatusOr<std::string> SerializeSketchProto(
+      absl::string_view serialized_config) const;
+
+  // Returns the number of registers held in memory.
+  size_t in_memory_register_count() const { return sketch_->register_count(); }
+
+  // Returns the number of registers at which the in-memory table is spilled.
+  size_t spill_register_count() const { return spill_register_count_; }
+
+  // Returns the number of spilled runs.
+  int run_count() const { return static_cast<int>(run_paths_.size()); }
+
+  absl::Span<const ValueFunction> value_functions() const {
+    return sketch_->value_functions();
+  }
+
+ private:
+  SpillingSketch(const SpillingSketchOptions& options,
+                 AnySketchFactory sketch_factory,
+                 std::unique_ptr<AnySketch> sketch,
+                 size_t spill_register_count);
+
+  // Spills the table if it is full.
+  absl::Status SpillIfFull();
+
+  const std::string spill_directory_;
+  const AnySketchFactory sketch_factory_;
+  const size_t spill_register_count_;
+
+  std::unique_ptr<AnySketch> sketch_;
+  std::vector<std::string> run_paths_;
+};
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_SPILLING_SKETCH_H_
@@ -0,0 +1,163 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/tracing.h"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+ABSL_CONST_INIT absl::Mutex callback_mutex(absl::kConstInit);
+TraceSpanCallback* installed_callback ABSL_GUARDED_BY(callback_mutex) =
+    nullptr;
+
+ABSL_CONST_INIT absl::Mutex file_mutex(absl::kConstInit);
+
+TraceSpanCallback GetTraceSpanCallback() {
+  absl::MutexLock lock(&callback_mutex);
+  return installed_callback == nullptr ? nullptr : *installed_callback;
+}
+
+void AppendJsonString(absl::string_view value, std::string& out) {
+  out.push_back('"');
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      absl::StrAppend(
+          &out, "\\u00",
+          absl::Hex(static_cast<unsigned char>(c), absl::kZeroPad2));
+    } else {
+      out.push_back(c);
+    }
+  }
+  out.push_back('"');
+}
+
+}  // namespace
+
+void SetTraceSpanCallback(TraceSpanCallback callback) {
+  auto* new_callback =
+      callback ? new TraceSpanCallback(std::move(callback)) : nullptr;
+  TraceSpanCallback* old_callback;
+  {
+    absl::MutexLock lock(&callback_mutex);
+    old_callback = installed_callback;
+    installed_callback = new_callback;
+  }
+  delete old_callback;
+}
+
+std::string FormatChromeTraceEvents(absl::Span<const TraceSpan> spans) {
+  // Spans are attributed to the calling thread, which is the thread that ran
+  // them when called from Tracer::Flush.
+  const int64_t pid = getpid();
+  const uint64_t tid = std::hash<std::thread::id>()(std::this_thread::get_id());
+  std::string out;
+  for (const TraceSpan& span : spans) {
+    out.append("{\"name\":");
+    AppendJsonString(span.name, out);
+    absl::StrAppend(&out, ",\"ph\":\"X\",\"pid\":", pid, ",\"tid\":", tid,
+                    ",\"ts\":", absl::ToUnixMicros(span.start),
+                    ",\"dur\":", absl::ToDoubleMicroseconds(span.duration),
+                    ",\"args\":{");
+    for (size_t i = 0; i < span.args.size(); ++i) {
+      if (i > 0) out.push_back(',');
+      AppendJsonString(span.args[i].first, out);
+      absl::StrAppend(&out, ":", span.args[i].second);
+    }
+    out.append("}},\n");
+  }
+  return out;
+}
+
+absl::Status AppendChromeTrace(absl::string_view path,
+                               absl::Span<const TraceSpan> spans) {
+  std::string events = FormatChromeTraceEvents(spans);
+  absl::MutexLock lock(&file_mutex);
+  std::ofstream out(std::string(path), std::ios::app);
+  if (!out) {
+    return absl::UnavailableError(
+        absl::StrCat("Cannot open trace file ", path));
+  }
+  out.seekp(0, std::ios::end);
+  if (out.tellp() == 0) {
+    out << "[\n";
+  }
+  out << events;
+  out.flush();
+  if (!out) {
+    return absl::UnavailableError(
+        absl::StrCat("Cannot write trace file ", path));
+  }
+  return absl::OkStatus();
+}
+
+Tracer::Tracer(std::string chrome_trace_path)
+    : callback_(GetTraceSpanCallback()), path_(std::move(chrome_trace_path)) {}
+
+void Tracer::Record(TraceSpan span) {
+  if (callback_ != nullptr) {
+    callback_(span);
+  }
+  if (!path_.empty()) {
+    spans_.push_back(std::move(span));
+  }
+}
+
+absl::Status Tracer::Flush() {
+  if (path_.empty() || spans_.empty()) {
+    return absl::OkStatus();
+  }
+  absl::Status status = AppendChromeTrace(path_, spans_);
+  spans_.clear();
+  return status;
+}
+
+ScopedTraceSpan::ScopedTraceSpan(Tracer& tracer, absl::string_view name)
+    : tracer_(tracer.enabled() ? &tracer : nullptr) {
+  if (tracer_ != nullptr) {
+    span_.name = std::string(name);
+    span_.start = absl::Now();
+  }
+}
+
+ScopedTraceSpan::~ScopedTraceSpan() {
+  if (tracer_ != nullptr) {
+    span_.duration = absl::Now() - span_.start;
+    tracer_->Record(std::move(span_));
+  }
+}
+
+void ScopedTraceSpan::AddArg(absl::string_view key, int64_t value) {
+  if (tracer_ != nullptr) {
+    span_.args.emplace_back(std::string(key), value);
+  }
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,104 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_TRACING_H_
+#define SRC_MAIN_CC_ANY_SKETCH_TRACING_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+
+// Lightweight tracing of the stages of a call.
+//
+// A Tracer is created per call and is enabled when a process-wide span
+// callback is installed or when it is given a Chrome trace file. When disabled,
+// ScopedTraceSpan does not read the clock or allocate.
+namespace wfa::any_sketch {
+
+// A completed stage of a traced call.
+struct TraceSpan {
+  std::string name;
+  absl::Time start;
+  absl::Duration duration;
+  // Sizes and counts attached to the span, e.g. {"request_bytes", 1024}.
+  std::vector<std::pair<std::string, int64_t>> args;
+};
+
+using TraceSpanCallback = std::function<void(const TraceSpan&)>;
+
+// Installs `callback` to receive every span recorded by Tracers created after
+// this call. An empty callback uninstalls it. The callback may be invoked
+// concurrently from multiple threads.
+void SetTraceSpanCallback(TraceSpanCallback callback);
+
+// Formats `spans` as Chrome trace events ("ph": "X"), each followed by ",\n".
+//
+// This is the body of the Chrome JSON array format, which does not require the
+// closing bracket, so events can be appended to a trace file across calls.
+std::string FormatChromeTraceEvents(absl::Span<const TraceSpan> spans);
+
+// Appends `spans` to the Chrome trace file at `path`, starting the JSON array
+// if the file is empty. Appends are serialized within the process.
+absl::Status AppendChromeTrace(absl::string_view path,
+                               absl::Span<const TraceSpan> spans);
+
+class Tracer {
+ public:
+  // Creates a Tracer that reports to the installed span callback, if any, and
+  // writes a Chrome trace to `chrome_trace_path` on Flush if it is not empty.
+  explicit Tracer(std::string chrome_trace_path = "");
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  bool enabled() const { return callback_ != nullptr || !path_.empty(); }
+
+  // Reports `span` to the callback and keeps it for the trace file.
+  void Record(TraceSpan span);
+
+  // Appends the recorded spans to the Chrome trace file, if any.
+  absl::Status Flush();
+
+ private:
+  TraceSpanCallback callback_;
+  std::string path_;
+  std::vector<TraceSpan> spans_;
+};
+
+// Records a span named `name` covering the lifetime of this object.
+class ScopedTraceSpan {
+ public:
+  ScopedTraceSpan(Tracer& tracer, absl::string_view name);
+  ~ScopedTraceSpan();
+
+  ScopedTraceSpan(const ScopedTraceSpan&) = delete;
+  ScopedTraceSpan& operator=(const ScopedTraceSpan&) = delete;
+
+  void AddArg(absl::string_view key, int64_t value);
+
+ private:
+  Tracer* tracer_;  // Null when tracing is disabled.
+  TraceSpan span_;
+};
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_TRACING_H_
@@ -0,0 +1,49 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/util.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+
+absl::Status ForEachSlice(
+    int thread_count, int64_t size,
+    absl::FunctionRef<absl::Status(int64_t begin, int64_t end)> fn) {
+  thread_count =
+      static_cast<int>(std::clamp<int64_t>(size, 1, std::max(thread_count, 1)));
+  if (thread_count == 1) return fn(0, size);
+
+  std::vector<absl::Status> statuses(thread_count);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (int i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&, i]() {
+      statuses[i] = fn(size * i / thread_count, size * (i + 1) / thread_count);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const absl::Status& status : statuses) {
+    RETURN_IF_ERROR(status);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,75 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_UTIL_H_
+#define SRC_MAIN_CC_ANY_SKETCH_UTIL_H_
+
+#include <cstdint>
+#include <cstring>
+
+#include "absl/base/config.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+
+// Helpers shared by the binary formats and the parallel loops of any_sketch.
+namespace wfa::any_sketch {
+
+namespace internal {
+
+template <typename T>
+T ToLittleEndian(T value) {
+#ifdef ABSL_IS_BIG_ENDIAN
+  if constexpr (sizeof(T) == 8) return __builtin_bswap64(value);
+  if constexpr (sizeof(T) == 4) return __builtin_bswap32(value);
+#endif
+  return value;
+}
+
+}  // namespace internal
+
+// Returns the little-endian integer at `data`, which need not be aligned.
+inline uint32_t Load32(const void* data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return internal::ToLittleEndian(value);
+}
+
+inline uint64_t Load64(const void* data) {
+  uint64_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return internal::ToLittleEndian(value);
+}
+
+// Writes `value` to `data` as a little-endian integer. `data` need not be
+// aligned.
+inline void Store32(uint32_t value, void* data) {
+  value = internal::ToLittleEndian(value);
+  std::memcpy(data, &value, sizeof(value));
+}
+
+inline void Store64(uint64_t value, void* data) {
+  value = internal::ToLittleEndian(value);
+  std::memcpy(data, &value, sizeof(value));
+}
+
+// Calls `fn` on `thread_count` contiguous slices of [0, size), each on a
+// thread of its own, and returns the first error. Runs `fn` on the calling
+// thread if there is a single slice.
+absl::Status ForEachSlice(
+    int thread_count, int64_t size,
+    absl::FunctionRef<absl::Status(int64_t begin, int64_t end)> fn);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_UTIL_H_
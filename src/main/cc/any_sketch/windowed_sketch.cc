@@ -0,0 +1,103 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/windowed_sketch.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/macros/macros.h"
+
+namespace wfa::any_sketch {
+
+absl::StatusOr<std::unique_ptr<WindowedSketch>> WindowedSketch::Create(
+    int window_size, SketchFactory sketch_factory) {
+  if (window_size < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("The window size should be positive but is ",
+                     window_size));
+  }
+  if (sketch_factory == nullptr) {
+    return absl::InvalidArgumentError("The sketch factory is empty.");
+  }
+  return absl::WrapUnique(
+      new WindowedSketch(window_size, std::move(sketch_factory)));
+}
+
+WindowedSketch::WindowedSketch(int window_size, SketchFactory sketch_factory)
+    : window_size_(window_size),
+      sketch_factory_(std::move(sketch_factory)),
+      back_merge_(sketch_factory_()),
+      current_(sketch_factory_()) {}
+
+absl::Status WindowedSketch::Insert(absl::string_view item,
+                                    const ItemMetadata& item_metadata) {
+  return current_->Insert(item, item_metadata);
+}
+
+absl::Status WindowedSketch::Flip() {
+  // Each bucket, newest first, becomes the merge of itself and the newer ones.
+  while (!back_.empty()) {
+    std::unique_ptr<AnySketch> bucket = std::move(back_.back());
+    back_.pop_back();
+    if (!front_.empty()) {
+      RETURN_IF_ERROR(bucket->Merge(*front_.back()));
+      ++advance_merge_count_;
+    }
+    front_.push_back(std::move(bucket));
+  }
+  back_merge_ = sketch_factory_();
+  return absl::OkStatus();
+}
+
+absl::Status WindowedSketch::Advance() {
+  RETURN_IF_ERROR(back_merge_->Merge(*current_));
+  ++advance_merge_count_;
+  back_.push_back(std::move(current_));
+  current_ = sketch_factory_();
+
+  if (bucket_count() > window_size_) {
+    if (front_.empty()) {
+      RETURN_IF_ERROR(Flip());
+    }
+    front_.pop_back();
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<AnySketch>> WindowedSketch::Query() const {
+  std::unique_ptr<AnySketch> result = sketch_factory_();
+  // The union has at least as many registers as its largest part, so this
+  // saves rehashing the result while it grows.
+  const size_t front_register_count =
+      front_.empty() ? 0 : front_.back()->register_count();
+  result->Reserve(std::max({front_register_count,
+                            back_merge_->register_count(),
+                            current_->register_count()}));
+  if (!front_.empty()) {
+    RETURN_IF_ERROR(result->Merge(*front_.back()));
+  }
+  RETURN_IF_ERROR(result->Merge(*back_merge_));
+  RETURN_IF_ERROR(result->Merge(*current_));
+  return result;
+}
+
+}  // namespace wfa::any_sketch
@@ -0,0 +1,104 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MAIN_CC_ANY_SKETCH_WINDOWED_SKETCH_H_
+#define SRC_MAIN_CC_ANY_SKETCH_WINDOWED_SKETCH_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+
+namespace wfa::any_sketch {
+
+// A sliding window over the most recent buckets of a stream of items, e.g. one
+// bucket per day, whose union is available as a single sketch.
+//
+// The window is a queue of per-bucket sketches kept as two stacks. Buckets are
+// pushed onto the back stack, which keeps the running merge of its buckets.
+// The front stack holds, for each of its buckets, the merge of that bucket and
+// every newer bucket in the stack. When a bucket leaves the window, the top of
+// the front stack is dropped; if the front stack is empty, the back stack is
+// first moved onto it. Each bucket is merged at most twice on its way through,
+// so sliding the window costs at most two merges amortized, and Query costs
+// three, whatever the size of the window.
+//
+// Aggregation of register values is associative and commutative, so the
+// result equals merging the buckets in order with AnySketch::MergeAll,
+// including destroyed UNIQUE values.
+class WindowedSketch {
+ public:
+  using SketchFactory = AnySketchFactory;
+
+  // Creates a window of `window_size` buckets, the newest of which is the
+  // current bucket, receiving the inserted items.
+  static absl::StatusOr<std::unique_ptr<WindowedSketch>> Create(
+      int window_size, SketchFactory sketch_factory);
+
+  WindowedSketch(const WindowedSketch&) = delete;
+  WindowedSketch& operator=(const WindowedSketch&) = delete;
+
+  // Adds `item` to the current bucket. See AnySketch::Insert.
+  ABSL_MUST_USE_RESULT absl::Status Insert(absl::string_view item,
+                                           const ItemMetadata& item_metadata);
+
+  // Returns the current bucket, e.g. to aggregate registers into it directly.
+  AnySketch& current_bucket() { return *current_; }
+
+  // Closes the current bucket and starts a new one. Once the window is full,
+  // its oldest bucket leaves it.
+  ABSL_MUST_USE_RESULT absl::Status Advance();
+
+  // Returns a sketch of the union of the buckets in the window.
+  absl::StatusOr<std::unique_ptr<AnySketch>> Query() const;
+
+  int window_size() const { return window_size_; }
+
+  // Returns the number of buckets in the window, including the current one.
+  int bucket_count() const {
+    return static_cast<int>(front_.size() + back_.size()) + 1;
+  }
+
+  // Returns the number of AnySketch::Merge calls made by Advance so far.
+  int64_t advance_merge_count() const { return advance_merge_count_; }
+
+ private:
+  WindowedSketch(int window_size, SketchFactory sketch_factory);
+
+  // Moves the buckets of the back stack onto the front stack.
+  absl::Status Flip();
+
+  const int window_size_;
+  const SketchFactory sketch_factory_;
+
+  // Merges of each bucket of the front stack and the newer buckets below it.
+  // The oldest bucket of the window is at the back.
+  std::vector<std::unique_ptr<AnySketch>> front_;
+  // Closed buckets newer than those of the front stack, oldest first.
+  std::vector<std::unique_ptr<AnySketch>> back_;
+  // The merge of the buckets of back_.
+  std::unique_ptr<AnySketch> back_merge_;
+  std::unique_ptr<AnySketch> current_;
+
+  int64_t advance_merge_count_ = 0;
+};
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_MAIN_CC_ANY_SKETCH_WINDOWED_SKETCH_H_
@@ -51,6 +51,7 @@ DistributedDiscreteGaussianNoiser::GenerateNoiseComponent() const {
   double p_bernoulli;
 
   while (true) {
+    rejection_iteration_count_.fetch_add(1, std::memory_order_relaxed);
     y = geometric_distribution(rnd) - geometric_distribution(rnd);
     p_bernoulli = exp(-pow((std::abs(y) - sigma_sq / t), 2.0) * 0.5 / sigma_sq);
     std::binomial_distribution<int> binomial_distribution(1, p_bernoulli);
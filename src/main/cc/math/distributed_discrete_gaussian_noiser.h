@@ -15,6 +15,9 @@
 #ifndef SRC_MAIN_CC_MATH_DISTRIBUTED_DISCRETE_GAUSSIAN_NOISER_H_
 #define SRC_MAIN_CC_MATH_DISTRIBUTED_DISCRETE_GAUSSIAN_NOISER_H_
 
+#include <atomic>
+#include <cstdint>
+
 #include "math/distributed_noiser.h"
 
 namespace wfa::math {
@@ -48,6 +51,15 @@ class DistributedDiscreteGaussianNoiser
    * https://github.com/world-federation-of-advertisers/cardinality_estimation_evaluation_framework/blob/master/src/common/noisers.py#L207
    */
   [[nodiscard]] absl::StatusOr<int64_t> GenerateNoiseComponent() const override;
+
+  // Returns the total number of iterations of the rejection sampling loop run
+  // by GenerateNoiseComponent so far.
+  int64_t rejection_iteration_count() const {
+    return rejection_iteration_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  mutable std::atomic<int64_t> rejection_iteration_count_ = 0;
 };
 }  // namespace wfa::math
 
@@ -21,7 +21,7 @@
 
 namespace wfa::math {
 
-double expint(double x) { return std::expint(x); }
+inline double expint(double x) { return std::expint(x); }
 
 }  // namespace wfa::math
 
@@ -31,7 +31,7 @@ double expint(double x) { return std::expint(x); }
 
 namespace wfa::math {
 
-double expint(double x) { return llvm::expint(x); }
+inline double expint(double x) { return llvm::expint(x); }
 
 }  // namespace wfa::math
 
@@ -16,8 +16,10 @@
 
 #include <cstdint>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/fixed_array.h"
 #include "absl/memory/memory.h"
@@ -25,17 +27,23 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/span.h"
+#include "common_cpp/testing/status_macros.h"
 #include "common_cpp/testing/status_matchers.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 namespace wfa::any_sketch {
 namespace {
+using ::testing::AnyOf;
+using ::testing::ElementsAre;
 using ::testing::ExplainMatchResult;
+using ::testing::HasSubstr;
 using ::testing::IsEmpty;
 using ::testing::Matcher;
 using ::testing::MatcherInterface;
 using ::testing::MatchResultListener;
+using ::testing::Pair;
+using ::testing::SizeIs;
 using ::testing::UnorderedElementsAre;
 
 class RegisterIsMatcher : public MatcherInterface<const AnySketch::Register&> {
@@ -193,5 +201,310 @@ TEST(AnySketchTest, Merge) {
               UnorderedElementsAre(RegisterIs(1, {12}), RegisterIs(2, {6}),
                                    RegisterIs(3, {8})));
 }
+
+TEST(AnySketchTest, SortedRegistersAreInIndexOrder) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  ASSERT_THAT(sketch.AggregateIntoRegister(30, {3}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(10, {1}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(20, {2}), IsOk());
+
+  EXPECT_THAT(sketch.SortedRegisters(),
+              ElementsAre(RegisterIs(10, {1}), RegisterIs(20, {2}),
+                          RegisterIs(30, {3})));
+
+  std::vector<uint64_t> indexes;
+  sketch.ForEachSorted([&indexes](const AnySketch::Register& sketch_register) {
+    indexes.push_back(sketch_register.index);
+  });
+  EXPECT_THAT(indexes, ElementsAre(10, 20, 30));
+}
+
+TEST(AnySketchTest, PartitionSplitsRegistersIntoOrderedDisjointRanges) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  for (int64_t i = 0; i < 1000; ++i) {
+    ASSERT_THAT(sketch.AggregateIntoRegister((i * 7919) % 1000, {i}), IsOk());
+  }
+
+  std::vector<std::vector<AnySketch::Register>> partitions =
+      sketch.Partition(3);
+
+  ASSERT_THAT(partitions, SizeIs(3));
+  std::vector<uint64_t> indexes;
+  for (const std::vector<AnySketch::Register>& partition : partitions) {
+    EXPECT_THAT(partition, SizeIs(AnyOf(333, 334)));
+    for (const AnySketch::Register& sketch_register : partition) {
+      indexes.push_back(sketch_register.index);
+    }
+  }
+  std::vector<uint64_t> expected(1000);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(indexes, expected);
+}
+
+TEST(AnySketchTest, PartitionReturnsNoMorePartitionsThanRegisters) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+
+  EXPECT_THAT(sketch.Partition(4), IsEmpty());
+
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {1}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(2, {1}), IsOk());
+
+  EXPECT_THAT(sketch.Partition(4), SizeIs(2));
+  EXPECT_THAT(sketch.Partition(0),
+              ElementsAre(ElementsAre(RegisterIs(1, {1}), RegisterIs(2, {1}))));
+}
+
+std::vector<std::pair<uint64_t, std::vector<int64_t>>> ToPairs(
+    absl::Span<const AnySketch::Register> registers) {
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> pairs;
+  for (const AnySketch::Register& sketch_register : registers) {
+    pairs.emplace_back(sketch_register.index,
+                       std::vector<int64_t>(sketch_register.values.begin(),
+                                            sketch_register.values.end()));
+  }
+  return pairs;
+}
+
+// A sketch with a SUM and a UNIQUE value, for the register-removing
+// operations.
+AnySketch MakeSumAndUniqueSketch() {
+  std::vector<ValueFunction> values;
+  values.push_back(MakeOracleValueFunction("foo"));
+  values.push_back(MakeValueFunction(AggregatorType::kUnique,
+                                     GetOracleDistribution("foo", 5, 15)));
+  return AnySketch(MakeFakeDistributionIndex(), std::move(values));
+}
+
+TEST(AnySketchTest, IntersectKeepsAndAggregatesSharedRegisters) {
+  AnySketch sketch1 = MakeSumAndUniqueSketch();
+  AnySketch sketch2 = MakeSumAndUniqueSketch();
+  // Enough registers for the lookups to run ahead of the iteration.
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_THAT(sketch1.AggregateIntoRegister(i, {1, 7}), IsOk());
+    ASSERT_THAT(sketch2.AggregateIntoRegister(i + 90, {2, i == 5 ? 8 : 7}),
+                IsOk());
+  }
+
+  ASSERT_THAT(sketch1.Intersect(sketch2), IsOk());
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> expected;
+  for (uint64_t i = 90; i < 100; ++i) {
+    expected.push_back({i, {3, i == 95 ? -1 : 7}});
+  }
+  EXPECT_EQ(ToPairs(sketch1.SortedRegisters()), expected);
+}
+
+TEST(AnySketchTest, SubtractRemovesSharedRegisters) {
+  AnySketch sketch1 = MakeSumAndUniqueSketch();
+  AnySketch sketch2 = MakeSumAndUniqueSketch();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_THAT(sketch1.AggregateIntoRegister(i, {1, 7}), IsOk());
+    ASSERT_THAT(sketch2.AggregateIntoRegister(i + 10, {2, 8}), IsOk());
+  }
+
+  ASSERT_THAT(sketch1.Subtract(sketch2), IsOk());
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> expected;
+  for (uint64_t i = 0; i < 10; ++i) expected.push_back({i, {1, 7}});
+  EXPECT_EQ(ToPairs(sketch1.SortedRegisters()), expected);
+
+  ASSERT_THAT(sketch1.Subtract(sketch1), IsOk());
+  EXPECT_THAT(sketch1.SortedRegisters(), IsEmpty());
+}
+
+TEST(AnySketchTest, RemovingRegistersFailsOnIncompatibleSketches) {
+  AnySketch sketch = MakeSumAndUniqueSketch();
+  AnySketch other(MakeFakeDistributionIndex(),
+                  MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {1, 7}), IsOk());
+
+  EXPECT_THAT(sketch.Intersect(other),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has 1 values but this one has 2")));
+  EXPECT_THAT(sketch.Subtract(other),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // A delta cannot remove registers.
+  sketch.Checkpoint();
+  EXPECT_THAT(sketch.Subtract(MakeSumAndUniqueSketch()),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  EXPECT_THAT(sketch.SortedRegisters(), SizeIs(1));
+}
+
+TEST(AnySketchTest, ChangedRegistersAreAllRegistersWithoutCheckpoint) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  ASSERT_THAT(sketch.AggregateIntoRegister(2, {1}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {1}), IsOk());
+
+  EXPECT_THAT(sketch.ChangedRegisters(),
+              ElementsAre(RegisterIs(1, {1}), RegisterIs(2, {1})));
+  EXPECT_EQ(sketch.Stats().changed_register_count, 2);
+}
+
+TEST(AnySketchTest, ChangedRegistersSinceCheckpoint) {
+  std::vector<ValueFunction> values;
+  values.push_back(MakeOracleValueFunction("foo"));
+  values.push_back(MakeValueFunction(AggregatorType::kUnique,
+                                     GetOracleDistribution("foo", 5, 15)));
+  AnySketch sketch(MakeFakeDistributionIndex(), std::move(values));
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {1, 7}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(2, {1, 7}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(3, {1, 7}), IsOk());
+
+  sketch.Checkpoint();
+  EXPECT_THAT(sketch.ChangedRegisters(), IsEmpty());
+
+  // Register 1 keeps its values, 2 and 3 change and 4 is new.
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {0, 7}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(2, {0, 8}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(3, {2, 7}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(4, {1, 7}), IsOk());
+
+  EXPECT_THAT(ToPairs(sketch.ChangedRegisters()),
+              ElementsAre(Pair(2, ElementsAre(1, -1)),
+                          Pair(3, ElementsAre(3, 7)),
+                          Pair(4, ElementsAre(1, 7))));
+  EXPECT_EQ(sketch.Stats().changed_register_count, 3);
+
+  sketch.Checkpoint();
+  EXPECT_THAT(sketch.ChangedRegisters(), IsEmpty());
+}
+
+TEST(AnySketchTest, ApplyDeltaReproducesTheSketch) {
+  auto make_sketch = []() {
+    return AnySketch(MakeFakeDistributionIndex(),
+                     MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  };
+  AnySketch publisher = make_sketch();
+  AnySketch aggregator = make_sketch();
+  ASSERT_THAT(publisher.Insert("a", {{"foo", 5}}), IsOk());
+  ASSERT_THAT(publisher.Insert("aa", {{"foo", 6}}), IsOk());
+  ASSERT_THAT(aggregator.ApplyDelta(publisher.ChangedRegisters()), IsOk());
+  publisher.Checkpoint();
+
+  ASSERT_THAT(publisher.Insert("aa", {{"foo", 7}}), IsOk());
+  ASSERT_THAT(publisher.Insert("aaa", {{"foo", 8}}), IsOk());
+  std::vector<AnySketch::Register> delta = publisher.ChangedRegisters();
+  ASSERT_THAT(delta, SizeIs(2));
+  ASSERT_THAT(aggregator.ApplyDelta(delta), IsOk());
+  // Applying the same delta again is harmless.
+  ASSERT_THAT(aggregator.ApplyDelta(delta), IsOk());
+
+  EXPECT_EQ(ToPairs(aggregator.SortedRegisters()),
+            ToPairs(publisher.SortedRegisters()));
+}
+
+TEST(AnySketchTest, ApplyDeltaWithWrongValueCountAppliesNothing) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  const std::vector<int64_t> good = {1};
+  const std::vector<int64_t> bad = {1, 2};
+
+  EXPECT_THAT(sketch.ApplyDelta({{.index = 1, .values = good},
+                                 {.index = 2, .values = bad}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Register 2 of the delta has 2 values")));
+  EXPECT_THAT(sketch.SortedRegisters(), IsEmpty());
+}
+
+TEST(AnySketchTest, ComputeRegisterDoesNotModifyTheSketch) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  std::vector<int64_t> values(1);
+
+  ASSERT_OK_AND_ASSIGN(int64_t index,
+                       sketch.ComputeRegister("aaa", {{"foo", 7}},
+                                              absl::MakeSpan(values)));
+
+  EXPECT_EQ(index, 3);
+  EXPECT_THAT(values, ElementsAre(7));
+  EXPECT_EQ(sketch.register_count(), 0);
+  std::vector<int64_t> too_many_values(2);
+  EXPECT_THAT(sketch.ComputeRegister("aaa", {{"foo", 7}},
+                                     absl::MakeSpan(too_many_values))
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AnySketchTest, ReserveKeepsRegisters) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  ASSERT_THAT(sketch.AggregateIntoRegister(1, {1}), IsOk());
+
+  sketch.Reserve(1000);
+
+  EXPECT_GE(sketch.Stats().capacity, 1000);
+  EXPECT_EQ(sketch.register_count(), 1);
+  EXPECT_THAT(sketch.SortedRegisters(), ElementsAre(RegisterIs(1, {1})));
+}
+
+TEST(AnySketchTest, StatsOfEmptySketch) {
+  AnySketch sketch(MakeFakeDistributionIndex(), {});
+
+  AnySketchStats stats = sketch.Stats();
+  EXPECT_EQ(stats.register_count, 0);
+  EXPECT_EQ(stats.destroyed_register_count, 0);
+  EXPECT_EQ(stats.value_bytes, 0);
+  EXPECT_EQ(stats.insert_count, 0);
+  EXPECT_GE(stats.memory_bytes, sizeof(AnySketch));
+}
+
+TEST(AnySketchTest, StatsCountRegistersAndWork) {
+  auto make_sketch = []() {
+    return AnySketch(MakeFakeDistributionIndex(),
+                     MakeSingleItemVector(MakeOracleValueFunction("foo")));
+  };
+
+  AnySketch sketch1 = make_sketch();
+  AnySketch sketch2 = make_sketch();
+
+  ASSERT_THAT(sketch1.Insert("a", {{"foo", 5}}), IsOk());
+  ASSERT_THAT(sketch1.Insert("aa", {{"foo", 6}}), IsOk());
+  ASSERT_THAT(sketch1.Insert("bb", {{"foo", 6}}), IsOk());
+  ASSERT_THAT(sketch2.Insert("aaa", {{"foo", 8}}), IsOk());
+  ASSERT_THAT(sketch1.Merge(sketch2), IsOk());
+
+  AnySketchStats stats = sketch1.Stats();
+  EXPECT_EQ(stats.register_count, 3);
+  EXPECT_GE(stats.capacity, 3);
+  EXPECT_DOUBLE_EQ(stats.load_factor,
+                   static_cast<double>(stats.register_count) / stats.capacity);
+  EXPECT_GT(stats.slot_bytes, 0);
+  EXPECT_GE(stats.table_bytes, stats.capacity * stats.slot_bytes);
+  EXPECT_GE(stats.memory_bytes, sizeof(AnySketch) + stats.table_bytes);
+  EXPECT_EQ(stats.insert_count, 3);
+  EXPECT_EQ(stats.merge_count, 1);
+  EXPECT_EQ(stats.merged_register_count, 1);
+}
+
+TEST(AnySketchTest, StatsCountDestroyedRegisters) {
+  AnySketch sketch(MakeFakeDistributionIndex(),
+                   MakeSingleItemVector(MakeValueFunction(
+                       AggregatorType::kUnique,
+                       GetOracleDistribution("foo", 5, 15))));
+
+  ASSERT_THAT(sketch.Insert("a", {{"foo", 5}}), IsOk());
+  ASSERT_THAT(sketch.Insert("b", {{"foo", 6}}), IsOk());
+  ASSERT_THAT(sketch.Insert("aa", {{"foo", 7}}), IsOk());
+
+  EXPECT_EQ(sketch.Stats().destroyed_register_count, 1);
+}
+
+TEST(AnySketchTest, StatsCountOutOfLineValueBytes) {
+  constexpr int kValueCount = 64;
+  std::vector<ValueFunction> values;
+  for (int i = 0; i < kValueCount; ++i) {
+    values.push_back(MakeOracleValueFunction("foo"));
+  }
+  AnySketch sketch(MakeFakeDistributionIndex(), std::move(values));
+
+  ASSERT_THAT(sketch.Insert("a", {{"foo", 5}}), IsOk());
+  ASSERT_THAT(sketch.Insert("aa", {{"foo", 5}}), IsOk());
+
+  EXPECT_EQ(sketch.Stats().value_bytes,
+            2 * kValueCount * sizeof(AnySketch::ValueType));
+}
 }  // namespace
 }  // namespace wfa::any_sketch
@@ -0,0 +1,197 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/ciphertext_framing.h"
+
+#include <random>
+#include <string>
+
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+constexpr int kPointBytes = 33;
+constexpr int kCiphertextsPerRegister = 3;
+constexpr int kRegisterBytes = kCiphertextsPerRegister * 2 * kPointBytes;
+
+// Returns `register_count` registers of random compressed points.
+std::string MakeEncryptedSketch(int register_count) {
+  std::mt19937 rng(register_count);
+  std::string encrypted_sketch(register_count * kRegisterBytes, '\0');
+  for (size_t i = 0; i < encrypted_sketch.size(); ++i) {
+    encrypted_sketch[i] = i % kPointBytes == 0 ? 0x02 + rng() % 2 : rng();
+  }
+  return encrypted_sketch;
+}
+
+CiphertextFrameHeader MakeHeader(int registers_per_block) {
+  CiphertextFrameHeader header;
+  header.point_bytes = kPointBytes;
+  header.ciphertexts_per_register = kCiphertextsPerRegister;
+  header.registers_per_block = registers_per_block;
+  header.destroyed_register_strategy = EncryptSketchRequest::FLAGGED_KEY;
+  header.hash_to_curve_method = EncryptSketchRequest::SSWU_V1;
+  return header;
+}
+
+TEST(CiphertextFramingTest, RoundTripsWithAPartialLastBlock) {
+  const std::string encrypted_sketch = MakeEncryptedSketch(10);
+
+  ASSERT_OK_AND_ASSIGN(std::string framed,
+                       FrameCiphertexts(encrypted_sketch, MakeHeader(4)));
+  EXPECT_TRUE(IsFramedCiphertexts(framed));
+  EXPECT_LT(framed.size(), encrypted_sketch.size());
+  EXPECT_THAT(UnframeCiphertexts(framed), IsOkAndHolds(encrypted_sketch));
+  EXPECT_THAT(UnframeCiphertexts(framed, /*thread_count=*/3),
+              IsOkAndHolds(encrypted_sketch));
+}
+
+TEST(CiphertextFramingTest, PacksTheSignBytes) {
+  const std::string encrypted_sketch = MakeEncryptedSketch(1024);
+
+  ASSERT_OK_AND_ASSIGN(std::string framed,
+                       FrameCiphertexts(encrypted_sketch, MakeHeader(1024)));
+  // A 24-byte header and a block of a 4-byte count, a bit and 32 bytes of x
+  // per point.
+  const int points = 1024 * kCiphertextsPerRegister * 2;
+  EXPECT_THAT(framed, SizeIs(24 + 4 + points / 8 + points * 32));
+}
+
+TEST(CiphertextFramingTest, ParsesTheHeader) {
+  ASSERT_OK_AND_ASSIGN(
+      std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(10), MakeHeader(4)));
+
+  ASSERT_OK_AND_ASSIGN(CiphertextFrameHeader header,
+                       ParseCiphertextFrameHeader(framed));
+  EXPECT_EQ(header.point_bytes, kPointBytes);
+  EXPECT_EQ(header.ciphertexts_per_register, kCiphertextsPerRegister);
+  EXPECT_EQ(header.registers_per_block, 4);
+  EXPECT_EQ(header.register_count, 10);
+  EXPECT_EQ(header.destroyed_register_strategy,
+            EncryptSketchRequest::FLAGGED_KEY);
+  EXPECT_EQ(header.hash_to_curve_method, EncryptSketchRequest::SSWU_V1);
+}
+
+TEST(CiphertextFramingTest, RoundTripsAnEmptySketch) {
+  ASSERT_OK_AND_ASSIGN(std::string framed,
+                       FrameCiphertexts("", MakeHeader(4)));
+  EXPECT_TRUE(IsFramedCiphertexts(framed));
+  EXPECT_THAT(UnframeCiphertexts(framed, /*thread_count=*/4),
+              IsOkAndHolds(""));
+}
+
+TEST(CiphertextFramingTest, ConcatenatedCiphertextsAreNotFramed) {
+  EXPECT_FALSE(IsFramedCiphertexts(MakeEncryptedSketch(2)));
+  EXPECT_FALSE(IsFramedCiphertexts(""));
+  EXPECT_THAT(ParseCiphertextFrameHeader(MakeEncryptedSketch(2)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CiphertextFramingTest, FramingFailsOnAPartialRegister) {
+  std::string encrypted_sketch = MakeEncryptedSketch(2);
+  encrypted_sketch.resize(encrypted_sketch.size() - 2 * kPointBytes);
+
+  EXPECT_THAT(FrameCiphertexts(encrypted_sketch, MakeHeader(4)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a multiple")));
+}
+
+TEST(CiphertextFramingTest, FramingFailsOnAnUncompressedPoint) {
+  std::string encrypted_sketch = MakeEncryptedSketch(2);
+  encrypted_sketch[5 * kPointBytes] = 0x04;
+
+  EXPECT_THAT(FrameCiphertexts(encrypted_sketch, MakeHeader(4)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Point 5 ")));
+}
+
+TEST(CiphertextFramingTest, UnframingFailsOnATruncatedSketch) {
+  ASSERT_OK_AND_ASSIGN(
+      std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(10), MakeHeader(4)));
+  framed.resize(framed.size() - 1);
+
+  EXPECT_THAT(UnframeCiphertexts(framed),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(CiphertextFramingTest, UnframingFailsOnACorruptedBlockCount) {
+  ASSERT_OK_AND_ASSIGN(
+      std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(10), MakeHeader(4)));
+  // The count of the first block follows the 24-byte header.
+  framed[24] = 3;
+
+  EXPECT_THAT(UnframeCiphertexts(framed),
+              StatusIs(absl::StatusCode::kDataLoss, HasSubstr("Block 0")));
+}
+
+TEST(CiphertextFramingTest, UnframingFailsOnOutOfRangeHeaderCounts) {
+  ASSERT_OK_AND_ASSIGN(
+      const std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(10), MakeHeader(4)));
+
+  // Ciphertexts per register, at offset 8, whose point count overflows an
+  // int.
+  std::string adversarial = framed;
+  adversarial.replace(8, 4, std::string("\x00\x00\x00\x40", 4));
+  EXPECT_THAT(UnframeCiphertexts(adversarial),
+              StatusIs(absl::StatusCode::kDataLoss,
+                       HasSubstr("ciphertexts_per_register")));
+
+  // Registers per block, at offset 12.
+  adversarial = framed;
+  adversarial.replace(12, 4, std::string("\xff\xff\xff\x7f", 4));
+  EXPECT_THAT(UnframeCiphertexts(adversarial),
+              StatusIs(absl::StatusCode::kDataLoss,
+                       HasSubstr("registers_per_block")));
+}
+
+TEST(CiphertextFramingTest, UnframingFailsOnAWrappingRegisterCount) {
+  ASSERT_OK_AND_ASSIGN(
+      std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(10), MakeHeader(4)));
+  // The largest register counts per block and ciphertexts per register, and a
+  // register count at offset 16 whose sizes would wrap around 64 bits.
+  framed.replace(8, 4, std::string("\x00\x00\x01\x00", 4));
+  framed.replace(12, 4, std::string("\x00\x00\x10\x00", 4));
+  framed.replace(16, 8,
+                 std::string("\x00\x00\x00\x00\x00\x00\x00\x40", 8));
+
+  EXPECT_THAT(UnframeCiphertexts(framed),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST(CiphertextFramingTest, UnframingFailsOnAnotherVersion) {
+  ASSERT_OK_AND_ASSIGN(
+      std::string framed,
+      FrameCiphertexts(MakeEncryptedSketch(1), MakeHeader(4)));
+  framed[4] = 2;
+
+  EXPECT_THAT(UnframeCiphertexts(framed),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("version 2")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
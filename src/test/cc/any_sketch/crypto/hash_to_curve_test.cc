@@ -0,0 +1,158 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/hash_to_curve.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/obj_mac.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+constexpr int kTestCurveId = NID_X9_62_prime256v1;
+
+// The domain separation tag of the P256_XMD:SHA-256_SSWU_RO_ test vectors of
+// RFC 9380, appendix J.1.1.
+constexpr absl::string_view kRfc9380TestDst =
+    "QUUX-V01-CS02-with-P256_XMD:SHA-256_SSWU_RO_";
+
+class HashToCurveTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(ECGroup ec_group,
+                         ECGroup::Create(kTestCurveId, &ctx_));
+    ec_group_ = std::make_unique<ECGroup>(std::move(ec_group));
+  }
+
+  Context ctx_;
+  std::unique_ptr<ECGroup> ec_group_;
+};
+
+TEST_F(HashToCurveTest, SswuMatchesTheRfc9380TestVectors) {
+  ASSERT_OK_AND_ASSIGN(
+      HashToCurve hash_to_curve,
+      HashToCurve::CreateSswu(kTestCurveId, kRfc9380TestDst, ec_group_.get(),
+                              &ctx_));
+  const std::vector<std::pair<std::string, std::string>> vectors = {
+      {"",
+       absl::StrCat(
+           "04",
+           "2c15230b26dbc6fc9a37051158c95b79656e17a1a920b11394ca91c44247d3e4",
+           "8a7a74985cc5c776cdfe4b1f19884970453912e9d31528c060be9ab5c43e8415")},
+      {"abc",
+       absl::StrCat(
+           "04",
+           "0bb8b87485551aa43ed54f009230450b492fead5f1cc91658775dac4a3388a0f",
+           "5c41b3d0731a27a7b14bc0bf0ccded2d8751f83493404c84a88e71ffd424212e")},
+  };
+
+  for (const auto& [message, expected_point] : vectors) {
+    ASSERT_OK_AND_ASSIGN(ECPoint point, hash_to_curve.Hash(message));
+    ASSERT_OK_AND_ASSIGN(std::string bytes, point.ToBytesUnCompressed());
+    EXPECT_EQ(absl::BytesToHexString(bytes), expected_point)
+        << "message: \"" << message << "\"";
+  }
+}
+
+TEST_F(HashToCurveTest, HashBatchMatchesHash) {
+  ASSERT_OK_AND_ASSIGN(HashToCurve hash_to_curve,
+                       HashToCurve::Create(EncryptSketchRequest::SSWU_V1,
+                                           kTestCurveId, ec_group_.get(),
+                                           &ctx_));
+  std::vector<std::string> plaintexts;
+  for (int i = 0; i < 50; ++i) plaintexts.push_back(std::to_string(i));
+
+  ASSERT_OK_AND_ASSIGN(std::vector<ECPoint> points,
+                       hash_to_curve.HashBatch(plaintexts));
+  ASSERT_THAT(points, SizeIs(plaintexts.size()));
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(ECPoint point, hash_to_curve.Hash(plaintexts[i]));
+    EXPECT_TRUE(points[i] == point) << "plaintext " << plaintexts[i];
+  }
+}
+
+TEST_F(HashToCurveTest, HashBatchOfNothingIsEmpty) {
+  ASSERT_OK_AND_ASSIGN(HashToCurve hash_to_curve,
+                       HashToCurve::Create(EncryptSketchRequest::SSWU_V1,
+                                           kTestCurveId, ec_group_.get(),
+                                           &ctx_));
+  EXPECT_THAT(hash_to_curve.HashBatch({}), IsOkAndHolds(SizeIs(0)));
+}
+
+TEST_F(HashToCurveTest, SswuDependsOnTheDomainSeparationTag) {
+  ASSERT_OK_AND_ASSIGN(HashToCurve v1,
+                       HashToCurve::Create(EncryptSketchRequest::SSWU_V1,
+                                           kTestCurveId, ec_group_.get(),
+                                           &ctx_));
+  ASSERT_OK_AND_ASSIGN(
+      HashToCurve rfc, HashToCurve::CreateSswu(kTestCurveId, kRfc9380TestDst,
+                                               ec_group_.get(), &ctx_));
+  ASSERT_OK_AND_ASSIGN(ECPoint v1_point, v1.Hash("abc"));
+  ASSERT_OK_AND_ASSIGN(ECPoint rfc_point, rfc.Hash("abc"));
+  EXPECT_FALSE(v1_point == rfc_point);
+}
+
+TEST_F(HashToCurveTest, TryAndIncrementMatchesTheECGroup) {
+  ASSERT_OK_AND_ASSIGN(
+      HashToCurve hash_to_curve,
+      HashToCurve::Create(EncryptSketchRequest::TRY_AND_INCREMENT,
+                          kTestCurveId, ec_group_.get(), &ctx_));
+  const std::vector<std::string> plaintexts = {"1", "2", "unit_ec_point"};
+
+  ASSERT_OK_AND_ASSIGN(std::vector<ECPoint> points,
+                       hash_to_curve.HashBatch(plaintexts));
+  ASSERT_THAT(points, SizeIs(plaintexts.size()));
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        ECPoint expected,
+        ec_group_->GetPointByHashingToCurveSha256(plaintexts[i]));
+    EXPECT_TRUE(points[i] == expected) << "plaintext " << plaintexts[i];
+  }
+}
+
+TEST_F(HashToCurveTest, SswuFailsOnOtherCurves) {
+  ASSERT_OK_AND_ASSIGN(ECGroup secp224r1,
+                       ECGroup::Create(NID_secp224r1, &ctx_));
+  EXPECT_THAT(HashToCurve::Create(EncryptSketchRequest::SSWU_V1, NID_secp224r1,
+                                  &secp224r1, &ctx_),
+              StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("P-256")));
+}
+
+TEST_F(HashToCurveTest, SswuFailsWithAnEmptyDomainSeparationTag) {
+  EXPECT_THAT(
+      HashToCurve::CreateSswu(kTestCurveId, "", ec_group_.get(), &ctx_),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
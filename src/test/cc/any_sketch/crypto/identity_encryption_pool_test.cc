@@ -0,0 +1,155 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/identity_encryption_pool.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/obj_mac.h"
+#include "private_join_and_compute/crypto/commutative_elgamal.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using ::private_join_and_compute::CommutativeElGamal;
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+using ::testing::SizeIs;
+
+constexpr int kTestCurveId = NID_X9_62_prime256v1;
+constexpr int kPointBytes = 33;
+
+class IdentityEncryptionPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(ECGroup ec_group,
+                         ECGroup::Create(kTestCurveId, &ctx_));
+    ec_group_ = std::make_unique<ECGroup>(std::move(ec_group));
+    ASSERT_OK_AND_ASSIGN(
+        cipher_, CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId));
+    ASSERT_OK_AND_ASSIGN(public_key_bytes_, cipher_->GetPublicKeyBytes());
+    ASSERT_OK_AND_ASSIGN(ECPoint plaintext,
+                         ec_group_->GetPointByHashingToCurveSha256("value"));
+    ASSERT_OK_AND_ASSIGN(plaintext_, plaintext.ToBytesCompressed());
+  }
+
+  // Returns the decryptions of the concatenated `ciphertexts`.
+  std::vector<std::string> DecryptAll(absl::string_view ciphertexts) {
+    std::vector<std::string> plaintexts;
+    for (size_t i = 0; i < ciphertexts.size(); i += 2 * kPointBytes) {
+      absl::StatusOr<std::string> plaintext = cipher_->Decrypt(
+          {std::string(ciphertexts.substr(i, kPointBytes)),
+           std::string(ciphertexts.substr(i + kPointBytes, kPointBytes))});
+      EXPECT_THAT(plaintext.status(), IsOk());
+      plaintexts.push_back(plaintext.value_or(""));
+    }
+    return plaintexts;
+  }
+
+  Context ctx_;
+  std::unique_ptr<ECGroup> ec_group_;
+  std::unique_ptr<CommutativeElGamal> cipher_;
+  std::pair<std::string, std::string> public_key_bytes_;
+  std::string plaintext_;
+};
+
+TEST_F(IdentityEncryptionPoolTest, EncryptionsDecryptToThePlaintext) {
+  ASSERT_OK_AND_ASSIGN(
+      IdentityEncryptionPool pool,
+      IdentityEncryptionPool::Create(ec_group_.get(), public_key_bytes_));
+
+  std::string ciphertexts = "prefix";
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 5, ciphertexts), IsOk());
+
+  ASSERT_THAT(ciphertexts, SizeIs(6 + 5 * 2 * kPointBytes));
+  EXPECT_EQ(ciphertexts.substr(0, 6), "prefix");
+  EXPECT_THAT(DecryptAll(absl::string_view(ciphertexts).substr(6)),
+              ::testing::Each(plaintext_));
+}
+
+TEST_F(IdentityEncryptionPoolTest, EncryptionsAreIndependent) {
+  ASSERT_OK_AND_ASSIGN(
+      IdentityEncryptionPool pool,
+      IdentityEncryptionPool::Create(ec_group_.get(), public_key_bytes_));
+
+  std::string ciphertexts;
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 10, ciphertexts), IsOk());
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 10, ciphertexts), IsOk());
+
+  // No two ciphertexts share a point, as they would if an encryption of the
+  // identity were used twice.
+  absl::flat_hash_set<std::string> points;
+  for (size_t i = 0; i < ciphertexts.size(); i += kPointBytes) {
+    points.insert(ciphertexts.substr(i, kPointBytes));
+  }
+  EXPECT_THAT(points, SizeIs(40));
+}
+
+TEST_F(IdentityEncryptionPoolTest, EncryptionsUsePrecomputedIdentities) {
+  ASSERT_OK_AND_ASSIGN(
+      IdentityEncryptionPool pool,
+      IdentityEncryptionPool::Create(ec_group_.get(), public_key_bytes_));
+  ASSERT_THAT(pool.Precompute(8), IsOk());
+  EXPECT_EQ(pool.size(), 8);
+
+  std::string ciphertexts;
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 3, ciphertexts), IsOk());
+  EXPECT_EQ(pool.size(), 5);
+
+  // Missing encryptions of the identity are computed, and none are left over.
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 7, ciphertexts), IsOk());
+  EXPECT_EQ(pool.size(), 0);
+  EXPECT_THAT(DecryptAll(ciphertexts), ::testing::Each(plaintext_));
+}
+
+TEST_F(IdentityEncryptionPoolTest, NoEncryptionsAppendNothing) {
+  ASSERT_OK_AND_ASSIGN(
+      IdentityEncryptionPool pool,
+      IdentityEncryptionPool::Create(ec_group_.get(), public_key_bytes_));
+
+  std::string ciphertexts;
+  ASSERT_THAT(pool.AppendEncryptions(plaintext_, 0, ciphertexts), IsOk());
+  EXPECT_EQ(ciphertexts, "");
+}
+
+TEST_F(IdentityEncryptionPoolTest, InvalidPlaintextFails) {
+  ASSERT_OK_AND_ASSIGN(
+      IdentityEncryptionPool pool,
+      IdentityEncryptionPool::Create(ec_group_.get(), public_key_bytes_));
+
+  std::string ciphertexts;
+  EXPECT_FALSE(pool.AppendEncryptions("not a point", 1, ciphertexts).ok());
+}
+
+TEST_F(IdentityEncryptionPoolTest, InvalidPublicKeyFails) {
+  EXPECT_FALSE(IdentityEncryptionPool::Create(
+                   ec_group_.get(), {public_key_bytes_.first, "not a point"})
+                   .ok());
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
@@ -0,0 +1,298 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/crypto/sketch_decrypter.h"
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "any_sketch/crypto/ciphertext_framing.h"
+#include "any_sketch/crypto/sketch_encrypter.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/obj_mac.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
+#include "wfa/any_sketch/crypto/el_gamal_key.pb.h"
+#include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch::crypto {
+namespace {
+
+using ::private_join_and_compute::Context;
+using ::private_join_and_compute::ECGroup;
+using ::private_join_and_compute::ECPoint;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+constexpr int kTestCurveId = NID_X9_62_prime256v1;
+constexpr int kMaxCounterValue = 10;
+constexpr int kIndexCount = 100;
+constexpr int kMaxUniqueValue = 20;
+
+// A sketch with a UNIQUE and a SUM value, whose register 5 is destroyed and
+// register 7 has a count above kMaxCounterValue.
+Sketch MakeSketch() {
+  Sketch sketch;
+  SketchConfig* config = sketch.mutable_config();
+  config->add_values()->set_aggregator(SketchConfig::ValueSpec::UNIQUE);
+  config->add_values()->set_aggregator(SketchConfig::ValueSpec::SUM);
+  for (int i = 0; i < 10; ++i) {
+    Sketch::Register* reg = sketch.add_registers();
+    reg->set_index(i * 9);
+    reg->add_values(i == 5 ? 0 : i + 1);
+    reg->add_values(i == 7 ? 3 * kMaxCounterValue : i % 4 + 1);
+  }
+  return sketch;
+}
+
+// Returns the uncompressed encoding of the compressed `point`.
+std::string Uncompress(absl::string_view point) {
+  Context ctx;
+  ECGroup ec_group = ECGroup::Create(kTestCurveId, &ctx).value();
+  ECPoint ec_point = ec_group.CreateECPoint(point).value();
+  return ec_point.ToBytesUnCompressed().value();
+}
+
+class SketchDecrypterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_OK_AND_ASSIGN(key_pair_, GenerateElGamalKeyPair(kTestCurveId));
+    ASSERT_OK_AND_ASSIGN(
+        encrypter_,
+        CreateWithPublicKey(kTestCurveId, kMaxCounterValue,
+                            {.u = key_pair_.public_key().generator(),
+                             .e = key_pair_.public_key().element()}));
+    options_.curve_id = kTestCurveId;
+    options_.max_counter_value = kMaxCounterValue;
+    options_.index_count = kIndexCount;
+    options_.max_unique_value = kMaxUniqueValue;
+    options_.thread_count = 3;
+    ASSERT_OK_AND_ASSIGN(decrypter_,
+                         SketchDecrypter::Create(key_pair_, options_));
+  }
+
+  ElGamalKeyPair key_pair_;
+  std::unique_ptr<SketchEncrypter> encrypter_;
+  SketchDecrypterOptions options_;
+  std::unique_ptr<SketchDecrypter> decrypter_;
+};
+
+TEST_F(SketchDecrypterTest, RoundTripsWithFlaggedKey) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter_->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+  EXPECT_EQ(decrypted.flagged_registers, 1);
+  EXPECT_EQ(decrypted.conflicting_registers, 0);
+  EXPECT_EQ(decrypted.sketch.registers(7).values(1), kMaxCounterValue + 1);
+}
+
+TEST_F(SketchDecrypterTest, RoundTripsWithConflictingKeys) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::CONFLICTING_KEYS));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter_->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+  EXPECT_EQ(decrypted.flagged_registers, 0);
+  EXPECT_EQ(decrypted.conflicting_registers, 1);
+}
+
+TEST_F(SketchDecrypterTest, RoundTripsWithConflictingKeysAndNoCounts) {
+  // With a max_counter_value of 0 every count is encrypted as 1, including the
+  // 2s of a destroyed register.
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SketchEncrypter> encrypter,
+      CreateWithPublicKey(kTestCurveId, /*max_counter_value=*/0,
+                          {.u = key_pair_.public_key().generator(),
+                           .e = key_pair_.public_key().element()}));
+  options_.max_counter_value = 0;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchDecrypter> decrypter,
+                       SketchDecrypter::Create(key_pair_, options_));
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter->Encrypt(sketch, EncryptSketchRequest::CONFLICTING_KEYS));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, 0), IsOk());
+  EXPECT_EQ(decrypted.conflicting_registers, 1);
+}
+
+TEST_F(SketchDecrypterTest, RoundTripsWithSswu) {
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SketchEncrypter> encrypter,
+      CreateWithPublicKey(kTestCurveId, kMaxCounterValue,
+                          {.u = key_pair_.public_key().generator(),
+                           .e = key_pair_.public_key().element()},
+                          EncryptSketchRequest::SSWU_V1));
+  options_.hash_to_curve_method = EncryptSketchRequest::SSWU_V1;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchDecrypter> decrypter,
+                       SketchDecrypter::Create(key_pair_, options_));
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+  EXPECT_EQ(decrypted.flagged_registers, 1);
+  // The points of the other method are not in the tables.
+  EXPECT_THAT(decrypter_->Decrypt(encrypted, sketch.config()),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST_F(SketchDecrypterTest, RoundTripsWithAnUncompressedPublicKey) {
+  ElGamalKeyPair key_pair = key_pair_;
+  key_pair.mutable_public_key()->set_generator(
+      Uncompress(key_pair_.public_key().generator()));
+  key_pair.mutable_public_key()->set_element(
+      Uncompress(key_pair_.public_key().element()));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchDecrypter> decrypter,
+                       SketchDecrypter::Create(key_pair, options_));
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+
+  // The ciphertexts are compressed points whatever the encoding of the key.
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+}
+
+TEST_F(SketchDecrypterTest, DecryptsFramedCiphertexts) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::CONFLICTING_KEYS));
+  CiphertextFrameHeader header;
+  header.ciphertexts_per_register = 3;
+  header.registers_per_block = 4;
+  ASSERT_OK_AND_ASSIGN(std::string framed, FrameCiphertexts(encrypted, header));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter_->Decrypt(framed, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+  EXPECT_EQ(decrypted.conflicting_registers, 1);
+
+  header.hash_to_curve_method = EncryptSketchRequest::SSWU_V1;
+  ASSERT_OK_AND_ASSIGN(framed, FrameCiphertexts(encrypted, header));
+  EXPECT_THAT(decrypter_->Decrypt(framed, sketch.config()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("hash to curve method")));
+}
+
+TEST_F(SketchDecrypterTest, DropsNoiseRegisters) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+  EncryptSketchRequest::PublisherNoiseParameter noise;
+  noise.set_epsilon(0.1);
+  noise.set_delta(0.1);
+  noise.set_publisher_count(1);
+  ASSERT_THAT(encrypter_->AppendNoiseRegisters(noise, 2, encrypted), IsOk());
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter_->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted.sketch, kMaxCounterValue),
+              IsOk());
+  EXPECT_EQ(decrypted.sketch.registers_size() + decrypted.noise_registers,
+            encrypted.size() / (3 * 66));
+}
+
+TEST_F(SketchDecrypterTest, DecryptsAnEmptySketch) {
+  Sketch sketch = MakeSketch();
+  sketch.clear_registers();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+
+  ASSERT_OK_AND_ASSIGN(DecryptedSketch decrypted,
+                       decrypter_->Decrypt(encrypted, sketch.config()));
+  EXPECT_THAT(decrypted.sketch.registers(), SizeIs(0));
+}
+
+TEST_F(SketchDecrypterTest, FailsOnIndexesOutsideOfTheTables) {
+  Sketch sketch = MakeSketch();
+  sketch.mutable_registers(3)->set_index(kIndexCount);
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+
+  EXPECT_THAT(decrypter_->Decrypt(encrypted, sketch.config()),
+              StatusIs(absl::StatusCode::kDataLoss, HasSubstr("Register 3")));
+}
+
+TEST_F(SketchDecrypterTest, FailsWithAnotherKeyPair) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+  ASSERT_OK_AND_ASSIGN(ElGamalKeyPair other_key_pair,
+                       GenerateElGamalKeyPair(kTestCurveId));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchDecrypter> other_decrypter,
+                       SketchDecrypter::Create(other_key_pair, options_));
+
+  EXPECT_THAT(other_decrypter->Decrypt(encrypted, sketch.config()),
+              StatusIs(absl::StatusCode::kDataLoss));
+}
+
+TEST_F(SketchDecrypterTest, FailsOnATruncatedSketch) {
+  const Sketch sketch = MakeSketch();
+  ASSERT_OK_AND_ASSIGN(
+      std::string encrypted,
+      encrypter_->Encrypt(sketch, EncryptSketchRequest::FLAGGED_KEY));
+  encrypted.resize(encrypted.size() - 66);
+
+  EXPECT_THAT(decrypter_->Decrypt(encrypted, sketch.config()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(SketchDecrypterTest, VerifyReportsTheFirstDifference) {
+  const Sketch sketch = MakeSketch();
+  Sketch decrypted = sketch;
+  decrypted.mutable_registers(5)->set_values(1, 0);
+  decrypted.mutable_registers(7)->set_values(1, kMaxCounterValue + 1);
+  ASSERT_THAT(VerifyDecryptedSketch(sketch, decrypted, kMaxCounterValue),
+              IsOk());
+
+  decrypted.mutable_registers(2)->set_values(0, 4);
+  EXPECT_THAT(VerifyDecryptedSketch(sketch, decrypted, kMaxCounterValue),
+              StatusIs(absl::StatusCode::kFailedPrecondition,
+                       HasSubstr("Value 0 of register 2 with index 18 is 4")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch::crypto
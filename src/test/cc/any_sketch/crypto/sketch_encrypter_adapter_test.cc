@@ -14,12 +14,26 @@
 
 #include "any_sketch/crypto/sketch_encrypter_adapter.h"
 
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "any_sketch/crypto/ciphertext_framing.h"
+#include "any_sketch/tracing.h"
 #include "common_cpp/testing/random.h"
 #include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "openssl/obj_mac.h"
 #include "private_join_and_compute/crypto/commutative_elgamal.h"
+#include "private_join_and_compute/crypto/context.h"
+#include "private_join_and_compute/crypto/ec_group.h"
+#include "private_join_and_compute/crypto/ec_point.h"
 #include "wfa/any_sketch/crypto/sketch_encryption_methods.pb.h"
 
 namespace wfa::any_sketch::crypto {
@@ -30,6 +44,10 @@ using ::private_join_and_compute::Context;
 using ::private_join_and_compute::ECGroup;
 using ::private_join_and_compute::ECPoint;
 using ::private_join_and_compute::InternalError;
+using ::testing::Contains;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
 using ::testing::SizeIs;
 using ::wfa::any_sketch::Sketch;
 using ::wfa::any_sketch::SketchConfig;
@@ -134,5 +152,190 @@ TEST(SketchEncrypterJavaAdapterTest, noiseShouldBeAddedIfNoiseParameterIsSet) {
             register_size * bytes_per_register);
 }
 
+TEST(SketchEncrypterJavaAdapterTest, hashToCurveMethodIsEchoedInResponse) {
+  ASSERT_OK_AND_ASSIGN(auto commutativeElGamal,
+                       CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId));
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair,
+                       commutativeElGamal->GetPublicKeyBytes());
+
+  wfa::any_sketch::crypto::EncryptSketchRequest request;
+  request.mutable_el_gamal_keys()->set_generator(public_key_pair.first);
+  request.mutable_el_gamal_keys()->set_element(public_key_pair.second);
+  request.set_curve_id(kTestCurveId);
+  request.set_maximum_value(kMaxCounterValue);
+  request.set_hash_to_curve_method(EncryptSketchRequest::SSWU_V1);
+  *request.mutable_sketch()->mutable_config() = CreateSketchConfig(1, 1, 1);
+  AddRandomRegisters(10, *request.mutable_sketch());
+
+  ASSERT_OK_AND_ASSIGN(std::string encrypted_sketch,
+                       EncryptSketch(request.SerializeAsString()));
+  wfa::any_sketch::crypto::EncryptSketchResponse response;
+  ASSERT_TRUE(response.ParseFromString(encrypted_sketch));
+
+  EXPECT_EQ(response.hash_to_curve_method(), EncryptSketchRequest::SSWU_V1);
+  EXPECT_THAT(response.encrypted_sketch(), SizeIs(10 * 3 * 66));
+}
+
+TEST(SketchEncrypterJavaAdapterTest, framedCiphertextsAreSmaller) {
+  ASSERT_OK_AND_ASSIGN(auto commutativeElGamal,
+                       CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId));
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair,
+                       commutativeElGamal->GetPublicKeyBytes());
+
+  wfa::any_sketch::crypto::EncryptSketchRequest request;
+  request.mutable_el_gamal_keys()->set_generator(public_key_pair.first);
+  request.mutable_el_gamal_keys()->set_element(public_key_pair.second);
+  request.set_curve_id(kTestCurveId);
+  request.set_maximum_value(kMaxCounterValue);
+  request.set_ciphertext_format(EncryptSketchRequest::FRAMED_V1);
+  *request.mutable_sketch()->mutable_config() = CreateSketchConfig(1, 1, 1);
+  AddRandomRegisters(100, *request.mutable_sketch());
+
+  ASSERT_OK_AND_ASSIGN(std::string encrypted_sketch,
+                       EncryptSketch(request.SerializeAsString()));
+  wfa::any_sketch::crypto::EncryptSketchResponse response;
+  ASSERT_TRUE(response.ParseFromString(encrypted_sketch));
+
+  EXPECT_EQ(response.ciphertext_format(), EncryptSketchRequest::FRAMED_V1);
+  ASSERT_TRUE(IsFramedCiphertexts(response.encrypted_sketch()));
+  ASSERT_OK_AND_ASSIGN(std::string unframed,
+                       UnframeCiphertexts(response.encrypted_sketch()));
+  EXPECT_THAT(unframed, SizeIs(100 * 3 * 66));
+  EXPECT_LT(response.encrypted_sketch().size(), unframed.size());
+}
+
+TEST(SketchEncrypterJavaAdapterTest, framesCiphertextsOfAnUncompressedKey) {
+  ASSERT_OK_AND_ASSIGN(auto commutativeElGamal,
+                       CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId));
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair,
+                       commutativeElGamal->GetPublicKeyBytes());
+  Context ctx;
+  ASSERT_OK_AND_ASSIGN(ECGroup ec_group, ECGroup::Create(kTestCurveId, &ctx));
+  ASSERT_OK_AND_ASSIGN(ECPoint generator,
+                       ec_group.CreateECPoint(public_key_pair.first));
+  ASSERT_OK_AND_ASSIGN(ECPoint element,
+                       ec_group.CreateECPoint(public_key_pair.second));
+
+  wfa::any_sketch::crypto::EncryptSketchRequest request;
+  ASSERT_OK_AND_ASSIGN(*request.mutable_el_gamal_keys()->mutable_generator(),
+                       generator.ToBytesUnCompressed());
+  ASSERT_OK_AND_ASSIGN(*request.mutable_el_gamal_keys()->mutable_element(),
+                       element.ToBytesUnCompressed());
+  request.set_curve_id(kTestCurveId);
+  request.set_maximum_value(kMaxCounterValue);
+  request.set_ciphertext_format(EncryptSketchRequest::FRAMED_V1);
+  *request.mutable_sketch()->mutable_config() = CreateSketchConfig(1, 1, 1);
+  AddRandomRegisters(10, *request.mutable_sketch());
+
+  ASSERT_OK_AND_ASSIGN(std::string encrypted_sketch,
+                       EncryptSketch(request.SerializeAsString()));
+  wfa::any_sketch::crypto::EncryptSketchResponse response;
+  ASSERT_TRUE(response.ParseFromString(encrypted_sketch));
+
+  // The ciphertexts are compressed points whatever the encoding of the key.
+  ASSERT_OK_AND_ASSIGN(std::string unframed,
+                       UnframeCiphertexts(response.encrypted_sketch()));
+  EXPECT_THAT(unframed, SizeIs(10 * 3 * 66));
+}
+
+TEST(SketchEncrypterJavaAdapterTest, deduplicatedValuesOfDestroyedRegisters) {
+  ASSERT_OK_AND_ASSIGN(auto commutativeElGamal,
+                       CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId));
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair,
+                       commutativeElGamal->GetPublicKeyBytes());
+
+  wfa::any_sketch::crypto::EncryptSketchRequest request;
+  request.mutable_el_gamal_keys()->set_generator(public_key_pair.first);
+  request.mutable_el_gamal_keys()->set_element(public_key_pair.second);
+  request.set_curve_id(kTestCurveId);
+  request.set_maximum_value(kMaxCounterValue);
+  request.set_destroyed_register_strategy(EncryptSketchRequest::FLAGGED_KEY);
+  request.set_deduplicate_repeated_values(true);
+  *request.mutable_sketch()->mutable_config() = CreateSketchConfig(1, 1, 1);
+  Sketch::Register* destroyed = request.mutable_sketch()->add_registers();
+  destroyed->set_index(7);
+  destroyed->add_values(-1);
+  destroyed->add_values(1);
+
+  ASSERT_OK_AND_ASSIGN(std::string encrypted_sketch,
+                       EncryptSketch(request.SerializeAsString()));
+  wfa::any_sketch::crypto::EncryptSketchResponse response;
+  ASSERT_TRUE(response.ParseFromString(encrypted_sketch));
+
+  const std::string& ciphertexts = response.encrypted_sketch();
+  ASSERT_THAT(ciphertexts, SizeIs(3 * 66));
+  EXPECT_THAT(
+      commutativeElGamal->Decrypt(
+          {ciphertexts.substr(66, 33), ciphertexts.substr(99, 33)}),
+      IsOkAndHolds(commutativeElGamal
+                       ->Decrypt({ciphertexts.substr(132, 33),
+                                  ciphertexts.substr(165, 33)})
+                       .value()));
+}
+
+// Helper function to create a request encrypting `register_cnt` random
+// registers with publisher noise.
+EncryptSketchRequest CreateNoisyRequest(const int register_cnt) {
+  auto commutativeElGamal =
+      CommutativeElGamal::CreateWithNewKeyPair(kTestCurveId).value();
+  auto public_key_pair = commutativeElGamal->GetPublicKeyBytes().value();
+
+  EncryptSketchRequest request;
+  request.mutable_noise_parameter()->set_epsilon(1);
+  request.mutable_noise_parameter()->set_delta(0.01);
+  request.mutable_noise_parameter()->set_publisher_count(3);
+  request.mutable_el_gamal_keys()->set_generator(public_key_pair.first);
+  request.mutable_el_gamal_keys()->set_element(public_key_pair.second);
+  request.set_curve_id(kTestCurveId);
+  request.set_maximum_value(kMaxCounterValue);
+  *request.mutable_sketch()->mutable_config() = CreateSketchConfig(1, 1, 1);
+  AddRandomRegisters(register_cnt, *request.mutable_sketch());
+  return request;
+}
+
+TEST(SketchEncrypterJavaAdapterTest, stagesAreReportedToTraceSpanCallback) {
+  EncryptSketchRequest request = CreateNoisyRequest(10);
+
+  std::vector<TraceSpan> spans;
+  SetTraceSpanCallback(
+      [&spans](const TraceSpan& span) { spans.push_back(span); });
+  absl::StatusOr<std::string> response =
+      EncryptSketch(request.SerializeAsString());
+  SetTraceSpanCallback(nullptr);
+  ASSERT_THAT(response, IsOk());
+
+  std::vector<std::string> names;
+  for (const TraceSpan& span : spans) {
+    names.push_back(span.name);
+  }
+  EXPECT_THAT(names, ElementsAre("EncryptSketch/ParseRequest",
+                                 "EncryptSketch/CreateWithPublicKey",
+                                 "EncryptSketch/Encrypt",
+                                 "EncryptSketch/AppendNoiseRegisters",
+                                 "EncryptSketch/SerializeResponse",
+                                 "EncryptSketch"));
+  EXPECT_THAT(spans[2].args, Contains(Pair("register_count", 10)));
+  EXPECT_THAT(spans[2].args, Contains(Pair("encrypted_bytes", 10 * 3 * 66)));
+}
+
+TEST(SketchEncrypterJavaAdapterTest, traceFileIsWrittenForTracedRequestsOnly) {
+  const std::string trace_file =
+      ::testing::TempDir() + "/sketch_encrypter_adapter_test_trace.json";
+  std::remove(trace_file.c_str());
+  setenv("ANY_SKETCH_TRACE_FILE", trace_file.c_str(), /*overwrite=*/1);
+  EncryptSketchRequest request = CreateNoisyRequest(1);
+
+  ASSERT_THAT(EncryptSketch(request.SerializeAsString()), IsOk());
+  EXPECT_FALSE(std::ifstream(trace_file).good());
+
+  request.set_trace(true);
+  ASSERT_THAT(EncryptSketch(request.SerializeAsString()), IsOk());
+  unsetenv("ANY_SKETCH_TRACE_FILE");
+  std::stringstream trace;
+  trace << std::ifstream(trace_file).rdbuf();
+  EXPECT_THAT(trace.str(), HasSubstr("\"name\":\"EncryptSketch/Encrypt\""));
+  std::remove(trace_file.c_str());
+}
+
 }  // namespace
 }  // namespace wfa::any_sketch::crypto
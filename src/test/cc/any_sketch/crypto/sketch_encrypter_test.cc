@@ -17,6 +17,7 @@
 #include "absl/strings/escaping.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "any_sketch/crypto/hash_to_curve.h"
 #include "common_cpp/testing/random.h"
 #include "common_cpp/testing/status_macros.h"
 #include "common_cpp/testing/status_matchers.h"
@@ -33,6 +34,7 @@ using ::private_join_and_compute::CommutativeElGamal;
 using ::private_join_and_compute::Context;
 using ::private_join_and_compute::ECGroup;
 using ::private_join_and_compute::ECPoint;
+using ::testing::HasSubstr;
 using ::testing::Not;
 using ::testing::SizeIs;
 using ::wfa::any_sketch::Sketch;
@@ -210,6 +212,68 @@ TEST_F(SketchEncrypterTest, ByteSizeShouldBeCorrect) {
   EXPECT_EQ(result.size(), register_size * (1 + unique_cnt + sum_cnt) * 66);
 }
 
+TEST_F(SketchEncrypterTest, MetricsAreNotCollectedByDefault) {
+  Sketch plain_sketch;
+  *plain_sketch.mutable_config() =
+      CreateSketchConfig(/* unique_cnt = */ 1, /* sum_cnt = */ 1);
+  AddRandomRegisters(/* register_cnt = */ 10, plain_sketch);
+
+  ASSERT_THAT(EncryptWithConflictingKeys(plain_sketch), IsOk());
+
+  SketchEncrypterMetrics metrics = sketch_encrypter_->GetMetrics();
+  EXPECT_EQ(metrics.encryptions, 0);
+  EXPECT_EQ(metrics.bytes_emitted, 0);
+  EXPECT_EQ(metrics.hash_to_curve_calls, 0);
+  EXPECT_EQ(metrics.encryption_nanos, 0);
+}
+
+TEST_F(SketchEncrypterTest, MetricsCountEncryptionWork) {
+  const int unique_cnt = 2;
+  const int sum_cnt = 3;
+  const int register_size = 100;
+  Sketch plain_sketch;
+  *plain_sketch.mutable_config() = CreateSketchConfig(unique_cnt, sum_cnt);
+  AddRandomRegisters(register_size, plain_sketch);
+
+  sketch_encrypter_->EnableMetrics(true);
+  ASSERT_OK_AND_ASSIGN(std::string result,
+                       EncryptWithConflictingKeys(plain_sketch));
+
+  SketchEncrypterMetrics metrics = sketch_encrypter_->GetMetrics();
+  EXPECT_EQ(metrics.encryptions, register_size * (1 + unique_cnt + sum_cnt));
+  EXPECT_EQ(metrics.bytes_emitted, result.size());
+  EXPECT_EQ(metrics.ec_point_cache_hits + metrics.ec_point_cache_misses,
+            register_size * sum_cnt);
+  EXPECT_GT(metrics.hash_to_curve_calls, 0);
+  EXPECT_GT(metrics.encryption_nanos, 0);
+  EXPECT_EQ(metrics.noise_registers, 0);
+
+  sketch_encrypter_->ResetMetrics();
+  metrics = sketch_encrypter_->GetMetrics();
+  EXPECT_EQ(metrics.encryptions, 0);
+  EXPECT_EQ(metrics.encryption_nanos, 0);
+}
+
+TEST_F(SketchEncrypterTest, MetricsCountNoiseRegisters) {
+  const int values_per_register = 2;
+  EncryptSketchRequest::PublisherNoiseParameter noise_parameter;
+  noise_parameter.set_epsilon(1);
+  noise_parameter.set_delta(0.1);
+  noise_parameter.set_publisher_count(3);
+
+  sketch_encrypter_->EnableMetrics(true);
+  std::string encrypted_sketch;
+  ASSERT_THAT(sketch_encrypter_->AppendNoiseRegisters(
+                  noise_parameter, values_per_register, encrypted_sketch),
+              IsOk());
+
+  SketchEncrypterMetrics metrics = sketch_encrypter_->GetMetrics();
+  EXPECT_EQ(metrics.noise_registers,
+            encrypted_sketch.size() / ((values_per_register + 1) * 66));
+  EXPECT_EQ(metrics.encryptions,
+            metrics.noise_registers * (values_per_register + 1));
+}
+
 TEST_F(SketchEncrypterTest, EncryptionOfEmptyValuesShouldBeComplete) {
   const int register_count = 1000;
 
@@ -373,6 +437,120 @@ TEST_F(SketchEncrypterTest, TestDestroyedRegistersUsingFlaggedKey) {
               IsEncryptionOf(original_cipher_.get(), "destroyed_register_key"));
 }
 
+TEST_F(SketchEncrypterTest, DeduplicatedEncryptionOfFlaggedKeyRegisters) {
+  Sketch plain_sketch;
+  *plain_sketch.mutable_config() =
+      CreateSketchConfig(/* unique_cnt = */ 2, /* sum_cnt = */ 1);
+  auto sketch_register = plain_sketch.add_registers();
+  sketch_register->set_index(123);
+  sketch_register->add_values(-1);  // UNIQUE value -1 means destroyed
+  sketch_register->add_values(5);
+  sketch_register->add_values(10);
+
+  sketch_encrypter_->EnableDeduplicatedEncryption(true);
+  sketch_encrypter_->EnableMetrics(true);
+  ASSERT_OK_AND_ASSIGN(std::string result, EncryptWithFlaggedKey(plain_sketch));
+  std::vector<std::string> cipher_words = GetCipherStrings(result);
+  ASSERT_THAT(cipher_words, SizeIs(8));  // 1 regs * 4 vals * 2 words
+
+  CiphertextString index = {cipher_words[0], cipher_words[1]};
+  EXPECT_THAT(index, IsEncryptionOf(original_cipher_.get(), "123"));
+  for (int i = 2; i < 8; i += 2) {
+    CiphertextString value = {cipher_words[i], cipher_words[i + 1]};
+    EXPECT_THAT(value, IsEncryptionOf(original_cipher_.get(),
+                                      "destroyed_register_key"));
+  }
+  // The repeated values are still encrypted with independent randomness.
+  EXPECT_NE(cipher_words[2], cipher_words[4]);
+  EXPECT_NE(cipher_words[4], cipher_words[6]);
+
+  SketchEncrypterMetrics metrics = sketch_encrypter_->GetMetrics();
+  EXPECT_EQ(metrics.encryptions, 4);
+  EXPECT_EQ(metrics.pooled_encryptions, 3);
+  EXPECT_EQ(metrics.bytes_emitted, result.size());
+}
+
+TEST_F(SketchEncrypterTest, DeduplicatedEncryptionOfConflictingKeys) {
+  Sketch plain_sketch;
+  *plain_sketch.mutable_config() =
+      CreateSketchConfig(/* unique_cnt = */ 1, /* sum_cnt = */ 1);
+  auto sketch_register = plain_sketch.add_registers();
+  sketch_register->set_index(123);
+  sketch_register->add_values(-1);  // UNIQUE value -1 means destroyed
+  sketch_register->add_values(10);
+
+  sketch_encrypter_->EnableDeduplicatedEncryption(true);
+  ASSERT_THAT(sketch_encrypter_->PrecomputeIdentityEncryptions(2), IsOk());
+  ASSERT_OK_AND_ASSIGN(std::string result,
+                       EncryptWithConflictingKeys(plain_sketch));
+  std::vector<std::string> cipher_words = GetCipherStrings(result);
+  ASSERT_THAT(cipher_words, SizeIs(12));  // 2 regs * 3 vals * 2 words
+
+  CiphertextString key_a = {cipher_words[2], cipher_words[3]};
+  CiphertextString count_a = {cipher_words[4], cipher_words[5]};
+  CiphertextString key_b = {cipher_words[8], cipher_words[9]};
+  CiphertextString count_b = {cipher_words[10], cipher_words[11]};
+  EXPECT_THAT(key_a, HasSameDecryption(original_cipher_.get(), count_a));
+  EXPECT_THAT(key_b, HasSameDecryption(original_cipher_.get(), count_b));
+  EXPECT_THAT(key_a, Not(HasSameDecryption(original_cipher_.get(), key_b)));
+  EXPECT_NE(key_a.u, count_a.u);
+}
+
+TEST_F(SketchEncrypterTest, PrecomputingNegativeIdentityEncryptionsFails) {
+  EXPECT_THAT(sketch_encrypter_->PrecomputeIdentityEncryptions(-1),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(SketchEncrypterTest, SswuMapsPlaintextsWithHashToCurve) {
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair,
+                       original_cipher_->GetPublicKeyBytes());
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<SketchEncrypter> sswu_encrypter,
+      CreateWithPublicKey(kTestCurveId, kMaxCounterValue,
+                          {.u = public_key_pair.first,
+                           .e = public_key_pair.second},
+                          EncryptSketchRequest::SSWU_V1));
+  Sketch plain_sketch;
+  *plain_sketch.mutable_config() =
+      CreateSketchConfig(/* unique_cnt = */ 1, /* sum_cnt = */ 0);
+  auto sketch_register = plain_sketch.add_registers();
+  sketch_register->set_index(123);
+  sketch_register->add_values(456);
+
+  ASSERT_OK_AND_ASSIGN(
+      std::string result,
+      sswu_encrypter->Encrypt(plain_sketch, EncryptSketchRequest::FLAGGED_KEY));
+  std::vector<std::string> cipher_words = GetCipherStrings(result);
+  ASSERT_THAT(cipher_words, SizeIs(4));
+
+  Context ctx;
+  ASSERT_OK_AND_ASSIGN(ECGroup ec_group, ECGroup::Create(kTestCurveId, &ctx));
+  ASSERT_OK_AND_ASSIGN(HashToCurve hash_to_curve,
+                       HashToCurve::Create(EncryptSketchRequest::SSWU_V1,
+                                           kTestCurveId, &ec_group, &ctx));
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(
+        std::string decrypted,
+        original_cipher_->Decrypt(
+            std::make_pair(cipher_words[2 * i], cipher_words[2 * i + 1])));
+    ASSERT_OK_AND_ASSIGN(ECPoint expected,
+                         hash_to_curve.Hash(i == 0 ? "123" : "456"));
+    EXPECT_THAT(expected.ToBytesCompressed(), IsOkAndHolds(decrypted));
+  }
+}
+
+TEST_F(SketchEncrypterTest, SswuFailsOnOtherCurves) {
+  ASSERT_OK_AND_ASSIGN(auto cipher,
+                       CommutativeElGamal::CreateWithNewKeyPair(NID_secp224r1));
+  ASSERT_OK_AND_ASSIGN(auto public_key_pair, cipher->GetPublicKeyBytes());
+
+  EXPECT_THAT(CreateWithPublicKey(NID_secp224r1, kMaxCounterValue,
+                                  {.u = public_key_pair.first,
+                                   .e = public_key_pair.second},
+                                  EncryptSketchRequest::SSWU_V1),
+              StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("P-256")));
+}
+
 TEST_F(SketchEncrypterTest, CombineElGamalPublicKeysNormalCases) {
   ElGamalPublicKey key1;
   key1.set_generator(absl::HexStringToBytes(kElGamalPublicKeyG));
@@ -417,6 +595,54 @@ TEST_F(SketchEncrypterTest, CombineElGamalPublicKeysInvalidInputShouldThrow) {
               StatusIs(absl::StatusCode::kInvalidArgument, "Invalid ECPoint"));
 }
 
+TEST_F(SketchEncrypterTest, CombineElGamalPublicKeySetsCombinesEachSet) {
+  ElGamalPublicKey key1;
+  key1.set_generator(absl::HexStringToBytes(kElGamalPublicKeyG));
+  key1.set_element(absl::HexStringToBytes(kElGamalPublicKeyY1));
+  ElGamalPublicKey key2 = key1;
+  key2.set_element(absl::HexStringToBytes(kElGamalPublicKeyY2));
+  ElGamalPublicKey key3 = key1;
+  key3.set_element(absl::HexStringToBytes(kElGamalPublicKeyY3));
+  ElGamalPublicKey combined_key = key1;
+  combined_key.set_element(absl::HexStringToBytes(kCombinedElGamalPublicKeyY));
+  std::vector<std::vector<ElGamalPublicKey>> key_sets;
+  for (int i = 0; i < 10; ++i) {
+    key_sets.push_back({key1, key2, key3});
+    key_sets.push_back({key2});
+  }
+
+  ASSERT_OK_AND_ASSIGN(std::vector<ElGamalPublicKey> result,
+                       CombineElGamalPublicKeySets(kTestCurveId, key_sets,
+                                                   /*thread_count=*/3));
+  ASSERT_THAT(result, SizeIs(key_sets.size()));
+  for (size_t i = 0; i < result.size(); ++i) {
+    EXPECT_THAT(result[i], EqualsProto(i % 2 == 0 ? combined_key : key2));
+  }
+}
+
+TEST_F(SketchEncrypterTest, CombineElGamalPublicKeySetsReportsTheFailedSet) {
+  ElGamalPublicKey key;
+  key.set_generator(absl::HexStringToBytes(kElGamalPublicKeyG));
+  key.set_element(absl::HexStringToBytes(kElGamalPublicKeyY1));
+  ElGamalPublicKey invalid_key = key;
+  invalid_key.set_element("bar");
+  std::vector<std::vector<ElGamalPublicKey>> key_sets = {
+      {key, key}, {key}, {key, invalid_key}};
+
+  EXPECT_THAT(
+      CombineElGamalPublicKeySets(kTestCurveId, key_sets, /*thread_count=*/2),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Key set 2: Invalid ECPoint")));
+  EXPECT_THAT(CombineElGamalPublicKeySets(kTestCurveId, {{key}, {}}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Key set 1: Keys cannot be empty")));
+}
+
+TEST_F(SketchEncrypterTest, CombineElGamalPublicKeySetsOfNoSetsIsEmpty) {
+  EXPECT_THAT(CombineElGamalPublicKeySets(kTestCurveId, {}, 4),
+              IsOkAndHolds(SizeIs(0)));
+}
+
 TEST_F(SketchEncrypterTest, NoisesShouldHaveTheSameIndex) {
   Context ctx;
   ASSERT_OK_AND_ASSIGN(ECGroup ec_group, ECGroup::Create(kTestCurveId, &ctx));
@@ -449,5 +675,37 @@ TEST_F(SketchEncrypterTest, NoisesShouldHaveTheSameIndex) {
   }
 }
 
+TEST_F(SketchEncrypterTest, DeduplicatedNoiseRegistersRepeatTheRandomValue) {
+  std::string encrypted_sketch;
+  int values_per_register = 3;
+  int ciphertexts_per_register = (values_per_register + 1) * 2;
+
+  EncryptSketchRequest::PublisherNoiseParameter noise_parameter;
+  noise_parameter.set_epsilon(1);
+  noise_parameter.set_delta(0.1);
+  noise_parameter.set_publisher_count(3);
+
+  sketch_encrypter_->EnableDeduplicatedEncryption(true);
+  ASSERT_THAT(sketch_encrypter_->AppendNoiseRegisters(
+                  noise_parameter, values_per_register, encrypted_sketch),
+              IsOk());
+
+  std::vector<std::string> cipher_words = GetCipherStrings(encrypted_sketch);
+  ASSERT_EQ(cipher_words.size() % ciphertexts_per_register, 0);
+  ASSERT_GT(cipher_words.size(), 0);
+  for (int i = 0; i < cipher_words.size(); i += ciphertexts_per_register) {
+    CiphertextString index = {cipher_words[i], cipher_words[i + 1]};
+    EXPECT_THAT(index, IsEncryptionOf(original_cipher_.get(),
+                                      "publisher_noise_register_id"));
+    CiphertextString first_value = {cipher_words[i + 2], cipher_words[i + 3]};
+    for (int j = 4; j < ciphertexts_per_register; j += 2) {
+      CiphertextString value = {cipher_words[i + j], cipher_words[i + j + 1]};
+      EXPECT_THAT(value,
+                  HasSameDecryption(original_cipher_.get(), first_value));
+      EXPECT_NE(value.u, first_value.u);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace wfa::any_sketch::crypto
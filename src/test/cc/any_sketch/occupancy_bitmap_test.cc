@@ -0,0 +1,154 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/occupancy_bitmap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+using ::testing::Lt;
+
+constexpr uint64_t kChunkSize = uint64_t{1} << 16;
+
+// Indexes spread over several chunks: a sparse one, a dense one, one that is
+// full and a few far apart, as in a 2^40 index space.
+std::set<uint64_t> MakeIndexes(uint64_t seed) {
+  std::set<uint64_t> indexes;
+  for (uint64_t i = seed; i < kChunkSize; i += 97) indexes.insert(i);
+  for (uint64_t i = seed; i < kChunkSize; i += 3) {
+    indexes.insert(kChunkSize + i);
+  }
+  if (seed % 2 == 0) {
+    for (uint64_t i = 0; i < kChunkSize; ++i) {
+      indexes.insert(5 * kChunkSize + i);
+    }
+  }
+  for (uint64_t i = 1; i < 10; ++i) indexes.insert((i << 36) + seed * i);
+  return indexes;
+}
+
+std::vector<uint64_t> GetIndexes(const OccupancyBitmap& bitmap) {
+  std::vector<uint64_t> indexes;
+  bitmap.ForEach([&indexes](uint64_t index) { indexes.push_back(index); });
+  return indexes;
+}
+
+OccupancyBitmap ToBitmap(const std::set<uint64_t>& indexes) {
+  // In decreasing order, with repeats.
+  std::vector<uint64_t> vector(indexes.rbegin(), indexes.rend());
+  vector.insert(vector.end(), indexes.begin(), indexes.end());
+  return OccupancyBitmap::FromIndexes(std::move(vector));
+}
+
+TEST(OccupancyBitmapTest, HoldsTheIndexes) {
+  const std::set<uint64_t> indexes = MakeIndexes(0);
+  OccupancyBitmap bitmap = ToBitmap(indexes);
+
+  EXPECT_THAT(GetIndexes(bitmap), ElementsAreArray(indexes));
+  EXPECT_EQ(bitmap.cardinality(), indexes.size());
+  EXPECT_TRUE(bitmap.Contains(kChunkSize + 3));
+  EXPECT_FALSE(bitmap.Contains(kChunkSize + 4));
+  EXPECT_TRUE(bitmap.Contains(97));
+  EXPECT_FALSE(bitmap.Contains(98));
+  EXPECT_TRUE(bitmap.Contains(uint64_t{1} << 36));
+  EXPECT_FALSE(bitmap.Contains((uint64_t{1} << 36) + 1));
+}
+
+TEST(OccupancyBitmapTest, SparseIndexesStayCompact) {
+  std::vector<uint64_t> indexes;
+  for (uint64_t i = 0; i < 10'000; ++i) indexes.push_back(i << 24);
+  OccupancyBitmap bitmap = OccupancyBitmap::FromIndexes(indexes);
+
+  EXPECT_EQ(bitmap.cardinality(), 10'000);
+  // A thousandth of a bitset of the index space.
+  EXPECT_THAT(bitmap.memory_bytes(), Lt((uint64_t{10'000} << 24) / 8 / 1000));
+}
+
+TEST(OccupancyBitmapTest, SetOperationsMatchSets) {
+  for (auto [seed_a, seed_b] : {std::pair(0, 1), std::pair(0, 2),
+                                std::pair(1, 3), std::pair(4, 4)}) {
+    const std::set<uint64_t> a = MakeIndexes(seed_a);
+    const std::set<uint64_t> b = MakeIndexes(seed_b);
+    std::vector<uint64_t> intersection;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(intersection));
+    std::vector<uint64_t> union_;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                   std::back_inserter(union_));
+
+    OccupancyBitmap and_bitmap =
+        OccupancyBitmap::And(ToBitmap(a), ToBitmap(b));
+    OccupancyBitmap or_bitmap = OccupancyBitmap::Or(ToBitmap(a), ToBitmap(b));
+    EXPECT_EQ(GetIndexes(and_bitmap), intersection);
+    EXPECT_EQ(GetIndexes(or_bitmap), union_);
+    EXPECT_EQ(OccupancyBitmap::AndCardinality(ToBitmap(a), ToBitmap(b)),
+              intersection.size());
+    EXPECT_EQ(and_bitmap.cardinality(), intersection.size());
+    EXPECT_EQ(or_bitmap.cardinality(), union_.size());
+    // The results have the same layout as bitmaps built from scratch.
+    EXPECT_TRUE(and_bitmap == OccupancyBitmap::FromIndexes(intersection));
+    EXPECT_TRUE(or_bitmap == OccupancyBitmap::FromIndexes(union_));
+  }
+}
+
+TEST(OccupancyBitmapTest, EmptyBitmap) {
+  OccupancyBitmap empty;
+  OccupancyBitmap bitmap = ToBitmap(MakeIndexes(0));
+
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.cardinality(), 0);
+  EXPECT_THAT(GetIndexes(empty), IsEmpty());
+  EXPECT_TRUE(OccupancyBitmap::And(empty, bitmap).empty());
+  EXPECT_TRUE(OccupancyBitmap::Or(empty, bitmap) == bitmap);
+  EXPECT_EQ(OccupancyBitmap::AndCardinality(bitmap, empty), 0);
+}
+
+TEST(OccupancyBitmapTest, FromSketchHoldsTheRegisterIndexes) {
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetOracleDistribution("index", 0, 1'000'000));
+  std::vector<ValueFunction> values;
+  values.push_back({.name = "Count",
+                    .aggregator_type = AggregatorType::kSum,
+                    .distribution = GetOracleDistribution("count", 0, 10)});
+  AnySketch sketch(std::move(indexes), std::move(values));
+  ASSERT_THAT(sketch.AggregateIntoRegister(70'000, {1}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(3, {1}), IsOk());
+  ASSERT_THAT(sketch.AggregateIntoRegister(3, {1}), IsOk());
+
+  OccupancyBitmap bitmap = OccupancyBitmap::FromSketch(sketch);
+  EXPECT_THAT(GetIndexes(bitmap), ElementsAre(3, 70'000));
+  EXPECT_EQ(bitmap.cardinality(), sketch.register_count());
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
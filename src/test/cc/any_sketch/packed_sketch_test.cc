@@ -0,0 +1,170 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/packed_sketch.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "google/protobuf/util/message_differencer.h"
+#include "gtest/gtest.h"
+#include "wfa/any_sketch/sketch.pb.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Lt;
+using ::testing::SizeIs;
+
+MATCHER_P(EqualsProto, expected, "") {
+  return ::google::protobuf::util::MessageDifferencer::Equals(arg, expected);
+}
+
+Sketch CreateSketch(int value_count) {
+  Sketch sketch;
+  for (int i = 0; i < value_count; ++i) {
+    sketch.mutable_config()->add_values()->set_aggregator(
+        SketchConfig::ValueSpec::SUM);
+  }
+  return sketch;
+}
+
+void AddRegister(int64_t index, const std::vector<int64_t>& values,
+                 Sketch& sketch) {
+  Sketch::Register* sketch_register = sketch.add_registers();
+  sketch_register->set_index(index);
+  for (int64_t value : values) {
+    sketch_register->add_values(value);
+  }
+}
+
+TEST(PackedSketchTest, EmptySketchRoundTrips) {
+  Sketch sketch = CreateSketch(2);
+
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+  ASSERT_OK_AND_ASSIGN(Sketch decoded, DecodePackedSketch(packed));
+
+  EXPECT_THAT(decoded, EqualsProto(sketch));
+}
+
+TEST(PackedSketchTest, RegistersRoundTripSortedByIndex) {
+  Sketch sketch = CreateSketch(2);
+  AddRegister(30, {3, -1}, sketch);
+  AddRegister(10, {1, 0}, sketch);
+  AddRegister(20, {2, 5}, sketch);
+
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+  ASSERT_OK_AND_ASSIGN(Sketch decoded, DecodePackedSketch(packed));
+
+  Sketch expected = CreateSketch(2);
+  AddRegister(10, {1, 0}, expected);
+  AddRegister(20, {2, 5}, expected);
+  AddRegister(30, {3, -1}, expected);
+  EXPECT_THAT(decoded, EqualsProto(expected));
+}
+
+TEST(PackedSketchTest, ExtremeValuesRoundTrip) {
+  constexpr int64_t kMin = std::numeric_limits<int64_t>::min();
+  constexpr int64_t kMax = std::numeric_limits<int64_t>::max();
+  Sketch sketch = CreateSketch(1);
+  AddRegister(kMin, {kMax}, sketch);
+  AddRegister(-1, {kMin}, sketch);
+  AddRegister(kMax, {0}, sketch);
+
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+  ASSERT_OK_AND_ASSIGN(Sketch decoded, DecodePackedSketch(packed));
+
+  EXPECT_THAT(decoded, EqualsProto(sketch));
+}
+
+TEST(PackedSketchTest, ManyBlocksOfMixedWidthsRoundTrip) {
+  Sketch sketch = CreateSketch(3);
+  uint64_t state = 1;
+  for (int i = 0; i < 1000; ++i) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    // Widths vary between blocks, from 0 bits up to 63.
+    const int width = (i / 128) * 9;
+    const int64_t noise =
+        width == 0 ? 0 : static_cast<int64_t>(state >> (64 - width));
+    AddRegister(i * 7 + (noise & 3), {noise, i % 5, -noise}, sketch);
+  }
+
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+  ASSERT_OK_AND_ASSIGN(Sketch decoded, DecodePackedSketch(packed));
+
+  EXPECT_THAT(decoded, EqualsProto(sketch));
+}
+
+TEST(PackedSketchTest, DenseSketchIsSmallerThanProto) {
+  Sketch sketch = CreateSketch(2);
+  for (int i = 0; i < 10'000; ++i) {
+    AddRegister(i * 3, {i % 7 + 1, 1}, sketch);
+  }
+
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+
+  EXPECT_THAT(packed, SizeIs(Lt(sketch.ByteSizeLong() / 4)));
+}
+
+TEST(PackedSketchTest, EncodeFailsWhenValueCountDoesNotMatchConfig) {
+  Sketch sketch = CreateSketch(2);
+  AddRegister(1, {1}, sketch);
+
+  EXPECT_THAT(EncodePackedSketch(sketch).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has 1 values but the config has 2")));
+}
+
+TEST(PackedSketchTest, DecodeFailsOnTruncatedInput) {
+  Sketch sketch = CreateSketch(1);
+  for (int i = 0; i < 300; ++i) {
+    AddRegister(i, {i}, sketch);
+  }
+  ASSERT_OK_AND_ASSIGN(std::string packed, EncodePackedSketch(sketch));
+
+  for (size_t size = 0; size < packed.size(); ++size) {
+    EXPECT_THAT(
+        DecodePackedSketch(packed.substr(0, size)).status(),
+        StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("truncated")));
+  }
+}
+
+TEST(PackedSketchTest, DecodeFailsOnUnknownVersion) {
+  ASSERT_OK_AND_ASSIGN(std::string packed,
+                       EncodePackedSketch(CreateSketch(0)));
+  packed[0] = 2;
+
+  EXPECT_THAT(DecodePackedSketch(packed).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("format version 2")));
+}
+
+TEST(PackedSketchTest, DecodeFailsOnTrailingBytes) {
+  ASSERT_OK_AND_ASSIGN(std::string packed,
+                       EncodePackedSketch(CreateSketch(0)));
+  packed.push_back(0);
+
+  EXPECT_THAT(DecodePackedSketch(packed).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("trailing bytes")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
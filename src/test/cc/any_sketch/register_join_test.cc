@@ -0,0 +1,146 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/register_join.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::Contains;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+
+using Registers = std::vector<std::pair<uint64_t, std::vector<int64_t>>>;
+
+// A sketch with a SUM and a UNIQUE value.
+std::unique_ptr<AnySketch> MakeSketch() {
+  return MakeOracleSketch(0, 1'000'000,
+                          {AggregatorType::kSum, AggregatorType::kUnique});
+}
+
+// Returns a sketch with a register at each index in [first, last) that is a
+// multiple of `step`, with values {1, index % 3}.
+std::unique_ptr<AnySketch> MakeFilledSketch(int first, int last, int step) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  for (int i = first; i < last; i += step) {
+    EXPECT_THAT(sketch->AggregateIntoRegister(i, {1, i % 3}), IsOk());
+  }
+  return sketch;
+}
+
+auto Collect(Registers& registers) {
+  return [&registers](const AnySketch::Register& reg) {
+    registers.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  };
+}
+
+Registers Intersect(const AnySketch& left, const AnySketch& right) {
+  Registers registers;
+  EXPECT_THAT(IntersectSortedRegisters(left.SortedRegisters(),
+                                       right.SortedRegisters(),
+                                       left.value_functions(),
+                                       Collect(registers)),
+              IsOk());
+  return registers;
+}
+
+Registers Subtract(const AnySketch& left, const AnySketch& right) {
+  Registers registers;
+  SubtractSortedRegisters(left.SortedRegisters(), right.SortedRegisters(),
+                          Collect(registers));
+  return registers;
+}
+
+Registers Sorted(const AnySketch& sketch) {
+  Registers registers;
+  sketch.ForEachSorted(Collect(registers));
+  return registers;
+}
+
+TEST(RegisterJoinTest, IntersectionMatchesAnySketchIntersect) {
+  // Overlapping ranges with different densities, so that both sides are
+  // skipped through.
+  std::unique_ptr<AnySketch> left = MakeFilledSketch(0, 10'000, 2);
+  std::unique_ptr<AnySketch> right = MakeFilledSketch(5'000, 20'000, 3);
+  ASSERT_THAT(right->AggregateIntoRegister(6000, {1, 2}), IsOk());
+
+  Registers joined = Intersect(*left, *right);
+  ASSERT_THAT(left->Intersect(*right), IsOk());
+  EXPECT_EQ(joined, Sorted(*left));
+  // 6000 is in both, with conflicting UNIQUE values.
+  EXPECT_THAT(joined, Contains(Pair(6000, ElementsAre(2, -1))));
+}
+
+TEST(RegisterJoinTest, IntersectionWithSparseSide) {
+  std::unique_ptr<AnySketch> dense = MakeFilledSketch(0, 100'000, 1);
+  std::unique_ptr<AnySketch> sparse = MakeFilledSketch(50, 200'000, 9973);
+
+  Registers joined = Intersect(*sparse, *dense);
+  EXPECT_EQ(joined, Intersect(*dense, *sparse));
+  ASSERT_THAT(sparse->Intersect(*dense), IsOk());
+  EXPECT_EQ(joined, Sorted(*sparse));
+}
+
+TEST(RegisterJoinTest, DifferenceMatchesAnySketchSubtract) {
+  for (int step : {1, 7, 5000}) {
+    std::unique_ptr<AnySketch> left = MakeFilledSketch(0, 10'000, 2);
+    std::unique_ptr<AnySketch> right = MakeFilledSketch(3'000, 20'000, step);
+
+    Registers difference = Subtract(*left, *right);
+    ASSERT_THAT(left->Subtract(*right), IsOk());
+    EXPECT_EQ(difference, Sorted(*left)) << "step " << step;
+  }
+}
+
+TEST(RegisterJoinTest, EmptyInputs) {
+  std::unique_ptr<AnySketch> empty = MakeSketch();
+  std::unique_ptr<AnySketch> full = MakeFilledSketch(0, 100, 1);
+
+  EXPECT_THAT(Intersect(*empty, *full), IsEmpty());
+  EXPECT_THAT(Intersect(*full, *empty), IsEmpty());
+  EXPECT_THAT(Subtract(*empty, *full), IsEmpty());
+  EXPECT_EQ(Subtract(*full, *empty), Sorted(*full));
+}
+
+TEST(RegisterJoinTest, IntersectionFailsOnWrongValueCount) {
+  const std::vector<int64_t> values = {1};
+  const std::vector<AnySketch::Register> registers = {
+      {.index = 1, .values = values}};
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+
+  EXPECT_THAT(IntersectSortedRegisters(registers, registers,
+                                       sketch->value_functions(),
+                                       [](const AnySketch::Register&) {}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Register 1 has 1 values")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,198 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_builder.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/sketch_spec.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+using ::testing::SizeIs;
+
+// Wide enough for the indexes of test events not to collide.
+constexpr int64_t kIndexCount = int64_t{1} << 40;
+
+// A sketch with a uniform index and the SUM of the "frequency" column.
+SketchSpec FrequencySketchSpec() {
+  SketchSpec spec;
+  spec.indexes.push_back(
+      {.type = DistributionSpec::Type::kUniform, .num_values = kIndexCount});
+  spec.values.push_back(
+      {.name = "frequency",
+       .aggregator_type = AggregatorType::kSum,
+       .distribution = {.type = DistributionSpec::Type::kOracle,
+                        .feature_name = "frequency"}});
+  return spec;
+}
+
+// A sketch with a uniform index and no values.
+SketchSpec IndexOnlySketchSpec() {
+  SketchSpec spec;
+  spec.indexes.push_back(
+      {.type = DistributionSpec::Type::kUniform, .num_values = kIndexCount});
+  return spec;
+}
+
+std::vector<std::pair<uint64_t, std::vector<int64_t>>> GetRegisters(
+    const AnySketch& sketch) {
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> registers;
+  sketch.ForEachSorted([&registers](const AnySketch::Register& reg) {
+    registers.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  });
+  return registers;
+}
+
+std::string LengthDelimited(const std::vector<std::string>& events) {
+  std::string out;
+  for (const std::string& event : events) {
+    // All test events are shorter than 128 bytes.
+    out.push_back(static_cast<char>(event.size()));
+    out.append(event);
+  }
+  return out;
+}
+
+TEST(SketchBuilderTest, NewlineDelimitedEventsWithMetadata) {
+  EventFileOptions options = {.column_delimiter = ',',
+                              .metadata_columns = {"frequency"}};
+
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AnySketch> sketch,
+      BuildSketch(FrequencySketchSpec(), "a,1\nb,2\r\n\na,3", options));
+
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> registers =
+      GetRegisters(*sketch);
+  ASSERT_THAT(registers, SizeIs(2));
+  EXPECT_EQ(registers[0].second[0] + registers[1].second[0], 6);
+  EXPECT_EQ(sketch->Stats().insert_count, 3);
+}
+
+TEST(SketchBuilderTest, ThreadsProduceTheSameSketch) {
+  std::string newline_events;
+  std::vector<std::string> event_ids;
+  for (int i = 0; i < 10'000; ++i) {
+    absl::StrAppend(&newline_events, "event-", i % 3'000, "\t", i % 7, "\n");
+    event_ids.push_back(absl::StrCat("event-", i % 3'000));
+  }
+  const std::string length_delimited_events = LengthDelimited(event_ids);
+
+  EventFileOptions newline_options = {.metadata_columns = {"frequency"}};
+  EventFileOptions length_delimited_options = {
+      .format = EventFileFormat::kLengthDelimited};
+  ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AnySketch> newline_expected,
+      BuildSketch(FrequencySketchSpec(), newline_events, newline_options));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> length_delimited_expected,
+                       BuildSketch(IndexOnlySketchSpec(),
+                                   length_delimited_events,
+                                   length_delimited_options));
+  EXPECT_THAT(GetRegisters(*newline_expected), SizeIs(3'000));
+  EXPECT_THAT(GetRegisters(*length_delimited_expected), SizeIs(3'000));
+
+  for (int thread_count : {2, 3, 16}) {
+    newline_options.thread_count = thread_count;
+    length_delimited_options.thread_count = thread_count;
+    ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<AnySketch> newline_sketch,
+        BuildSketch(FrequencySketchSpec(), newline_events, newline_options));
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> length_delimited_sketch,
+                         BuildSketch(IndexOnlySketchSpec(),
+                                     length_delimited_events,
+                                     length_delimited_options));
+
+    EXPECT_EQ(GetRegisters(*newline_sketch), GetRegisters(*newline_expected));
+    EXPECT_EQ(GetRegisters(*length_delimited_sketch),
+              GetRegisters(*length_delimited_expected));
+  }
+}
+
+TEST(SketchBuilderTest, MoreThreadsThanEvents) {
+  EventFileOptions options = {.thread_count = 8};
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> sketch,
+                       BuildSketch(IndexOnlySketchSpec(), "a\n", options));
+  EXPECT_THAT(GetRegisters(*sketch), SizeIs(1));
+
+  ASSERT_OK_AND_ASSIGN(sketch, BuildSketch(IndexOnlySketchSpec(), "", options));
+  EXPECT_THAT(GetRegisters(*sketch), IsEmpty());
+}
+
+TEST(SketchBuilderTest, InvalidMetadataColumnsFail) {
+  EventFileOptions options = {.metadata_columns = {"frequency"}};
+
+  EXPECT_THAT(BuildSketch(FrequencySketchSpec(), "a\t1\nb\tx\n", options)
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Event at byte 4: metadata column 1")));
+  EXPECT_THAT(
+      BuildSketch(FrequencySketchSpec(), "a\n", options).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("missing")));
+  EXPECT_THAT(
+      BuildSketch(FrequencySketchSpec(), "a\t1\t2\n", options).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("got more")));
+}
+
+TEST(SketchBuilderTest, MissingOracleKeyFails) {
+  EXPECT_THAT(BuildSketch(FrequencySketchSpec(), "a\n", {}).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Could not find key frequency")));
+}
+
+TEST(SketchBuilderTest, TruncatedLengthDelimitedEventFails) {
+  std::string events = LengthDelimited({"abc", "def"});
+  events.pop_back();
+
+  for (int thread_count : {1, 2}) {
+    EventFileOptions options = {.format = EventFileFormat::kLengthDelimited,
+                                .thread_count = thread_count};
+    EXPECT_THAT(BuildSketch(IndexOnlySketchSpec(), events, options).status(),
+                StatusIs(absl::StatusCode::kInvalidArgument,
+                         HasSubstr("Event at byte 4: truncated event")));
+  }
+}
+
+TEST(SketchBuilderTest, BuildSerializedSketch) {
+  ASSERT_OK_AND_ASSIGN(std::string config, SerializeSketchConfigText(R"pb(
+    indexes { distribution { uniform { num_values: 100 } } }
+  )pb"));
+
+  ASSERT_OK_AND_ASSIGN(std::string sketch,
+                       BuildSerializedSketch(config, "a\nb\n", {}));
+
+  EXPECT_THAT(sketch, Not(IsEmpty()));
+  EXPECT_THAT(BuildSerializedSketch("invalid", "a\n", {}).status(),
+              Not(IsOk()));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,145 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_group.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/value_function.h"
+#include "common_cpp/fingerprinters/fingerprinters.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Not;
+using ::testing::Pair;
+
+// A Liquid Legions-like sketch: an exponential index, a UNIQUE sampling
+// indicator and the SUM of the "frequency" metadata.
+std::unique_ptr<AnySketch> MakeSketch() {
+  const Fingerprinter* fingerprinter = &GetFarmFingerprinter();
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetExponentialDistribution(fingerprinter, 12, 1000));
+  std::vector<ValueFunction> values;
+  values.push_back(
+      {.name = "SamplingIndicator",
+       .aggregator_type = AggregatorType::kUnique,
+       .distribution = GetUniformDistribution(fingerprinter, 0, 1'000'000)});
+  values.push_back(
+      {.name = "Frequency",
+       .aggregator_type = AggregatorType::kSum,
+       .distribution = GetOracleDistribution("frequency", 0, 100)});
+  return std::make_unique<AnySketch>(std::move(indexes), std::move(values));
+}
+
+std::vector<std::pair<uint64_t, std::vector<int64_t>>> GetRegisters(
+    const AnySketch& sketch) {
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> registers;
+  sketch.ForEachSorted([&registers](const AnySketch::Register& reg) {
+    registers.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  });
+  return registers;
+}
+
+TEST(SketchGroupTest, CreateFailsWithoutMembers) {
+  EXPECT_THAT(SketchGroup::Create(0, MakeSketch).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("should be positive")));
+  EXPECT_THAT(SketchGroup::Create(1, nullptr).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(SketchGroupTest, CreateFailsWhenTheFactoryReturnsNull) {
+  EXPECT_THAT(
+      SketchGroup::Create(2, [] { return std::unique_ptr<AnySketch>(); })
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("returned null")));
+}
+
+TEST(SketchGroupTest, InsertMatchesInsertingIntoEachMember) {
+  constexpr int kMemberCount = 5;
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchGroup> group,
+                       SketchGroup::Create(kMemberCount, MakeSketch));
+  std::vector<std::unique_ptr<AnySketch>> expected;
+  for (int i = 0; i < kMemberCount; ++i) {
+    expected.push_back(MakeSketch());
+  }
+
+  for (int i = 0; i < 1000; ++i) {
+    const std::string item = absl::StrCat("item-", i);
+    const ItemMetadata metadata = {{"frequency", i % 3}};
+    // Every item goes to member 0, and to one or two of the others.
+    const std::vector<int> members = {0, 1 + i % 4, 1 + (i / 4) % 4};
+    ASSERT_THAT(group->Insert(item, metadata, members), IsOk());
+    for (int member : members) {
+      ASSERT_THAT(expected[member]->Insert(item, metadata), IsOk());
+    }
+  }
+
+  ASSERT_EQ(group->member_count(), kMemberCount);
+  EXPECT_EQ(group->member(0).Stats().insert_count, 1000);
+  for (int i = 0; i < kMemberCount; ++i) {
+    EXPECT_EQ(GetRegisters(group->member(i)), GetRegisters(*expected[i]))
+        << "member " << i;
+    EXPECT_EQ(group->member(i).Stats().insert_count,
+              expected[i]->Stats().insert_count)
+        << "member " << i;
+  }
+}
+
+TEST(SketchGroupTest, InsertWithMemberOutOfRangeInsertsNothing) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchGroup> group,
+                       SketchGroup::Create(2, MakeSketch));
+
+  EXPECT_THAT(group->Insert("a", {{"frequency", 1}}, {0, 2}),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Member 2 is not in the group of 2")));
+  EXPECT_THAT(group->Insert("a", {{"frequency", 1}}, {-1}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(GetRegisters(group->member(0)), IsEmpty());
+}
+
+TEST(SketchGroupTest, InsertFailsOnMissingMetadata) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SketchGroup> group,
+                       SketchGroup::Create(2, MakeSketch));
+
+  EXPECT_THAT(group->Insert("a", {}, {0, 1}), Not(IsOk()));
+  EXPECT_THAT(group->Insert("a", {}, {}), IsOk());
+  ASSERT_THAT(group->Insert("a", {{"frequency", 1}}, {1}), IsOk());
+
+  EXPECT_THAT(GetRegisters(group->member(0)), IsEmpty());
+  EXPECT_THAT(GetRegisters(group->member(1)),
+              ElementsAre(Pair(_, ElementsAre(_, 1))));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
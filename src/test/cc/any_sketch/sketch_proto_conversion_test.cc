@@ -0,0 +1,180 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_proto_conversion.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "gtest/gtest.h"
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::google::protobuf::io::CodedInputStream;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+// A Sketch proto decoded from its wire format. sketch.pb.h cannot be used
+// alongside any_sketch.h, see sketch_proto_conversion.h.
+struct DecodedSketch {
+  std::string config;
+  std::vector<std::pair<int64_t, std::vector<int64_t>>> registers;
+};
+
+bool DecodeRegister(CodedInputStream& input,
+                    std::pair<int64_t, std::vector<int64_t>>& reg) {
+  while (uint32_t tag = input.ReadTag()) {
+    uint64_t varint;
+    if (tag == 0x08) {
+      if (!input.ReadVarint64(&varint)) return false;
+      reg.first = varint;
+    } else if (tag == 0x12) {
+      uint32_t length;
+      if (!input.ReadVarint32(&length)) return false;
+      CodedInputStream::Limit limit = input.PushLimit(length);
+      while (input.BytesUntilLimit() > 0) {
+        if (!input.ReadVarint64(&varint)) return false;
+        reg.second.push_back(varint);
+      }
+      input.PopLimit(limit);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Decodes the fields of Sketch that SerializeSketchProto writes.
+bool DecodeSketch(absl::string_view bytes, DecodedSketch& sketch) {
+  CodedInputStream input(reinterpret_cast<const uint8_t*>(bytes.data()),
+                         bytes.size());
+  while (uint32_t tag = input.ReadTag()) {
+    uint32_t length;
+    if (!input.ReadVarint32(&length)) return false;
+    if (tag == 0x0A) {
+      if (!input.ReadString(&sketch.config, length)) return false;
+    } else if (tag == 0x12) {
+      CodedInputStream::Limit limit = input.PushLimit(length);
+      sketch.registers.emplace_back();
+      if (!DecodeRegister(input, sketch.registers.back())) return false;
+      input.PopLimit(limit);
+    } else {
+      return false;
+    }
+  }
+  return input.ConsumedEntireMessage();
+}
+
+// Creates a sketch whose index is the "index" metadata and whose values are
+// a UNIQUE "unique" and a SUM "count" metadata value.
+std::unique_ptr<AnySketch> MakeSketch() {
+  return MakeOracleSketch(0, 1'000'000,
+                          {AggregatorType::kUnique, AggregatorType::kSum});
+}
+
+TEST(SketchProtoConversionTest, EmptySketchHasOnlyConfig) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+
+  ASSERT_OK_AND_ASSIGN(std::string bytes,
+                       SerializeSketchProto(*sketch, "config-bytes"));
+
+  DecodedSketch decoded;
+  ASSERT_TRUE(DecodeSketch(bytes, decoded));
+  EXPECT_EQ(decoded.config, "config-bytes");
+  EXPECT_THAT(decoded.registers, IsEmpty());
+}
+
+TEST(SketchProtoConversionTest, EncodesValuesWithTheirAggregators) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  ASSERT_THAT(sketch->Insert("a", {{"index", 0}, {"unique", 5}, {"count", 2}}),
+              IsOk());
+  ASSERT_THAT(
+      sketch->Insert("b", {{"index", 300}, {"unique", 5}, {"count", 2}}),
+      IsOk());
+  ASSERT_THAT(
+      sketch->Insert("c", {{"index", 300}, {"unique", 6}, {"count", 3}}),
+      IsOk());
+
+  ASSERT_OK_AND_ASSIGN(std::string bytes, SerializeSketchProto(*sketch, ""));
+
+  DecodedSketch decoded;
+  ASSERT_TRUE(DecodeSketch(bytes, decoded));
+  // UNIQUE values are shifted by one, so a destroyed one is stored as 0.
+  EXPECT_THAT(decoded.registers,
+              UnorderedElementsAre(Pair(0, ElementsAre(6, 2)),
+                                   Pair(300, ElementsAre(0, 5))));
+}
+
+TEST(SketchProtoConversionTest, RegistersWithoutValues) {
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetOracleDistribution("index", 0, 100));
+  AnySketch sketch(std::move(indexes), {});
+  ASSERT_THAT(sketch.Insert("a", {{"index", 7}}), IsOk());
+
+  ASSERT_OK_AND_ASSIGN(std::string bytes, SerializeSketchProto(sketch, ""));
+
+  DecodedSketch decoded;
+  ASSERT_TRUE(DecodeSketch(bytes, decoded));
+  EXPECT_THAT(decoded.registers, ElementsAre(Pair(7, IsEmpty())));
+}
+
+TEST(SketchProtoConversionTest, DeltaHasOnlyChangedRegisters) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  ASSERT_THAT(sketch->Insert("a", {{"index", 1}, {"unique", 5}, {"count", 2}}),
+              IsOk());
+  ASSERT_THAT(sketch->Insert("b", {{"index", 2}, {"unique", 5}, {"count", 2}}),
+              IsOk());
+  sketch->Checkpoint();
+  ASSERT_THAT(sketch->Insert("c", {{"index", 2}, {"unique", 5}, {"count", 1}}),
+              IsOk());
+
+  ASSERT_OK_AND_ASSIGN(
+      std::string bytes,
+      SerializeSketchProto(*sketch, sketch->ChangedRegisters(), "config"));
+
+  DecodedSketch decoded;
+  ASSERT_TRUE(DecodeSketch(bytes, decoded));
+  EXPECT_EQ(decoded.config, "config");
+  EXPECT_THAT(decoded.registers, ElementsAre(Pair(2, ElementsAre(6, 3))));
+}
+
+TEST(SketchProtoConversionTest, DeltaWithWrongValueCountFails) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  const std::vector<int64_t> values = {1};
+
+  EXPECT_THAT(SerializeSketchProto(*sketch, {{.index = 1, .values = values}},
+                                   "")
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has 1 values but the sketch has 2")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
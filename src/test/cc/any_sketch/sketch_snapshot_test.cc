@@ -0,0 +1,184 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_snapshot.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+// A sketch whose index is the "index" metadata and whose values are a UNIQUE
+// "unique" and `sum_count` SUMs of "count" metadata values.
+std::unique_ptr<AnySketch> MakeSketch(int sum_count = 1) {
+  std::vector<AggregatorType> value_aggregators(sum_count + 1,
+                                                AggregatorType::kSum);
+  value_aggregators[0] = AggregatorType::kUnique;
+  return MakeOracleSketch(0, 1'000'000, value_aggregators);
+}
+
+void Fill(AnySketch& sketch, int first, int count) {
+  for (int i = first; i < first + count; ++i) {
+    // Every tenth register gets conflicting UNIQUE values.
+    const int unique = i % 10 == 0 ? i % 97 : 1;
+    ASSERT_THAT(sketch.Insert(absl::StrCat(i), {{"index", i % 5000},
+                                                {"unique", unique},
+                                                {"count", i % 7}}),
+                IsOk());
+  }
+}
+
+std::vector<std::pair<uint64_t, std::vector<int64_t>>> GetRegisters(
+    const AnySketch& sketch) {
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> registers;
+  sketch.ForEachSorted([&registers](const AnySketch::Register& reg) {
+    registers.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  });
+  return registers;
+}
+
+std::string SnapshotPath(absl::string_view name) {
+  return absl::StrCat(::testing::TempDir(), "/sketch_snapshot_test_", name);
+}
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+void WriteFile(const std::string& path, const std::string& contents) {
+  std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+}
+
+TEST(SketchSnapshotTest, RestoresTheRegisters) {
+  // With many values, the registers keep their values out of line.
+  for (int sum_count : {0, 1, 16}) {
+    std::unique_ptr<AnySketch> sketch = MakeSketch(sum_count);
+    Fill(*sketch, 0, 20'000);
+    const std::string path = SnapshotPath("restore");
+
+    SketchSnapshot snapshot = SketchSnapshot::Capture(*sketch);
+    EXPECT_EQ(snapshot.register_count(), 5000);
+    ASSERT_THAT(snapshot.WriteToFile(path), IsOk());
+
+    std::unique_ptr<AnySketch> restored = MakeSketch(sum_count);
+    ASSERT_THAT(RestoreSketchSnapshot(path, *restored), IsOk());
+    EXPECT_EQ(GetRegisters(*restored), GetRegisters(*sketch))
+        << sum_count << " SUM values";
+  }
+}
+
+TEST(SketchSnapshotTest, RestoresAnEmptySketch) {
+  const std::string path = SnapshotPath("empty");
+  ASSERT_THAT(SketchSnapshot::Capture(*MakeSketch()).WriteToFile(path),
+              IsOk());
+
+  std::unique_ptr<AnySketch> restored = MakeSketch();
+  ASSERT_THAT(RestoreSketchSnapshot(path, *restored), IsOk());
+  EXPECT_THAT(GetRegisters(*restored), IsEmpty());
+}
+
+TEST(SketchSnapshotTest, WritesWhileTheSketchKeepsChanging) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  Fill(*sketch, 0, 2000);
+  const auto expected = GetRegisters(*sketch);
+  const std::string path = SnapshotPath("background");
+
+  SketchSnapshot snapshot = SketchSnapshot::Capture(*sketch);
+  absl::Status write_status;
+  std::thread writer([&]() { write_status = snapshot.WriteToFile(path); });
+  Fill(*sketch, 2000, 10'000);
+  writer.join();
+  ASSERT_THAT(write_status, IsOk());
+
+  std::unique_ptr<AnySketch> restored = MakeSketch();
+  ASSERT_THAT(RestoreSketchSnapshot(path, *restored), IsOk());
+  EXPECT_EQ(GetRegisters(*restored), expected);
+}
+
+TEST(SketchSnapshotTest, RestoreFailsOnCorruptedFiles) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  Fill(*sketch, 0, 100);
+  const std::string path = SnapshotPath("corrupted");
+  ASSERT_THAT(SketchSnapshot::Capture(*sketch).WriteToFile(path), IsOk());
+  const std::string contents = ReadFile(path);
+
+  std::string flipped = contents;
+  flipped[flipped.size() / 2] ^= 1;
+  WriteFile(path, flipped);
+  EXPECT_THAT(RestoreSketchSnapshot(path, *MakeSketch()),
+              StatusIs(absl::StatusCode::kDataLoss, HasSubstr("checksum")));
+
+  WriteFile(path, contents.substr(0, contents.size() - 8));
+  EXPECT_THAT(RestoreSketchSnapshot(path, *MakeSketch()),
+              StatusIs(absl::StatusCode::kDataLoss));
+
+  WriteFile(path, contents.substr(0, 10));
+  EXPECT_THAT(RestoreSketchSnapshot(path, *MakeSketch()),
+              StatusIs(absl::StatusCode::kDataLoss, HasSubstr("truncated")));
+
+  WriteFile(path, std::string(contents.size(), 'x'));
+  EXPECT_THAT(RestoreSketchSnapshot(path, *MakeSketch()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a sketch snapshot")));
+}
+
+TEST(SketchSnapshotTest, RestoreFailsOnIncompatibleSketches) {
+  std::unique_ptr<AnySketch> sketch = MakeSketch();
+  Fill(*sketch, 0, 100);
+  const std::string path = SnapshotPath("incompatible");
+  ASSERT_THAT(SketchSnapshot::Capture(*sketch).WriteToFile(path), IsOk());
+
+  EXPECT_THAT(RestoreSketchSnapshot(path, *MakeSketch(2)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("has 2 values but the sketch has 3")));
+  EXPECT_THAT(RestoreSketchSnapshot(path, *sketch),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+
+  // The same number of values, with their aggregators swapped.
+  std::unique_ptr<AnySketch> swapped = MakeOracleSketch(
+      0, 1'000'000, {AggregatorType::kSum, AggregatorType::kUnique});
+  EXPECT_THAT(RestoreSketchSnapshot(path, *swapped),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("different aggregator")));
+  EXPECT_EQ(swapped->register_count(), 0);
+}
+
+TEST(SketchSnapshotTest, RestoreFailsOnMissingFile) {
+  EXPECT_THAT(RestoreSketchSnapshot(SnapshotPath("missing"), *MakeSketch()),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
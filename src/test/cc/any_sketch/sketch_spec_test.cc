@@ -0,0 +1,176 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/sketch_spec.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::SizeIs;
+
+absl::StatusOr<SketchSpec> SpecFromText(absl::string_view text_config) {
+  ASSIGN_OR_RETURN(std::string serialized_config,
+                   SerializeSketchConfigText(text_config));
+  return SketchSpecFromConfig(serialized_config);
+}
+
+TEST(SketchSpecTest, SketchSpecFromConfigConvertsIndexesAndValues) {
+  ASSERT_OK_AND_ASSIGN(SketchSpec spec, SpecFromText(R"pb(
+    indexes {
+      name: "index"
+      distribution { exponential { rate: 12 num_values: 1000 } }
+    }
+    values {
+      name: "sampling_indicator"
+      aggregator: UNIQUE
+      distribution { uniform { num_values: 10000000 } }
+    }
+    values {
+      name: "frequency"
+      aggregator: SUM
+      distribution { oracle { key: "frequency" } }
+    }
+  )pb"));
+
+  ASSERT_THAT(spec.indexes, SizeIs(1));
+  EXPECT_EQ(spec.indexes[0].type, DistributionSpec::Type::kExponential);
+  EXPECT_EQ(spec.indexes[0].rate, 12);
+  EXPECT_EQ(spec.indexes[0].num_values, 1000);
+  ASSERT_THAT(spec.values, SizeIs(2));
+  EXPECT_EQ(spec.values[0].name, "sampling_indicator");
+  EXPECT_EQ(spec.values[0].aggregator_type, AggregatorType::kUnique);
+  EXPECT_EQ(spec.values[0].distribution.type,
+            DistributionSpec::Type::kUniform);
+  EXPECT_EQ(spec.values[0].distribution.num_values, 10'000'000);
+  EXPECT_EQ(spec.values[1].aggregator_type, AggregatorType::kSum);
+  EXPECT_EQ(spec.values[1].distribution.type, DistributionSpec::Type::kOracle);
+  EXPECT_EQ(spec.values[1].distribution.feature_name, "frequency");
+}
+
+TEST(SketchSpecTest, SketchSpecFromConfigRejectsUnsupportedDistributions) {
+  EXPECT_THAT(SpecFromText(R"pb(
+                indexes { distribution { constant { value: 1 } } }
+              )pb")
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not supported")));
+  EXPECT_THAT(SpecFromText(R"pb(
+                indexes {
+                  distribution { uniform { num_values: 10 salt: "salt" } }
+                }
+              )pb")
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Salted uniform")));
+  EXPECT_THAT(SpecFromText(R"pb(
+                indexes {
+                  distribution {
+                    geometric { success_probability: 0.25 num_values: 10 }
+                  }
+                }
+              )pb")
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("success probability of 0.5")));
+  EXPECT_THAT(SpecFromText(R"pb(
+                values { distribution { oracle { key: "frequency" } } }
+              )pb")
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("aggregator")));
+}
+
+TEST(SketchSpecTest, SerializeSketchConfigTextFailsOnInvalidText) {
+  EXPECT_THAT(SerializeSketchConfigText("indexes {").status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("text proto")));
+}
+
+TEST(SketchSpecTest, CreateAnySketchBuildsSketchOfSpec) {
+  SketchSpec spec;
+  spec.indexes.push_back({.type = DistributionSpec::Type::kUniform,
+                          .num_values = 10});
+  spec.values.push_back(
+      {.name = "frequency",
+       .aggregator_type = AggregatorType::kSum,
+       .distribution = {.type = DistributionSpec::Type::kOracle,
+                        .feature_name = "frequency"}});
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> sketch,
+                       CreateAnySketch(spec));
+
+  ASSERT_THAT(sketch->Insert("item", {{"frequency", 2}}), IsOk());
+  ASSERT_THAT(sketch->Insert("item", {{"frequency", 3}}), IsOk());
+
+  std::vector<AnySketch::Register> registers = sketch->SortedRegisters();
+  ASSERT_THAT(registers, SizeIs(1));
+  EXPECT_LT(registers[0].index, 10);
+  EXPECT_THAT(registers[0].values, ElementsAre(5));
+}
+
+TEST(SketchSpecTest, UniformWithoutNumValuesSpansTheInt64Range) {
+  ASSERT_OK_AND_ASSIGN(SketchSpec spec, SpecFromText(R"pb(
+    indexes { distribution { uniform {} } }
+  )pb"));
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> sketch,
+                       CreateAnySketch(spec));
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_THAT(sketch->Insert(absl::StrCat("item", i), {}), IsOk());
+  }
+
+  // All 100 indexes are below 2^40 with a probability of 2^-2300.
+  std::vector<AnySketch::Register> registers = sketch->SortedRegisters();
+  ASSERT_THAT(registers, SizeIs(100));
+  EXPECT_GE(registers.back().index, uint64_t{1} << 40);
+}
+
+TEST(SketchSpecTest, CreateAnySketchRejectsInvalidDistributions) {
+  SketchSpec negative_uniform;
+  negative_uniform.indexes.push_back(
+      {.type = DistributionSpec::Type::kUniform, .num_values = -1});
+  EXPECT_THAT(CreateAnySketch(negative_uniform).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("positive number of values")));
+
+  SketchSpec zero_rate;
+  zero_rate.indexes.push_back(
+      {.type = DistributionSpec::Type::kExponential, .num_values = 10});
+  EXPECT_THAT(CreateAnySketch(zero_rate).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("positive rate")));
+
+  SketchSpec unnamed_oracle;
+  unnamed_oracle.indexes.push_back({.type = DistributionSpec::Type::kOracle});
+  EXPECT_THAT(CreateAnySketch(unnamed_oracle).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("feature name")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,199 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/spilling_sketch.h"
+
+#include <stdlib.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/sketch_proto_conversion.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::Gt;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Lt;
+
+using Registers = std::vector<std::pair<uint64_t, std::vector<int64_t>>>;
+
+constexpr int kIndexCount = 2000;
+
+// A sketch whose index is the "index" metadata, with a UNIQUE value of the
+// "unique" metadata and a SUM of the "count" metadata.
+std::unique_ptr<AnySketch> MakeSketch() {
+  return MakeOracleSketch(0, kIndexCount - 1,
+                          {AggregatorType::kUnique, AggregatorType::kSum});
+}
+
+ItemMetadata MetadataOf(int i) {
+  // Indexes recur across spills, and every 13th item destroys the UNIQUE
+  // value of its register.
+  return {{"index", (i * 7919) % kIndexCount},
+          {"unique", i % 13 == 0 ? i % 100 : 1},
+          {"count", i % 5}};
+}
+
+// A directory of its own for the runs of each test.
+std::string MakeSpillDirectory() {
+  std::string directory =
+      absl::StrCat(::testing::TempDir(), "/spilling_sketch_test_XXXXXX");
+  EXPECT_NE(mkdtemp(directory.data()), nullptr);
+  return directory;
+}
+
+int FileCount(const std::string& directory) {
+  return std::distance(std::filesystem::directory_iterator(directory),
+                       std::filesystem::directory_iterator());
+}
+
+Registers ToPairs(absl::Span<const AnySketch::Register> registers) {
+  Registers pairs;
+  for (const AnySketch::Register& reg : registers) {
+    pairs.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  }
+  return pairs;
+}
+
+Registers GetRegisters(const SpillingSketch& sketch) {
+  Registers registers;
+  auto append = [&registers](const AnySketch::Register& reg) {
+    registers.push_back(ToPairs({reg}).front());
+  };
+  EXPECT_THAT(sketch.ForEachSorted(append), IsOk());
+  return registers;
+}
+
+class SpillingSketchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    options_.memory_budget_bytes = 4096;
+    options_.spill_directory = MakeSpillDirectory();
+  }
+
+  SpillingSketchOptions options_;
+};
+
+TEST_F(SpillingSketchTest, MatchesAnInMemorySketch) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                       SpillingSketch::Create(options_, MakeSketch));
+  std::unique_ptr<AnySketch> expected = MakeSketch();
+  for (int i = 0; i < 10'000; ++i) {
+    ASSERT_THAT(sketch->Insert(absl::StrCat(i), MetadataOf(i)), IsOk());
+    ASSERT_THAT(expected->Insert(absl::StrCat(i), MetadataOf(i)), IsOk());
+  }
+
+  EXPECT_THAT(sketch->run_count(), Gt(1));
+  EXPECT_THAT(sketch->in_memory_register_count(),
+              Lt(sketch->spill_register_count()));
+  EXPECT_EQ(GetRegisters(*sketch), ToPairs(expected->SortedRegisters()));
+}
+
+TEST_F(SpillingSketchTest, AggregatesRegistersAcrossRuns) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                       SpillingSketch::Create(options_, MakeSketch));
+  ASSERT_THAT(sketch->AggregateIntoRegister(5, {3, 1}), IsOk());
+  ASSERT_THAT(sketch->Spill(), IsOk());
+  ASSERT_THAT(sketch->AggregateIntoRegister(5, {3, 2}), IsOk());
+  ASSERT_THAT(sketch->AggregateIntoRegister(9, {4, 1}), IsOk());
+  ASSERT_THAT(sketch->Spill(), IsOk());
+  ASSERT_THAT(sketch->AggregateIntoRegister(9, {6, 1}), IsOk());
+  // Spilling an empty table does not add a run.
+  ASSERT_THAT(sketch->Spill(), IsOk());
+  ASSERT_THAT(sketch->Spill(), IsOk());
+
+  EXPECT_EQ(sketch->run_count(), 3);
+  const Registers expected = {{5, {3, 3}},
+                              {9, {kUniqueAggregatorDestroyedValue, 2}}};
+  EXPECT_EQ(GetRegisters(*sketch), expected);
+}
+
+TEST_F(SpillingSketchTest, SerializesLikeAnInMemorySketch) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                       SpillingSketch::Create(options_, MakeSketch));
+  std::unique_ptr<AnySketch> expected = MakeSketch();
+  for (int i = 0; i < 3000; ++i) {
+    ASSERT_THAT(sketch->Insert(absl::StrCat(i), MetadataOf(i)), IsOk());
+    ASSERT_THAT(expected->Insert(absl::StrCat(i), MetadataOf(i)), IsOk());
+  }
+
+  // Both are in increasing index order.
+  ASSERT_OK_AND_ASSIGN(
+      std::string expected_serialized,
+      SerializeSketchProto(*expected, expected->SortedRegisters(), "config"));
+  EXPECT_THAT(sketch->SerializeSketchProto("config"),
+              IsOkAndHolds(expected_serialized));
+}
+
+TEST_F(SpillingSketchTest, EmptySketchHasNoRegisters) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                       SpillingSketch::Create(options_, MakeSketch));
+  EXPECT_THAT(GetRegisters(*sketch), IsEmpty());
+  EXPECT_EQ(sketch->run_count(), 0);
+}
+
+TEST_F(SpillingSketchTest, DeletesRunsWithTheSketch) {
+  {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                         SpillingSketch::Create(options_, MakeSketch));
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_THAT(sketch->Insert(absl::StrCat(i), MetadataOf(i)), IsOk());
+    }
+    EXPECT_EQ(FileCount(options_.spill_directory), sketch->run_count());
+    EXPECT_THAT(sketch->run_count(), Gt(0));
+  }
+  EXPECT_EQ(FileCount(options_.spill_directory), 0);
+}
+
+TEST_F(SpillingSketchTest, SpillFailsWithoutADirectory) {
+  options_.spill_directory = absl::StrCat(options_.spill_directory, "/missing");
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<SpillingSketch> sketch,
+                       SpillingSketch::Create(options_, MakeSketch));
+  ASSERT_THAT(sketch->AggregateIntoRegister(5, {3, 1}), IsOk());
+
+  EXPECT_THAT(sketch->Spill(), StatusIs(absl::StatusCode::kUnavailable));
+  EXPECT_EQ(sketch->in_memory_register_count(), 1);
+}
+
+TEST_F(SpillingSketchTest, CreateFailsWithInvalidArguments) {
+  EXPECT_THAT(SpillingSketch::Create(options_, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  options_.memory_budget_bytes = 16;
+  EXPECT_THAT(SpillingSketch::Create(options_, MakeSketch),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("cannot hold a register")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,47 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "any_sketch/value_function.h"
+
+namespace wfa::any_sketch {
+
+std::unique_ptr<AnySketch> MakeOracleSketch(
+    int64_t min_index, int64_t max_index,
+    absl::Span<const AggregatorType> value_aggregators) {
+  std::vector<std::unique_ptr<Distribution>> indexes;
+  indexes.push_back(GetOracleDistribution("index", min_index, max_index));
+  std::vector<ValueFunction> values;
+  for (AggregatorType aggregator_type : value_aggregators) {
+    const bool unique = aggregator_type == AggregatorType::kUnique;
+    values.push_back(
+        {.name = unique ? "Unique" : "Count",
+         .aggregator_type = aggregator_type,
+         .distribution =
+             GetOracleDistribution(unique ? "unique" : "count", 0, 100)});
+  }
+  return std::make_unique<AnySketch>(std::move(indexes), std::move(values));
+}
+
+}  // namespace wfa::any_sketch
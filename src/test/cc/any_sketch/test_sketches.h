@@ -0,0 +1,37 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TEST_CC_ANY_SKETCH_TEST_SKETCHES_H_
+#define SRC_TEST_CC_ANY_SKETCH_TEST_SKETCHES_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/types/span.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+
+namespace wfa::any_sketch {
+
+// Returns a sketch whose index is the "index" metadata, in [min_index,
+// max_index], with a value for each of `value_aggregators`: a SUM "Count" of
+// the "count" metadata or a UNIQUE "Unique" of the "unique" metadata, both in
+// [0, 100].
+std::unique_ptr<AnySketch> MakeOracleSketch(
+    int64_t min_index, int64_t max_index,
+    absl::Span<const AggregatorType> value_aggregators);
+
+}  // namespace wfa::any_sketch
+
+#endif  // SRC_TEST_CC_ANY_SKETCH_TEST_SKETCHES_H_
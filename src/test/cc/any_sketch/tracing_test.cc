@@ -0,0 +1,118 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/tracing.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/time/time.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::Pair;
+using ::testing::SizeIs;
+using ::testing::StartsWith;
+
+std::string ReadFile(const std::string& path) {
+  std::ifstream in(path);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+TEST(TracingTest, TracerWithoutCallbackOrFileIsDisabled) {
+  Tracer tracer;
+  EXPECT_FALSE(tracer.enabled());
+  { ScopedTraceSpan span(tracer, "stage"); }
+  EXPECT_THAT(tracer.Flush(), IsOk());
+}
+
+TEST(TracingTest, CallbackReceivesSpansWithArgs) {
+  std::vector<TraceSpan> spans;
+  SetTraceSpanCallback([&spans](const TraceSpan& span) {
+    spans.push_back(span);
+  });
+  Tracer tracer;
+  SetTraceSpanCallback(nullptr);
+
+  ASSERT_TRUE(tracer.enabled());
+  {
+    ScopedTraceSpan span(tracer, "stage");
+    span.AddArg("bytes", 42);
+    span.AddArg("count", 3);
+  }
+
+  ASSERT_THAT(spans, SizeIs(1));
+  EXPECT_EQ(spans[0].name, "stage");
+  EXPECT_GE(spans[0].duration, absl::ZeroDuration());
+  EXPECT_THAT(spans[0].args, ElementsAre(Pair("bytes", 42), Pair("count", 3)));
+  EXPECT_FALSE(Tracer().enabled());
+}
+
+TEST(TracingTest, FormatChromeTraceEventsWritesCompleteEvents) {
+  TraceSpan span = {.name = "a \"quoted\" stage",
+                    .start = absl::FromUnixMicros(1'000),
+                    .duration = absl::Microseconds(250),
+                    .args = {{"bytes", 42}}};
+
+  std::string events = FormatChromeTraceEvents({span});
+
+  EXPECT_THAT(events, StartsWith("{\"name\":\"a \\\"quoted\\\" stage\","
+                                 "\"ph\":\"X\""));
+  EXPECT_THAT(events, HasSubstr("\"ts\":1000,\"dur\":250,"
+                                "\"args\":{\"bytes\":42}},\n"));
+}
+
+TEST(TracingTest, FlushAppendsToChromeTraceFile) {
+  const std::string path =
+      absl::StrCat(::testing::TempDir(), "/tracing_test_trace.json");
+  std::remove(path.c_str());
+
+  for (const char* name : {"first", "second"}) {
+    Tracer tracer(path);
+    ASSERT_TRUE(tracer.enabled());
+    { ScopedTraceSpan span(tracer, name); }
+    ASSERT_THAT(tracer.Flush(), IsOk());
+  }
+
+  std::vector<std::string> lines =
+      absl::StrSplit(ReadFile(path), '\n', absl::SkipEmpty());
+  ASSERT_THAT(lines, SizeIs(3));
+  EXPECT_EQ(lines[0], "[");
+  EXPECT_THAT(lines[1], HasSubstr("\"name\":\"first\""));
+  EXPECT_THAT(lines[2], HasSubstr("\"name\":\"second\""));
+  std::remove(path.c_str());
+}
+
+TEST(TracingTest, AppendChromeTraceFailsForUnwritablePath) {
+  EXPECT_THAT(AppendChromeTrace("/nonexistent-directory/trace.json",
+                                {TraceSpan{.name = "stage"}}),
+              StatusIs(absl::StatusCode::kUnavailable, HasSubstr("trace")));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,67 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/util.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::Each;
+
+TEST(UtilTest, StoresLittleEndianIntegers) {
+  std::string data(13, '\0');
+  Store32(0x04030201, data.data() + 1);
+  Store64(0x0c0b0a0908070605, data.data() + 5);
+
+  EXPECT_EQ(data, std::string("\0\1\2\3\4\5\6\7\10\11\12\13\14", 13));
+  EXPECT_EQ(Load32(data.data() + 1), 0x04030201u);
+  EXPECT_EQ(Load64(data.data() + 5), 0x0c0b0a0908070605u);
+}
+
+TEST(UtilTest, ForEachSliceCoversTheRangeOnce) {
+  for (int thread_count : {1, 3, 16}) {
+    // The slices are disjoint, so each element has a single writer.
+    std::vector<int> visits(10);
+    ASSERT_THAT(ForEachSlice(thread_count, visits.size(),
+                             [&](int64_t begin, int64_t end) {
+                               for (int64_t i = begin; i < end; ++i) {
+                                 ++visits[i];
+                               }
+                               return absl::OkStatus();
+                             }),
+                IsOk());
+    EXPECT_THAT(visits, Each(1)) << thread_count << " threads";
+  }
+}
+
+TEST(UtilTest, ForEachSliceReturnsTheFirstError) {
+  EXPECT_THAT(ForEachSlice(4, 8,
+                           [](int64_t begin, int64_t end) {
+                             return begin >= 4 ? absl::DataLossError("late")
+                                               : absl::OkStatus();
+                           }),
+              StatusIs(absl::StatusCode::kDataLoss, "late"));
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
@@ -0,0 +1,142 @@
+// Copyright 2026 The Cross-Media Measurement Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "any_sketch/windowed_sketch.h"
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "any_sketch/aggregators.h"
+#include "any_sketch/any_sketch.h"
+#include "any_sketch/distributions.h"
+#include "common_cpp/testing/status_macros.h"
+#include "common_cpp/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "src/test/cc/any_sketch/test_sketches.h"
+
+namespace wfa::any_sketch {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+using ::testing::Le;
+using ::testing::Pair;
+
+// A sketch whose index is the "index" metadata and whose values are a SUM of
+// "count" and a UNIQUE "unique" metadata value.
+std::unique_ptr<AnySketch> MakeSketch() {
+  return MakeOracleSketch(0, 1000,
+                          {AggregatorType::kSum, AggregatorType::kUnique});
+}
+
+std::vector<std::pair<uint64_t, std::vector<int64_t>>> GetRegisters(
+    const AnySketch& sketch) {
+  std::vector<std::pair<uint64_t, std::vector<int64_t>>> registers;
+  sketch.ForEachSorted([&registers](const AnySketch::Register& reg) {
+    registers.emplace_back(
+        reg.index, std::vector<int64_t>(reg.values.begin(), reg.values.end()));
+  });
+  return registers;
+}
+
+TEST(WindowedSketchTest, CreateFailsWithoutPositiveWindowSize) {
+  EXPECT_THAT(WindowedSketch::Create(0, MakeSketch).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("should be positive")));
+  EXPECT_THAT(WindowedSketch::Create(1, nullptr).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(WindowedSketchTest, OldestBucketLeavesTheWindow) {
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<WindowedSketch> window,
+                       WindowedSketch::Create(2, MakeSketch));
+
+  ASSERT_THAT(window->Insert("a", {{"index", 1}, {"count", 1}, {"unique", 5}}),
+              IsOk());
+  ASSERT_THAT(window->Advance(), IsOk());
+  ASSERT_THAT(window->Insert("b", {{"index", 1}, {"count", 2}, {"unique", 6}}),
+              IsOk());
+  ASSERT_THAT(window->Insert("c", {{"index", 2}, {"count", 3}, {"unique", 7}}),
+              IsOk());
+  EXPECT_EQ(window->bucket_count(), 2);
+
+  // Both buckets: register 1 has conflicting UNIQUE values.
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> sketch, window->Query());
+  EXPECT_THAT(
+      GetRegisters(*sketch),
+      ElementsAre(Pair(1, ElementsAre(3, kUniqueAggregatorDestroyedValue)),
+                  Pair(2, ElementsAre(3, 7))));
+
+  // The first bucket leaves the window.
+  ASSERT_THAT(window->Advance(), IsOk());
+  EXPECT_EQ(window->bucket_count(), 2);
+  ASSERT_OK_AND_ASSIGN(sketch, window->Query());
+  EXPECT_THAT(GetRegisters(*sketch),
+              ElementsAre(Pair(1, ElementsAre(2, 6)),
+                          Pair(2, ElementsAre(3, 7))));
+
+  ASSERT_THAT(window->Advance(), IsOk());
+  ASSERT_OK_AND_ASSIGN(sketch, window->Query());
+  EXPECT_THAT(GetRegisters(*sketch), IsEmpty());
+}
+
+TEST(WindowedSketchTest, MatchesMergingTheBucketsOfTheWindow) {
+  for (int window_size : {1, 2, 3, 7}) {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<WindowedSketch> window,
+                         WindowedSketch::Create(window_size, MakeSketch));
+    std::deque<std::unique_ptr<AnySketch>> buckets;
+    buckets.push_back(MakeSketch());
+
+    uint64_t random = 1;
+    constexpr int kBucketCount = 30;
+    for (int day = 0; day < kBucketCount; ++day) {
+      for (int i = 0; i < 50; ++i) {
+        random = random * 6364136223846793005 + 1442695040888963407;
+        ItemMetadata metadata = {
+            {"index", static_cast<int64_t>((random >> 33) % 40)},
+            {"count", static_cast<int64_t>((random >> 40) % 5)},
+            // Mostly agreeing UNIQUE values, so that only some are destroyed.
+            {"unique", (random >> 50) % 16 == 0 ? 2 : 1}};
+        const std::string item = absl::StrCat(day, "-", i);
+        ASSERT_THAT(window->Insert(item, metadata), IsOk());
+        ASSERT_THAT(buckets.back()->Insert(item, metadata), IsOk());
+      }
+
+      ASSERT_OK_AND_ASSIGN(std::unique_ptr<AnySketch> sketch, window->Query());
+      std::unique_ptr<AnySketch> expected = MakeSketch();
+      for (const std::unique_ptr<AnySketch>& bucket : buckets) {
+        ASSERT_THAT(expected->Merge(*bucket), IsOk());
+      }
+      EXPECT_EQ(GetRegisters(*sketch), GetRegisters(*expected))
+          << "window size " << window_size << ", day " << day;
+
+      ASSERT_THAT(window->Advance(), IsOk());
+      buckets.push_back(MakeSketch());
+      if (static_cast<int>(buckets.size()) > window_size) {
+        buckets.pop_front();
+      }
+    }
+    EXPECT_THAT(window->advance_merge_count(), Le(2 * kBucketCount));
+  }
+}
+
+}  // namespace
+}  // namespace wfa::any_sketch
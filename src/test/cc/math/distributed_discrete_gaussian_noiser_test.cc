@@ -281,5 +281,23 @@ TEST(DiscreteGaussianNoiser, GetNoiseOptionReturnsConstReference) {
   EXPECT_EQ(const_noise_options.truncate_threshold, options.truncate_threshold);
 }
 
+TEST(DiscreteGaussianNoiser, CountsRejectionIterations) {
+  DistributedDiscreteGaussianNoiser distributed_discrete_gaussian_noiser(
+      DistributedDiscreteGaussianNoiseComponentOptions{
+          kContributorCount, kSigmaDistributed, kOffset, kOffset});
+  EXPECT_EQ(distributed_discrete_gaussian_noiser.rejection_iteration_count(),
+            0);
+
+  int num_samples = 100;
+  for (int i = 0; i < num_samples; ++i) {
+    ASSERT_THAT(distributed_discrete_gaussian_noiser.GenerateNoiseComponent(),
+                IsOk());
+  }
+
+  // Every sample takes at least one iteration.
+  EXPECT_GE(distributed_discrete_gaussian_noiser.rejection_iteration_count(),
+            num_samples);
+}
+
 }  // namespace
 }  // namespace wfa::math